@@ -3,6 +3,7 @@
 //Core
 	#include "NAudio/NAudioCore.h"
 	#include "NAudio/NAudioFrames.h"
+	#include "NAudio/NAudioSIMD.h"
 	#include "NAudio/SampleTable.h"
 	#include "NAudio/FixedValue.h"
 	#include "NAudio/Arithmetic.h"
@@ -15,6 +16,7 @@
 	#include "NAudio/RampedValue.h"
 	#include "NAudio/Synth.h"
 	#include "NAudio/Mixer.h"
+	#include "NAudio/PolySynth.h"
 
 //Generators
 	//Oscillators
@@ -25,19 +27,24 @@
 		#include "NAudio/TriangleWave.h"	//Aliasing
 		#include "NAudio/SquareWave.h"		//Aliasing
 		#include "NAudio/RectWave.h"		//Aliasing
+		#include "NAudio/MipmapWaves.h"
 
 		#include "NAudio/Noise.h"
 
 	//Effects
 		#include "NAudio/CombFilter.h"
 		#include "NAudio/Filters.h"
+		#include "NAudio/StateVariableFilter.h"
 		#include "NAudio/StereoDelay.h"
 		#include "NAudio/BasicDelay.h"
 		#include "NAudio/Reverb.h"
+		#include "NAudio/ConvolutionReverb.h"
+		#include "NAudio/FDNReverb.h"
 		#include "NAudio/FilterUtils.h"
 		#include "NAudio/DelayUtils.h"
 		#include "NAudio/Reverb.h"
 		#include "NAudio/BitCrusher.h"
+		#include "NAudio/Oversampled.h"
 
 	//Utilities
 		#include "NAudio/ADSR.h"
@@ -66,4 +73,7 @@
 	#include "NAudio/ControlCallback.h"			//C++11 only
 
 //Util
-	#include "NAudio/AudioFileUtils.h"
\ No newline at end of file
+	#include "NAudio/AudioFileUtils.h"
+	#include "NAudio/FFT.h"
+	#include "NAudio/RandomUtils.h"
+	#include "NAudio/OfflineRenderer.h"			//C++11 only
\ No newline at end of file
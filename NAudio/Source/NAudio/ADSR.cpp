@@ -17,7 +17,8 @@ namespace NAudio { namespace NAudio_DSP{
     increment(0),
     segCounter(0),
     segLength(0),
-    pole(0)
+    pole(0),
+    sampleRate(SampleRate())
   {
     mTrigger = ControlValue(0); // empty trigger by default
     isLegato = ControlValue(false);
@@ -50,8 +51,8 @@ namespace NAudio { namespace NAudio_DSP{
           lastValue = 0.f;
         }
         
-        segLength = attackTime * SampleRate();
-        pole = t60ToOnePoleCoef(attackTime);
+        segLength = attackTime * sampleRate;
+        pole = t60ToOnePoleCoef(attackTime, sampleRate);
         
         if (segLength == 0){
           lastValue = 1.0f;
@@ -67,8 +68,8 @@ namespace NAudio { namespace NAudio_DSP{
         
       case DECAY:{
         
-        segLength = decayTime * SampleRate();
-        pole = t60ToOnePoleCoef(decayTime);
+        segLength = decayTime * sampleRate;
+        pole = t60ToOnePoleCoef(decayTime, sampleRate);
         
         targetValue = sustainLevelVal;
         
@@ -93,8 +94,8 @@ namespace NAudio { namespace NAudio_DSP{
         
       case RELEASE:{
         
-        segLength = releaseTime * SampleRate();
-        pole = t60ToOnePoleCoef(releaseTime);
+        segLength = releaseTime * sampleRate;
+        pole = t60ToOnePoleCoef(releaseTime, sampleRate);
         
         targetValue = 0.f;
         
@@ -50,6 +50,9 @@ namespace NAudio {
       float increment;
       float pole;
       
+      // sample rate of the graph, picked up every block so segments are timed at the graph's rate
+      float sampleRate;
+      
       enum ADSRState {
         NEUTRAL,
         ATTACK,
@@ -63,6 +66,9 @@ namespace NAudio {
       
       void computeSynthesisBlock( const SynthesisContext_ &context );
       
+      // fill samplesRemaining frames of the envelope starting at fdata, switching segments as they end
+      void renderFrames(float * fdata, int samplesRemaining);
+      
     public:
       
       ADSR_();
@@ -83,6 +89,12 @@ namespace NAudio {
       //! Controls whether or not the envelope pauses on the SUSTAIN stage
       void setDoesSustain(ControlGenerator gen){doesSustain = gen;};
       
+      //! True once the envelope has finished releasing (or was never triggered), so its output is silent
+      bool isIdle() const {return state == NEUTRAL;}
+      
+      //! Envelope value at the end of the last computed block
+      float getLevel() const {return lastValue;}
+      
     };
     
     inline void ADSR_::computeSynthesisBlock(const SynthesisContext_ &context){
@@ -99,20 +111,47 @@ namespace NAudio {
       bIsExponential = (isExponential.tick(context).value) ? true : false;
       bDoesSustain = (doesSustain.tick(context).value) ? true : false;
       bIsLegato = (isLegato.tick(context).value) ? true : false;
+      sampleRate = context.sampleRate;
       
       float * fdata = &outputFrames_[0];
+      int samplesRemaining = outputFrames_.Frames();
+      
+      // an envelope that starts and ends the block idle, without a key down in between, output zeros all the way through
+      bool startsIdle = (state == NEUTRAL);
+      
+      // idle and sustaining envelopes hold lastValue until a trigger moves them to another segment
+      bool startsHolding = startsIdle || state == SUSTAIN;
+      
+      // a key down anywhere in the block, even one released again before the block ends
+      bool keyDown = false;
+      
+      // every trigger in the block, in frame order: run the current segment up to the frame the trigger falls on, so the new segment starts on that exact sample
+      int frame = 0;
       
-      if(triggerOutput.triggered){
+      for(unsigned int i = 0; i < triggerOutput.numEvents(); ++i){
         
-        if(triggerOutput.value != 0){
+        ControlEvent trigger = triggerOutput.event(i);
+        int triggerFrame = Clamp((int)trigger.offset, frame, samplesRemaining);
+        renderFrames(fdata + frame, triggerFrame - frame);
+        frame = triggerFrame;
+        
+        if(trigger.value != 0){
           switchState(ATTACK);
+          keyDown = true;
         }else if(bDoesSustain){
           switchState(RELEASE);
         }
         
       }
       
-      int samplesRemaining = kSynthesisBlockSize;
+      renderFrames(fdata + frame, samplesRemaining - frame);
+      
+      outputIsSilent_ = startsIdle && state == NEUTRAL && !keyDown;
+      outputIsConstant_ = startsHolding && !triggerOutput.triggered;
+      
+    }
+    
+    inline void ADSR_::renderFrames(float * fdata, int samplesRemaining){
       
       while (samplesRemaining > 0)
       {
@@ -226,11 +265,13 @@ namespace NAudio {
       NAUDIO_MAKE_CTRL_GEN_SETTERS(ADSR, exponential, setIsExponential);
       NAUDIO_MAKE_CTRL_GEN_SETTERS(ADSR, doesSustain, setDoesSustain);
       NAUDIO_MAKE_CTRL_GEN_SETTERS(ADSR, legato, setIsLegato);
+    
+      //! Only meaningful on the thread that renders the envelope
+      bool isIdle(){ return gen()->isIdle(); }
+      float getLevel(){ return gen()->getLevel(); }
 
   };
   
 }
 
-#endif
-
-
+#endif
\ No newline at end of file
@@ -3,7 +3,6 @@
 namespace NAudio {
 	namespace NAudio_DSP {
 		Adder_::Adder_() {
-			workSpace_.Resize(kSynthesisBlockSize, 1, 0);
 		}
 
 		void
@@ -15,14 +14,7 @@ namespace NAudio {
 			}
 		}
 
-		void
-		Adder_::setIsStereoOutput(bool stereo) {
-			Generator_::setIsStereoOutput(stereo);
-			workSpace_.Resize(kSynthesisBlockSize, stereo ? 2u : 1u, 0.0f);
-		}
-
 		Subtractor_::Subtractor_() {
-			workSpace_.Resize(kSynthesisBlockSize, 1u, 0.0f);
 		}
 
 		void
@@ -43,34 +35,20 @@ namespace NAudio {
 			right_ = arg;
 		}
 
-		void
-		Subtractor_::setIsStereoOutput(bool stereo) {
-			Generator_::setIsStereoOutput(stereo);
-			workSpace_.Resize(kSynthesisBlockSize, stereo ? 2u : 1u, 0.0f);
-		}
-
 		Multiplier_::Multiplier_() {
-			workSpace_.Resize(kSynthesisBlockSize, 1u, 0.0f);
 		}
 
 		void
 		Multiplier_::input(Generator generator) {
 			inputs_.push_back(generator);
+			inputViews_.push_back(NULL);
 
 			if(generator.isStereoOutput() && !isStereoOutput()) {
 				setIsStereoOutput(true);
 			}
 		}
 
-		void
-		Multiplier_::setIsStereoOutput(bool stereo) {
-			Generator_::setIsStereoOutput(stereo);
-
-			workSpace_.Resize(kSynthesisBlockSize, stereo ? 2u : 1u, 0.0f);
-		}
-
 		Divider_::Divider_() {
-			workSpace_.Resize(kSynthesisBlockSize, 1u, 0.0f);
 		}
 
 		void
@@ -90,10 +68,5 @@ namespace NAudio {
 
 			right_ = arg;
 		}
-
-		void Divider_::setIsStereoOutput(bool stereo) {
-			Generator_::setIsStereoOutput(stereo);
-			workSpace_.Resize(kSynthesisBlockSize, stereo ? 2u : 1u, 0.0f);
-		}
 	}
 }
\ No newline at end of file
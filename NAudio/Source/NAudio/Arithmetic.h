@@ -7,7 +7,6 @@ namespace NAudio {
 		class Adder_ : public Generator_ {
 		protected:
 			std::vector<Generator> inputs_;
-			NAudioFrames workSpace_;
 
 			void
 			computeSynthesisBlock(const SynthesisContext_& context);
@@ -18,9 +17,6 @@ namespace NAudio {
 			void
 			input(Generator generator);
 
-			void
-			setIsStereoOutput(bool stereo);
-
 			Generator
 			getInput(unsigned int index) {
 				return(inputs_[index]);
@@ -38,10 +34,30 @@ namespace NAudio {
 
 			memset(framesData, 0, sizeof(float) * outputFrames_.Size());
 
+			bool silent = true;
+			bool constant = true;
+
 			for(size_t j = 0; j < inputs_.size(); ++j) {
-				inputs_[j].tick(workSpace_, context);
-				outputFrames_ += workSpace_;				//Add each sample in frames to each sample in workspace.
+				const NAudioFrames& frames = inputs_[j].tickView(context);
+
+				//Add each input block straight from its own output, no copy. Silent inputs add nothing, constant ones add a single value.
+				if(inputs_[j].isSilent()) {
+					continue;
+				}
+
+				if(inputs_[j].isConstant()) {
+					outputFrames_ += frames(0, 0u);
+				}
+				else {
+					outputFrames_ += frames;
+					constant = false;
+				}
+
+				silent = false;
 			}
+
+			outputIsSilent_ = silent;
+			outputIsConstant_ = constant;
 		}
 	}
 
@@ -120,7 +136,6 @@ namespace NAudio {
 		protected:
 			Generator left_;
 			Generator right_;
-			NAudioFrames workSpace_;
 
 			void
 			computeSynthesisBlock(const SynthesisContext_& context);
@@ -133,17 +148,29 @@ namespace NAudio {
 
 			void
 			setRight(Generator arg);
-
-			void
-			setIsStereoOutput(bool stereo);
 		};
 
 		inline void
 		Subtractor_::computeSynthesisBlock(const SynthesisContext_& context) {
-			left_.tick(outputFrames_, context);
-			right_.tick(workSpace_, context);
+			const NAudioFrames& leftFrames = left_.tickView(context);
 
-			outputFrames_ -= workSpace_;
+			if(left_.isConstant()) {
+				outputFrames_.Fill(leftFrames(0, 0u));
+			}
+			else {
+				outputFrames_.Copy(leftFrames);
+			}
+
+			const NAudioFrames& rightFrames = right_.tickView(context);
+
+			if(right_.isConstant()) {
+				outputFrames_ -= rightFrames(0, 0u);
+			}
+			else {
+				outputFrames_ -= rightFrames;
+			}
+
+			outputIsConstant_ = (left_.isConstant() && right_.isConstant());
 		}
 	}
 
@@ -198,7 +225,9 @@ namespace NAudio {
 
 		protected:
 			std::vector<Generator> inputs_;
-			NAudioFrames workSpace_;
+
+			//Output of each input for the current block. Always the same size as inputs_.
+			std::vector<const NAudioFrames*> inputViews_;
 
 			void
 			computeSynthesisBlock(const SynthesisContext_& context);
@@ -209,9 +238,6 @@ namespace NAudio {
 			void
 			input(Generator generator);
 
-			void
-			setIsStereoOutput(bool stereo);
-
 			Generator
 			getInput(unsigned int index) {
 				return(inputs_[index]);
@@ -227,14 +253,40 @@ namespace NAudio {
 		Multiplier_::computeSynthesisBlock(const SynthesisContext_& context) {
 			memset(&outputFrames_[0], 0, sizeof(float) * outputFrames_.Size());
 
+			//A silent input makes the whole product silent, and the inputs after it don't need computing.
+			//Inputs are ticked last to first because envelopes usually come after the signal they scale (osc * env).
+			for(size_t i = inputs_.size(); i-- > 0;) {
+				inputViews_[i] = &inputs_[i].tickView(context);
+
+				if(inputs_[i].isSilent()) {
+					outputIsSilent_ = true;
+					return;
+				}
+			}
+
 			//For the first generator, store the value in the block.
-			inputs_[0].tick(outputFrames_, context);
+			bool constant = inputs_[0].isConstant();
+
+			if(constant) {
+				outputFrames_.Fill((*inputViews_[0])(0, 0u));
+			}
+			else {
+				outputFrames_.Copy(*inputViews_[0]);
+			}
 
-			//For additional generators, use the workspace stkframes for tick, and multiply it into the frames argument.
+			//For additional generators, multiply their output blocks into the frames. Same order as always, so the result doesn't change.
+			//Constant inputs (gains, mostly) multiply by a single value.
 			for(size_t i = 1; i < inputs_.size(); ++i) {
-				inputs_[i].tick(workSpace_, context);
-				outputFrames_ *= workSpace_;
+				if(inputs_[i].isConstant()) {
+					outputFrames_ *= (*inputViews_[i])(0, 0u);
+				}
+				else {
+					outputFrames_ *= *inputViews_[i];
+					constant = false;
+				}
 			}
+
+			outputIsConstant_ = constant;
 		}
 	}
 
@@ -302,7 +354,6 @@ namespace NAudio {
 		protected:
 			Generator left_;
 			Generator right_;
-			NAudioFrames workSpace_;
 
 			void
 			computeSynthesisBlock(const SynthesisContext_& context);
@@ -315,17 +366,23 @@ namespace NAudio {
 
 			void
 			setRight(Generator arg);
-
-			void
-			setIsStereoOutput(bool stereo);
 		};
 
 		inline void
 		Divider_::computeSynthesisBlock(const SynthesisContext_& context) {
-			left_.tick(outputFrames_, context);
-			right_.tick(workSpace_, context);
+			const NAudioFrames& leftFrames = left_.tickView(context);
+
+			if(left_.isConstant()) {
+				outputFrames_.Fill(leftFrames(0, 0u));
+			}
+			else {
+				outputFrames_.Copy(leftFrames);
+			}
+
+			//Always divided per sample, multiplying by a reciprocal would round differently.
+			outputFrames_ /= right_.tickView(context);
 
-			outputFrames_ /= workSpace_;
+			outputIsConstant_ = (left_.isConstant() && right_.isConstant());
 		}
 	}
 
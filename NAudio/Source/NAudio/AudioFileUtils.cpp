@@ -89,4 +89,76 @@ namespace NAudio {
 		return(NULL);
 	}
 #endif
-}
+
+	//Little-endian writers for the WAV header.
+	static void
+	writeUInt32LE(FILE* file, unsigned long value) {
+		unsigned char bytes[4] = { (unsigned char)(value & 0xFF), (unsigned char)((value >> 8) & 0xFF), (unsigned char)((value >> 16) & 0xFF), (unsigned char)((value >> 24) & 0xFF) };
+		fwrite(bytes, 1, 4, file);
+	}
+
+	static void
+	writeUInt16LE(FILE* file, unsigned int value) {
+		unsigned char bytes[2] = { (unsigned char)(value & 0xFF), (unsigned char)((value >> 8) & 0xFF) };
+		fwrite(bytes, 1, 2, file);
+	}
+
+	bool
+	writeWavFile(std::string path, const float* samples, unsigned long numFrames, unsigned int numChannels, float sampleRate) {
+		FILE* file = fopen(path.c_str(), "wb");
+
+		if(file == NULL) {
+			LOG(NLOG_ERROR, "Could not open %s for writing.", path.c_str());
+			return(false);
+		}
+
+		const unsigned long dataSize = numFrames * numChannels * 4ul;
+		const unsigned long rate = (unsigned long)sampleRate;
+
+		fwrite("RIFF", 1, 4, file);
+		writeUInt32LE(file, 36ul + dataSize);
+		fwrite("WAVE", 1, 4, file);
+
+		//Format chunk. Format 3 is IEEE float.
+		fwrite("fmt ", 1, 4, file);
+		writeUInt32LE(file, 16ul);
+		writeUInt16LE(file, 3u);
+		writeUInt16LE(file, numChannels);
+		writeUInt32LE(file, rate);
+		writeUInt32LE(file, rate * numChannels * 4ul);
+		writeUInt16LE(file, numChannels * 4u);
+		writeUInt16LE(file, 32u);
+
+		fwrite("data", 1, 4, file);
+		writeUInt32LE(file, dataSize);
+
+		//Samples are written byte by byte so the file is little-endian on any host.
+		unsigned char buffer[4096];
+		size_t used = 0;
+		bool ok = true;
+
+		for(unsigned long i = 0; i < numFrames * numChannels; ++i) {
+			uint32_t bits;
+			memcpy(&bits, &samples[i], 4);
+
+			buffer[used++] = (unsigned char)(bits & 0xFF);
+			buffer[used++] = (unsigned char)((bits >> 8) & 0xFF);
+			buffer[used++] = (unsigned char)((bits >> 16) & 0xFF);
+			buffer[used++] = (unsigned char)((bits >> 24) & 0xFF);
+
+			if(used == sizeof(buffer)) {
+				ok = ok && fwrite(buffer, 1, used, file) == used;
+				used = 0;
+			}
+		}
+
+		ok = ok && fwrite(buffer, 1, used, file) == used;
+		ok = (fclose(file) == 0) && ok;
+
+		if(!ok) {
+			LOG(NLOG_ERROR, "Error writing %s.", path.c_str());
+		}
+
+		return(ok);
+	}
+}
\ No newline at end of file
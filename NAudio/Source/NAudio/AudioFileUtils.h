@@ -4,4 +4,7 @@
 
 namespace NAudio {
 	SampleTable loadAudioFile(std::string path, int numChannels = 2);
+
+	//Write interleaved samples to a 32-bit float WAV file. Available on every platform. Returns false if the file could not be written.
+	bool writeWavFile(std::string path, const float* samples, unsigned long numFrames, unsigned int numChannels, float sampleRate = SampleRate());
 }
\ No newline at end of file
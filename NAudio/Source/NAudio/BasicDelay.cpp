@@ -6,6 +6,7 @@ namespace NAudio {
 		BasicDelay_::BasicDelay_() {
 			delayTimeFrames_.Resize(kSynthesisBlockSize, 1u, 0.0f);
 			fbkFrames_.Resize(kSynthesisBlockSize, 1u, 0.0f);
+			feedbackFrames_.Resize(kSynthesisBlockSize, 1u, 0.0f);
 
 			delayTimeGen_ = FixedValue(0.0f);
 			fbkGen_ = FixedValue(0.0f);
@@ -22,8 +23,8 @@ namespace NAudio {
 			setIsStereoInput(input.isStereoOutput());
 			setIsStereoOutput(input.isStereoOutput());
 
-			//Can safely resize as NAudioFrames subclass - calling functions account for channel offset.
-			delayLine_.Resize(delayLine_.Frames(), input.isStereoOutput() ? 2u : 1u, 0.0f);
+			//The line holds one channel per input channel.
+			delayLine_.initialize(delayLine_.getMaxDelay(), input.isStereoOutput() ? 2u : 1u);
 		}
 
 		void
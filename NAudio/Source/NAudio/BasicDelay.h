@@ -15,6 +15,9 @@ namespace NAudio {
 
 			DelayLine delayLine_;
 
+			//Input plus feedback, written into the line.
+			NAudioFrames feedbackFrames_;
+
 			void
 			computeSynthesisBlock(const SynthesisContext_& context);
 
@@ -42,31 +45,53 @@ namespace NAudio {
 
 		inline void
 		BasicDelay_::computeSynthesisBlock(const SynthesisContext_& context) {
-			delayTimeGen_.tick(delayTimeFrames_, context);
-			fbkGen_.tick(fbkFrames_, context);
+			delayLine_.setSampleRate(context.sampleRate);
+
+			//Delay time and feedback are usually fixed, those are read from a single value instead of being copied into the workspaces.
+			unsigned int delStride;
+			unsigned int fbkStride;
+
+			const float* delptr = delayTimeGen_.tickSamples(delayTimeFrames_, context, delStride);
+			const float* fbkptr = fbkGen_.tickSamples(fbkFrames_, context, fbkStride);
+
+			const float lastFbk = fbkptr[(outputFrames_.Frames() - 1) * fbkStride];
 
 			//input->output always has same channel layout.
 			unsigned int nChannels = isStereoInput() ? 2u : 1u;
 
-			float fbk, outSamp;
+			const unsigned int nFrames = outputFrames_.Frames();
+			const unsigned int run = delayLine_.getFeedbackRunFrames(delptr, delStride, nFrames);
+
+			feedbackFrames_.Resize(nFrames, nChannels);
+
 			float* dryptr = &dryFrames_[0];
 			float* outptr = &outputFrames_[0];
-			float* fbkptr = &fbkFrames_[0];
-			float* delptr = &delayTimeFrames_[0];
+			float* fbptr = &feedbackFrames_[0];
 
-			for(unsigned int i = 0; i < kSynthesisBlockSize; ++i) {
-				//Don't clamp feeback, be careful! Negative feedback could be interesting.
-				fbk = *fbkptr++;
+			//Read a run of the line, then feed it back. Runs are short enough that none of their reads reach the frames they write.
+			for(unsigned int done = 0, count = 0; done < nFrames; done += count) {
+				count = Min(nFrames - done, run);
 
 				for(unsigned int c = 0; c < nChannels; ++c) {
-					outSamp = delayLine_.tickOut(*delptr, c);
-					delayLine_.tickIn(*dryptr++ + outSamp * fbk, c);
-					*outptr++ = outSamp;
+					delayLine_.read(outptr + done * nChannels + c, nChannels, delptr + done * delStride, delStride, count, c);
 				}
 
-				delptr++;
-				delayLine_.advance();
+				for(unsigned int i = done * nChannels; i < (done + count) * nChannels; i += nChannels) {
+					//Don't clamp feeback, be careful! Negative feedback could be interesting.
+					float fbk = *fbkptr;
+					fbkptr += fbkStride;
+
+					for(unsigned int c = 0; c < nChannels; ++c) {
+						fbptr[i + c] = dryptr[i + c] + outptr[i + c] * fbk;
+					}
+				}
+
+				delayLine_.write(fbptr + done * nChannels, count);
+				delayLine_.advance(count);
 			}
+
+			//The line can be read anywhere up to its maximum delay, so the tail is measured from there.
+			tailLength_ = feedbackDelayTail(delayLine_.getMaxDelay(), lastFbk, kEffectTailFloorDb);
 		}
 	}
 
@@ -15,8 +15,8 @@ namespace NAudio {
 		void
 		BitCrusher_::SetIsStereoInput(bool stereo) {
 			if(stereo != isStereoInput_) {
-				dryFrames_.Resize(kSynthesisBlockSize, stereo ? 2u : 1u, 0.0f);
-				outputFrames_.Resize(kSynthesisBlockSize, stereo ? 2u : 1u, 0.0f);
+				dryFrames_.Resize(dryFrames_.Frames(), stereo ? 2u : 1u, 0.0f);
+				outputFrames_.Resize(outputFrames_.Frames(), stereo ? 2u : 1u, 0.0f);
 			}
 
 			isStereoInput_ = stereo;
@@ -4,7 +4,7 @@
 namespace NAudio {
 	namespace NAudio_DSP {
 		BufferFiller_::BufferFiller_() :
-			bufferReadPosition_(0)
+			bufferReadPosition_(0), newOutputRequested_(false), requestedBlockSize_(kSynthesisBlockSize), requestedSampleRate_(SampleRate()), arena_(new MemoryArena_)
 		{
 			NAUDIO_MUTEX_INIT(mutex_);
 			setIsStereoOutput(true);
@@ -12,6 +12,33 @@ namespace NAudio {
 
 		BufferFiller_::~BufferFiller_() {
 			NAUDIO_MUTEX_DESTROY(mutex_);
+
+			arena_->release();
+		}
+
+		void
+		BufferFiller_::setBlockSize(unsigned int blockSize) {
+			if(!isValidSynthesisBlockSize(blockSize)) {
+				LOG(NLOG_ERROR, "Block size must be a power of two between %u and %u, got %u.", kMinSynthesisBlockSize, kMaxSynthesisBlockSize, blockSize);
+				return;
+			}
+
+			requestedBlockSize_.store(blockSize, std::memory_order_relaxed);
+		}
+
+		void
+		BufferFiller_::setSampleRate(float sampleRate) {
+			if(!(sampleRate > 0.0f)) {
+				LOG(NLOG_ERROR, "Sample rate must be positive, got %f.", sampleRate);
+				return;
+			}
+
+			requestedSampleRate_.store(sampleRate, std::memory_order_relaxed);
+		}
+
+		bool
+		BufferFiller_::reserveMemory(size_t bytes) {
+			return(arena_->reserve(bytes));
 		}
 	}
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Generator.h"
+#include "SwapSlot.h"
 
 namespace NAudio {
 	namespace NAudio_DSP {
@@ -10,21 +11,83 @@ namespace NAudio {
 			unsigned long bufferReadPosition_;
 			NAUDIO_MUTEX_T mutex_;
 
+			//Set by control threads, picked up by the audio thread at the next block.
+			std::atomic<bool> newOutputRequested_;
+			std::atomic<unsigned int> requestedBlockSize_;
+			std::atomic<float> requestedSampleRate_;
+
+			//Buffers grown while this graph ticks come from here. Shared with those buffers, which keep it alive.
+			MemoryArena_* arena_;
+
 		protected:
 			NAudio_DSP::SynthesisContext_ synthContext_;
 
+			//Called once per block, right before the block is computed. Subclasses override to apply commands queued by other threads.
+			virtual void
+			processCommands(const SynthesisContext_&) {
+			}
+
 		public:
 			BufferFiller_();
 			~BufferFiller_();
 
-			//Mutex for swapping inputs, etc.
+			//Mutex for serializing changes made from control threads (swapping inputs, etc). Never taken by the audio thread.
 			void lockMutex();
 			void unlockMutex();
 
+			//Make every generator compute fresh output on the next block. Safe to call from any thread.
+			void
+			requestNewOutput() {
+				newOutputRequested_.store(true, std::memory_order_release);
+			}
+
+			//Set the number of frames computed per block by this graph. Must be a power of two in [kMinSynthesisBlockSize, kMaxSynthesisBlockSize].
+			//Safe to call from any thread, the new size is used from the next block on. Generators grow their buffers the first time they see a larger block,
+			//so set it before starting audio to keep allocations off the audio thread.
+			void
+			setBlockSize(unsigned int blockSize);
+
+			unsigned int
+			getBlockSize() {
+				return(requestedBlockSize_.load(std::memory_order_relaxed));
+			}
+
+			//Set the sample rate this graph runs at. Defaults to SampleRate() at the time the BufferFiller is created.
+			//Safe to call from any thread, the new rate is used from the next block on. Delay lines are resized the first time they run at a new rate,
+			//so set it before starting audio to keep allocations off the audio thread.
+			void
+			setSampleRate(float sampleRate);
+
+			float
+			getSampleRate() {
+				return(requestedSampleRate_.load(std::memory_order_relaxed));
+			}
+
+			//Reserve bytes of aligned memory for the buffers this graph grows while it runs, so a larger block size or a new sample rate does not allocate on the audio thread.
+			//Every BufferFiller has its own, the inputs of a Mixer included. Call before starting audio, never while the graph is being ticked. Returns false if out of memory.
+			bool
+			reserveMemory(size_t bytes);
+
+			//Bytes that did not fit in the reserved memory and were allocated on the audio thread anyway.
+			size_t
+			getMemoryOverflow() {
+				return(arena_->overflow());
+			}
+
 			//Process a single synthesis vector, output to frames. Tick method without context argument passes down this instance's SynthesisContext_.
 			void
 			tick(NAudioFrames& frames);
 
+			//Overridden so queued commands are applied whether this is ticked on its own or as the input of another BufferFiller_.
+			const NAudioFrames&
+			tickView(const SynthesisContext_& context);
+
+			//Apply queued commands for the block of context without computing it. For parents that skip blocks of this graph, so its queues don't fill up meanwhile.
+			void
+			pollCommands(const SynthesisContext_& context) {
+				processCommands(context);
+			}
+
 			void
 			fillBufferOfFloats(float* outData, unsigned int numFrames, unsigned int numChannels);
 		};
@@ -41,12 +104,40 @@ namespace NAudio {
 
 		inline void
 		BufferFiller_::tick(NAudioFrames& frames) {
-			lockMutex();
-			{
-				Generator_::tick(frames, synthContext_);
-				synthContext_.tick();
+			//No lock here, state shared with control threads is swapped in by processCommands() at the start of the block.
+			if(newOutputRequested_.exchange(false, std::memory_order_acq_rel)) {
+				synthContext_.forceNewOutput = true;
 			}
-			unlockMutex();
+
+			synthContext_.blockSize = requestedBlockSize_.load(std::memory_order_relaxed);
+			synthContext_.sampleRate = requestedSampleRate_.load(std::memory_order_relaxed);
+
+			MemoryArenaScope_ arenaScope(arena_);
+
+			Generator_::tick(frames, synthContext_);
+			synthContext_.tick();
+		}
+
+		inline const NAudioFrames&
+		BufferFiller_::tickView(const SynthesisContext_& context) {
+			if(context.forceNewOutput || lastFrameIndex_ != context.elapsedFrames) {
+				processCommands(context);
+			}
+
+			//Also set here, so the inputs of a Mixer grow from their own arena on whichever thread renders them.
+			MemoryArenaScope_ arenaScope(arena_);
+
+			//A nested graph is a recording boundary, like an Oversampled subgraph. Its nodes are only recorded by its own schedule, the outer one sees this node alone,
+			//so the outer schedule never keeps pointers to nodes this graph may replace.
+			if(context.recorder != NULL) {
+				SynthesisContext_ innerContext = context;
+
+				innerContext.recorder = NULL;
+
+				return(Generator_::tickView(innerContext));
+			}
+
+			return(Generator_::tickView(context));
 		}
 
 		inline void
@@ -58,7 +149,7 @@ namespace NAudio {
 				LOG(NLOG_ERROR, "Mismatch in channels sent to Synth::fillBufferOfFloats.");
 			}
 
-			const unsigned long sampleCount = (unsigned long)outputFrames_.Size();
+			unsigned long sampleCount = (unsigned long)outputFrames_.Size();
 			const unsigned int channelsPerSample = (outputFrames_.Channels() - numChannels) + 1u;
 
 			float sample = 0.0f;
@@ -70,6 +161,10 @@ namespace NAudio {
 				for(unsigned int c = 0; c < channelsPerSample; ++c) {
 					if(bufferReadPosition_ == 0) {
 						tick(outputFrames_);
+
+						//The block size may have changed, which can also move the buffer.
+						sampleCount = (unsigned long)outputFrames_.Size();
+						outputSamples = &outputFrames_[0];
 					}
 
 					sample += *outputSamples++;
@@ -92,11 +187,52 @@ namespace NAudio {
 		{
 		}
 
+		//Apply queued commands without computing a block. See BufferFiller_::pollCommands().
+		inline void
+		pollCommands(const NAudio_DSP::SynthesisContext_& context) {
+			static_cast<NAudio_DSP::BufferFiller_*>(obj)->pollCommands(context);
+		}
+
 		//Fill an arbitrarily-sized, interleaved buffer of audio samples as floats. This BufferFiller's outputGen is used to fill an interleaved buffer starting at outData.
 		inline void
 		fillBufferOfFloats(float* outData, unsigned int numFrames, unsigned int numChannels) {
 			static_cast<NAudio_DSP::BufferFiller_*>(obj)->fillBufferOfFloats(outData, numFrames, numChannels);
 		}
+
+		//Set the number of frames computed per block, a power of two in [kMinSynthesisBlockSize, kMaxSynthesisBlockSize]. Defaults to kSynthesisBlockSize.
+		inline void
+		setBlockSize(unsigned int blockSize) {
+			static_cast<NAudio_DSP::BufferFiller_*>(obj)->setBlockSize(blockSize);
+		}
+
+		inline unsigned int
+		getBlockSize() {
+			return(static_cast<NAudio_DSP::BufferFiller_*>(obj)->getBlockSize());
+		}
+
+		//Set the sample rate this graph runs at, independently of other graphs. Defaults to SampleRate().
+		inline void
+		setSampleRate(float sampleRate) {
+			static_cast<NAudio_DSP::BufferFiller_*>(obj)->setSampleRate(sampleRate);
+		}
+
+		inline float
+		getSampleRate() {
+			return(static_cast<NAudio_DSP::BufferFiller_*>(obj)->getSampleRate());
+		}
+
+		//Reserve bytes of aligned memory for buffers the graph grows while running, such as generator blocks after setBlockSize() and delay lines after setSampleRate().
+		//About blockSize * channels * 4 bytes per generator and effect, plus the delay lines. Call before starting audio. Returns false if out of memory.
+		inline bool
+		reserveMemory(size_t bytes) {
+			return(static_cast<NAudio_DSP::BufferFiller_*>(obj)->reserveMemory(bytes));
+		}
+
+		//Bytes that did not fit in the reserved memory and were allocated on the audio thread anyway. Reserve this much more next time.
+		inline size_t
+		getMemoryOverflow() {
+			return(static_cast<NAudio_DSP::BufferFiller_*>(obj)->getMemoryOverflow());
+		}
 	};
 
 	template<class GenType>
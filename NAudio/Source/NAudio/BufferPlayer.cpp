@@ -17,7 +17,6 @@ namespace NAudio {
 		BufferPlayer_::setBuffer(SampleTable buffer) {
 			buffer_ = buffer;
 			setIsStereoOutput(buffer.channels() == 2u);
-			samplesPerSynthesisBlock = kSynthesisBlockSize * buffer_.channels();
 		}
 
 		inline void
@@ -26,13 +25,16 @@ namespace NAudio {
 			bool trigger = trigger_.tick(context).triggered;
 			float startPosition = startPosition_.tick(context).value;
 
+			samplesPerSynthesisBlock = (int)outputFrames_.Size();
+
 			if(trigger) {
 				isFinished_ = false;
-				currentSample = startPosition * SampleRate() * buffer_.channels();
+				currentSample = startPosition * context.sampleRate * buffer_.channels();
 			}
 
 			if(isFinished_) {
 				outputFrames_.Clear();
+				outputIsSilent_ = true;
 			}
 			else {
 				int samplesLeftInBuf = (int)buffer_.size() - currentSample;
@@ -54,7 +54,7 @@ namespace NAudio {
 	}
 
 	//Simply plays back a buffer. "loop" parameter works, but doesn't wrap between ticks, so mostly likely you'll wind up with a few zeroes at the end of the last buffer if you're looping.
-	//In other words, buffer lenghts are rounded up to the nearest kSynthesisBlockSize.
+	//In other words, buffer lenghts are rounded up to the nearest block size.
 	//Usage:
 	//	SampleTable buffer = loadAudioFile("/Users/morganpackard/Desktop/trashme/2013.6.5.mp3");
 	//	bPlayer.setBuffer(buffer).loop(false).trigger(ControlMetro().bpm(100));
@@ -36,21 +36,33 @@ namespace NAudio {
 		protected:
 			inline void
 			computeSynthesisBlock(const SynthesisContext_& context) {
-				//Tick modulations.
-				delayTimeGen_.tick(delayTimeFrames_, context);
+				delayLine_.setSampleRate(context.sampleRate);
+
+				//Tick modulations. A fixed delay time is read from a single value.
+				unsigned int dtStride;
+				const float* dtptr = delayTimeGen_.tickSamples(delayTimeFrames_, context, dtStride);
+
+				const unsigned int nFrames = outputFrames_.Frames();
+				const unsigned int writeAhead = (unsigned int)delayLine_.getWriteAheadFrames();
 
 				float* inptr = &dryFrames_[0];
 				float* outptr = &outputFrames_[0];
-				float* dtptr = &delayTimeFrames_[0];
 
 				float sf = scaleFactorCtrlGen_.tick(context).value;
 
 				float norm = (1.0f / (1.0f + sf));
 
-				for(unsigned int i = 0; i < kSynthesisBlockSize; ++i) {
-					delayLine_.tickIn(*inptr);
-					*outptr++ = (*inptr++ + delayLine_.tickOut(*dtptr++) * sf) * norm;
-					delayLine_.advance();
+				//Write the input, then read it back delayed. Only blocks longer than the line's write-ahead (oversampled subgraphs) take more than one pass.
+				for(unsigned int done = 0, count = 0; done < nFrames; done += count) {
+					count = Min(nFrames - done, writeAhead);
+
+					delayLine_.write(inptr + done, count);
+					delayLine_.read(outptr + done, 1u, dtptr + done * dtStride, dtStride, count);
+					delayLine_.advance(count);
+				}
+
+				for(unsigned int i = 0; i < nFrames; ++i) {
+					outptr[i] = (inptr[i] + outptr[i] * sf) * norm;
 				}
 			}
 		};
@@ -60,22 +72,35 @@ namespace NAudio {
 		protected:
 			inline void
 			computeSynthesisBlock(const SynthesisContext_& context) {
-				//Tick modulations.
-				delayTimeGen_.tick(delayTimeFrames_, context);
+				delayLine_.setSampleRate(context.sampleRate);
+
+				//Tick modulations. A fixed delay time is read from a single value.
+				unsigned int dtStride;
+				const float* dtptr = delayTimeGen_.tickSamples(delayTimeFrames_, context, dtStride);
 
 				float* inptr = &dryFrames_[0];
 				float* outptr = &outputFrames_[0];
-				float* dtptr = &delayTimeFrames_[0];
 
-				float y = 0;
+				const unsigned int nFrames = outputFrames_.Frames();
+				const unsigned int run = delayLine_.getFeedbackRunFrames(dtptr, dtStride, nFrames);
+
 				float sf = scaleFactorCtrlGen_.tick(context).value;
 				float norm = (1.0f / (1.0f + sf));
 
-				for(unsigned int i = 0; i < kSynthesisBlockSize; ++i) {
-					y = ((delayLine_.tickOut(*dtptr++) * sf) + *inptr++) * norm;
-					delayLine_.tickIn(y);
-					*outptr++ = y;
-					delayLine_.advance();
+				//Read a run of the line, then feed it back. Runs are short enough that none of their reads reach the frames they write.
+				for(unsigned int done = 0, count = 0; done < nFrames; done += count) {
+					count = Min(nFrames - done, run);
+
+					float* y = outptr + done;
+
+					delayLine_.read(y, 1u, dtptr + done * dtStride, dtStride, count);
+
+					for(unsigned int i = 0; i < count; ++i) {
+						y[i] = ((y[i] * sf) + *inptr++) * norm;
+					}
+
+					delayLine_.write(y, count);
+					delayLine_.advance(count);
 				}
 			}
 		};
@@ -109,29 +134,40 @@ namespace NAudio {
 
 		inline void
 		FilteredFBCombFilter6_::computeSynthesisBlock(const SynthesisContext_& context) {
-			//Tick modulations.
-			delayTimeGen_.tick(delayTimeFrames_, context);
+			delayLine_.setSampleRate(context.sampleRate);
+
+			//Tick modulations. A fixed delay time is read from a single value.
+			unsigned int dtStride;
+			const float* dtptr = delayTimeGen_.tickSamples(delayTimeFrames_, context, dtStride);
 
 			float* inptr = &dryFrames_[0];
 			float* outptr = &outputFrames_[0];
-			float* dtptr = &delayTimeFrames_[0];
 
-			float y = 0;
+			const unsigned int nFrames = outputFrames_.Frames();
+			const unsigned int run = delayLine_.getFeedbackRunFrames(dtptr, dtStride, nFrames);
+
 			float sf = scaleFactorCtrlGen_.tick(context).value;
 
-			float lowCoef = cutoffToOnePoleCoef(lowCutoffGen_.tick(context).value);
-			float hiCoef = 1.0f - cutoffToOnePoleCoef(highCutoffGen_.tick(context).value);
+			float lowCoef = cutoffToOnePoleCoef(lowCutoffGen_.tick(context).value, context.sampleRate);
+			float hiCoef = 1.0f - cutoffToOnePoleCoef(highCutoffGen_.tick(context).value, context.sampleRate);
 
-			for(unsigned int i = 0; i < kSynthesisBlockSize; ++i) {
-				onePoleLPFTick(delayLine_.tickOut(*dtptr++), lastOutLow_, lowCoef);
-				onePoleHPFTick(lastOutLow_, lastOutHigh_, hiCoef);
+			for(unsigned int done = 0, count = 0; done < nFrames; done += count) {
+				count = Min(nFrames - done, run);
 
-				//No normalization on purpose.
-				y = ((lastOutHigh_ * sf) + *inptr++);
+				float* y = outptr + done;
+
+				delayLine_.read(y, 1u, dtptr + done * dtStride, dtStride, count);
+
+				for(unsigned int i = 0; i < count; ++i) {
+					onePoleLPFTick(y[i], lastOutLow_, lowCoef);
+					onePoleHPFTick(lastOutLow_, lastOutHigh_, hiCoef);
+
+					//No normalization on purpose.
+					y[i] = ((lastOutHigh_ * sf) + *inptr++);
+				}
 
-				delayLine_.tickIn(y);
-				*outptr++ = y;
-				delayLine_.advance();
+				delayLine_.write(y, count);
+				delayLine_.advance(count);
 			}
 		}
 	}
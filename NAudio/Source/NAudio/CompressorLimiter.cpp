@@ -3,15 +3,22 @@
 namespace NAudio {
 	namespace NAudio_DSP {
 		Compressor_::Compressor_() :
-			ampEnvValue_(0.0f), gainEnvValue_(1.0f),
+			detection_(CompressorDetectionPeak), stereoLink_(true),
 			isLimiter_(false)
 		{
+			gainReductionDb_[0] = 0.0f;
+			gainReductionDb_[1] = 0.0f;
+			meanSquare_[0] = 0.0f;
+			meanSquare_[1] = 0.0f;
+
 			ampInputFrames_.Resize(kSynthesisBlockSize, 1u, 0.0f);
+			gainFrames_.Resize(kSynthesisBlockSize, 1u, 0.0f);
 
 			lookaheadDelayLine_.initialize(0.01f, 2u);
 			lookaheadDelayLine_.setInterpolates(false);		//No real need to interpolate here for lookahead.
 
 			makeupGainGen_ = ControlValue(1.0f);
+			kneeGen_ = ControlValue(0.0f);
 		}
 
 		//Default inherited input method sets both audio signal and amplitude signal as input so incoming signal is compressed based on its own amplitude.
@@ -32,7 +39,7 @@ namespace NAudio {
 		void
 		Compressor_::setAmplitudeInput(Generator gen) {
 			amplitudeInput_ = gen;
-			ampInputFrames_.Resize(kSynthesisBlockSize, amplitudeInput_.isStereoOutput() ? 2u : 1u, 0.0f);
+			ampInputFrames_.Resize(ampInputFrames_.Frames(), amplitudeInput_.isStereoOutput() ? 2u : 1u, 0.0f);
 		}
 
 		void
@@ -40,7 +47,7 @@ namespace NAudio {
 			setIsStereoInput(isStereo);
 			setIsStereoOutput(isStereo);
 
-			ampInputFrames_.Resize(kSynthesisBlockSize, isStereo ? 2u : 1u, 0.0f);
+			ampInputFrames_.Resize(ampInputFrames_.Frames(), isStereo ? 2u : 1u, 0.0f);
 		}
 	}
 
@@ -4,8 +4,24 @@
 #include "DelayUtils.h"
 #include "FilterUtils.h"
 
+//Averaging time of RMS detection, in seconds.
+#define NAUDIO_COMPRESSOR_RMS_TIME			0.01f
+
+//Gain reduction closer to 0 dB than this counts as none, so a released envelope comes to rest instead of creeping towards 0 forever.
+#define NAUDIO_COMPRESSOR_SETTLED_DB		0.0001f
+
+//Decibels per octave of amplitude.
+#define NAUDIO_DB_PER_OCTAVE				6.0205999f
+
 namespace NAudio {
+	typedef enum {
+		CompressorDetectionPeak = 0,		//Follows the magnitude of the amplitude input, sample by sample.
+		CompressorDetectionRMS				//Follows the power of the amplitude input, averaged over NAUDIO_COMPRESSOR_RMS_TIME.
+	} CompressorDetection;
+
 	namespace NAudio_DSP {
+		//Feed-forward compressor. Detection, the gain computer and the gain are block operations, in dB with fast log2/exp2, and only the envelopes run sample by sample.
+		//Blocks that stay below the knee with no gain reduction left to release skip the gain computer altogether, which keeps the limiter on every Synth cheap.
 		class Compressor_ : public Effect_ {
 		protected:
 			//Can be overridden for sidechaining.
@@ -17,13 +33,23 @@ namespace NAudio {
 			ControlGenerator threshGen_;
 			ControlGenerator ratioGen_;
 			ControlGenerator lookaheadGen_;
+			ControlGenerator kneeGen_;
+
+			CompressorDetection detection_;
+
+			//Linked channels share one gain, from the loudest of them. Unlinked, every channel has its own detector and gain.
+			bool stereoLink_;
 
 			DelayLine lookaheadDelayLine_;
 
 			NAudioFrames ampInputFrames_;
 
-			float ampEnvValue_;
-			float gainEnvValue_;
+			//Detector level, then gain reduction, then gain of every frame of the block, one channel per detector.
+			NAudioFrames gainFrames_;
+
+			//Smoothed gain reduction in dB, and the running mean square of RMS detection, of each detector.
+			float gainReductionDb_[2];
+			float meanSquare_[2];
 
 			bool isLimiter_;
 
@@ -37,8 +63,8 @@ namespace NAudio {
 			void
 			setInput(Generator input);
 
-			void
-			tick(NAudioFrames& frames, const SynthesisContext_& context);
+			const NAudioFrames&
+			tickView(const SynthesisContext_& context);
 			void
 			tickThrough(NAudioFrames& inFrames, NAudioFrames& outFrames, const SynthesisContext_& context);
 
@@ -72,6 +98,21 @@ namespace NAudio {
 				lookaheadGen_ = gen;
 			}
 
+			void
+			setKnee(ControlGenerator gen) {
+				kneeGen_ = gen;
+			}
+
+			void
+			setDetection(CompressorDetection detection) {
+				detection_ = detection;
+			}
+
+			void
+			setStereoLink(bool stereoLink) {
+				stereoLink_ = stereoLink;
+			}
+
 			//Set whether is a limiter - limiters will hard clip to threshold in worst case.
 			void
 			setIsLimiter(bool isLimiter) {
@@ -83,98 +124,134 @@ namespace NAudio {
 			setIsStereo(bool isStereo);
 		};
 
-		inline void
-		Compressor_::tick(NAudioFrames& frames, const SynthesisContext_& context) {
+		inline const NAudioFrames&
+		Compressor_::tickView(const SynthesisContext_& context) {
 			if(context.forceNewOutput || lastFrameIndex_ != context.elapsedFrames) {
 				//Get amp input frames.
 				amplitudeInput_.tick(ampInputFrames_, context);
 			}
 
-			Effect_::tick(frames, context);
+			return(Effect_::tickView(context));
 		}
 
 		inline void
 		Compressor_::tickThrough(NAudioFrames& inFrames, NAudioFrames& outFrames, const SynthesisContext_& context) {
+			ampInputFrames_.Resize(inFrames.Frames(), ampInputFrames_.Channels());
 			ampInputFrames_.Copy(inFrames);
 			Effect_::tickThrough(inFrames, outFrames, context);
 		}
 
 		inline void
 		Compressor_::computeSynthesisBlock(const SynthesisContext_& context) {
+			lookaheadDelayLine_.setSampleRate(context.sampleRate);
+
 			//Tick all scalar parameters.
-			float attackCoef = t60ToOnePoleCoef(Max(0.0f, attackGen_.tick(context).value));
-			float releaseCoef = t60ToOnePoleCoef(Max(0.0f, releaseGen_.tick(context).value));
+			float attackCoef = t60ToOnePoleCoef(Max(0.0f, attackGen_.tick(context).value), context.sampleRate);
+			float releaseCoef = t60ToOnePoleCoef(Max(0.0f, releaseGen_.tick(context).value), context.sampleRate);
 			float threshold = Max(0.0f, threshGen_.tick(context).value);
-			float ratio = Max(0.0f, ratioGen_.tick(context).value);
+			float ratio = Max(1.0f, ratioGen_.tick(context).value);
+			float knee = Max(0.0f, kneeGen_.tick(context).value);
 			float lookaheadTime = Max(0.0f, lookaheadGen_.tick(context).value);
+			float makeupGain = Max(0.0f, makeupGainGen_.tick(context).value);
 
-			//Absolute value of amplitude frames in prep for amp envelope.
-			float* ampData = &ampInputFrames_[0];
+			const unsigned int nFrames = outputFrames_.Frames();
+			const unsigned int nChannels = outputFrames_.Channels();
+			const unsigned int nAmpChannels = ampInputFrames_.Channels();
+			const unsigned int nDetectors = (stereoLink_ || nChannels == 1) ? 1u : nAmpChannels;
+			const unsigned int nLevels = nFrames * nDetectors;
+			const bool rms = (detection_ == CompressorDetectionRMS);
+			const SIMDKernels_& simd = SIMD();
 
-			for(unsigned int i = 0; i < ampInputFrames_.Size(); ++i, ++ampData) {
-				*ampData = fabsf(*ampData);
-			}
+			//Detector level of every frame. Magnitude for peak detection, power for RMS. Linked, the loudest channel sets the level.
+			gainFrames_.Resize(nFrames, nDetectors);
 
-			//Iterate through samples.
-			unsigned int nChannels = outputFrames_.Channels();
+			float* gain = &gainFrames_[0];
+			const unsigned int nLevelChannels = (nDetectors == nAmpChannels) ? 1u : nAmpChannels;
 
-			float ampInputValue;
-			float gainValue;
-			float gainTarget;
+			float peak = simd.levelDetect(gain, &ampInputFrames_[0], nLevelChannels, rms, nLevels);
 
-			float* outptr = &outputFrames_[0];
-			float* dryptr = &dryFrames_[0];
+			if(rms) {
+				const float rmsCoef = expf(-1.0f / (NAUDIO_COMPRESSOR_RMS_TIME * context.sampleRate));
 
-			ampData = &ampInputFrames_[0];
+				peak = 0.0f;
 
-			for(unsigned int i = 0; i < kSynthesisBlockSize; ++i) {
-				//Tick input into lookahead delay and get amplitude input value - max of left/right.
-				ampInputValue = 0;
+				for(unsigned int d = 0; d < nDetectors; ++d) {
+					float meanSquare = meanSquare_[d];
 
-				for(unsigned int j = 0; j < nChannels; ++j) {
-					lookaheadDelayLine_.tickIn(*dryptr++, j);
-					ampInputValue = Max(ampInputValue, *ampData++);
-				}
+					for(unsigned int i = d; i < nLevels; i += nDetectors) {
+						meanSquare = gain[i] + rmsCoef * (meanSquare - gain[i]);
+						gain[i] = meanSquare;
+						peak = Max(peak, meanSquare);
+					}
 
-				//Smooth amplitude input.
-				if(ampInputValue >= ampEnvValue_) {
-					onePoleLPFTick(ampInputValue, ampEnvValue_, attackCoef);
-				}
-				else {
-					onePoleLPFTick(ampInputValue, ampEnvValue_, releaseCoef);
+					meanSquare_[d] = meanSquare;
 				}
+			}
 
-				//Calculate gain value.
-				if(ampEnvValue_ <= threshold) {
-					gainValue = 1.0f;
-				}
-				else {
-					//Compensate for ratio.
-					gainTarget = threshold + ((ampEnvValue_ - threshold) / ratio);
-					gainValue = gainTarget / ampEnvValue_;
-				}
+			//Levels to dB. Power is already squared, so it takes half the dB per octave.
+			const float levelDbScale = rms ? 0.5f * NAUDIO_DB_PER_OCTAVE : NAUDIO_DB_PER_OCTAVE;
+			const float thresholdDb = NAUDIO_DB_PER_OCTAVE * fastLog2(threshold);
 
-				//Smooth gain value.
-				if(gainValue <= gainEnvValue_) {
-					onePoleLPFTick(gainValue, gainEnvValue_, attackCoef);
-				}
-				else {
-					onePoleLPFTick(gainValue, gainEnvValue_, releaseCoef);
+			bool settled = true;
+
+			for(unsigned int d = 0; d < nDetectors; ++d) {
+				settled = settled && (gainReductionDb_[d] == 0.0f);
+			}
+
+			//Nothing reaches the knee and there is no gain reduction to release, so the gain is just the makeup gain.
+			const bool unityBlock = (settled && levelDbScale * fastLog2(peak) < thresholdDb - 0.5f * knee);
+
+			if(!unityBlock) {
+				//Gain computer. Reduction in dB is 0 below the knee and (1 / ratio - 1) of the overshoot above it, with a quadratic blend across the knee.
+				simd.gainComputer(gain, levelDbScale, thresholdDb, knee, 1.0f / ratio - 1.0f, nLevels);
+
+				//Smooth the reduction, attacking while it deepens and releasing while it recovers. The distance to the target is split at 0 with Max and Min, so each side gets its coefficient without a branch.
+				for(unsigned int d = 0; d < nDetectors; ++d) {
+					float reductionDb = gainReductionDb_[d];
+
+					for(unsigned int i = d; i < nLevels; i += nDetectors) {
+						const float target = gain[i];
+						const float distance = reductionDb - target;
+
+						reductionDb = target + attackCoef * Max(distance, 0.0f) + releaseCoef * Min(distance, 0.0f);
+						gain[i] = reductionDb;
+					}
+
+					gainReductionDb_[d] = (reductionDb > -NAUDIO_COMPRESSOR_SETTLED_DB) ? 0.0f : reductionDb;
 				}
 
-				//Apply gain.
+				//Back to linear gain, makeup gain included.
+				simd.exp2Scaled(gain, 1.0f / NAUDIO_DB_PER_OCTAVE, makeupGain, nLevels);
+			}
+
+			float* outptr = &outputFrames_[0];
+			float* dryptr = &dryFrames_[0];
+
+			//Tick input into lookahead delay and read it back. Only blocks longer than the line's write-ahead (oversampled subgraphs) take more than one pass.
+			const unsigned int writeAhead = (unsigned int)lookaheadDelayLine_.getWriteAheadFrames();
+
+			for(unsigned int done = 0, count = 0; done < nFrames; done += count) {
+				count = Min(nFrames - done, writeAhead);
+
 				for(unsigned int j = 0; j < nChannels; ++j) {
-					*outptr++ = lookaheadDelayLine_.tickOut(lookaheadTime, j) * gainEnvValue_;
+					lookaheadDelayLine_.write(dryptr + done * nChannels + j, nChannels, count, j);
+					lookaheadDelayLine_.read(outptr + done * nChannels + j, nChannels, &lookaheadTime, 0u, count, j);
 				}
 
-				lookaheadDelayLine_.advance();
+				lookaheadDelayLine_.advance(count);
 			}
 
-			float makeupGain = Max(0.0f, makeupGainGen_.tick(context).value);
-			outptr = &outputFrames_[0];
-
-			for(unsigned int i = 0; i < outputFrames_.Size(); ++i) {
-				*outptr++ *= makeupGain;
+			//Apply gain.
+			if(unityBlock) {
+				if(makeupGain != 1.0f) {
+					simd.scale(outptr, makeupGain, outputFrames_.Size());
+				}
+			}
+			else if(nDetectors == nChannels) {
+				simd.mul(outptr, gain, outputFrames_.Size());
+			}
+			else {
+				simd.mulMono(outptr, gain, nFrames);
 			}
 
 			if(isLimiter_) {
@@ -185,6 +262,9 @@ namespace NAudio {
 					*outptr = Clamp(*outptr, -threshold, threshold);
 				}
 			}
+
+			//Output is the delayed input, silent once the lookahead has passed. Waiting out the release as well lets the gain settle before blocks are skipped.
+			tailLength_ = lookaheadTime + Max(0.0f, releaseGen_.tick(context).value);
 		}
 	}
 
@@ -217,7 +297,21 @@ namespace NAudio {
 		NAUDIO_MAKE_CTRL_GEN_SETTERS(Compressor, lookahead, setLookahead);
 		NAUDIO_MAKE_CTRL_GEN_SETTERS(Compressor, makeupGain, setMakeupGain);
 
-		//TODO: option for RMS
+		//Width in dB of the soft knee around the threshold. 0 is a hard knee.
+		NAUDIO_MAKE_CTRL_GEN_SETTERS(Compressor, knee, setKnee);
+
+		Compressor&
+		detection(CompressorDetection detection) {
+			this->gen()->setDetection(detection);
+			return(*this);
+		}
+
+		//On by default. Off, each channel is compressed by its own level.
+		Compressor&
+		stereoLink(bool stereoLink) {
+			this->gen()->setStereoLink(stereoLink);
+			return(*this);
+		}
 	};
 
 	//Special case of compressor where ratio is fixed to infinite and attack time is fixed to 0.1 ms. Used for peak limiting.
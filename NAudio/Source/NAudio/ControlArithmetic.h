@@ -33,11 +33,15 @@ namespace NAudio {
 		inline void
 		ControlAdder_::computeOutput(const SynthesisContext_& context) {
 			output_.triggered = false;
+			output_.offset = 0;
 
+			//The output changes at the last event of any input.
 			for(unsigned int i = 0; i < inputs.size(); ++i) {
-				if(inputs[i].tick(context).triggered) {
+				ControlGeneratorOutput inputOut = inputs[i].tick(context);
+
+				if(inputOut.triggered) {
 					output_.triggered = true;
-					break;
+					output_.offset = Max(output_.offset, inputOut.offset);
 				}
 			}
 
@@ -125,6 +129,7 @@ namespace NAudio {
 			}
 			else {
 				output_.triggered = true;
+				output_.offset = Max(leftOut.triggered ? leftOut.offset : 0u, rightOut.triggered ? rightOut.offset : 0u);
 				output_.value = leftOut.value - rightOut.value;
 			}
 		}
@@ -187,11 +192,15 @@ namespace NAudio {
 		inline void
 		ControlMultiplier_::computeOutput(const SynthesisContext_& context) {
 			output_.triggered = false;
+			output_.offset = 0;
 
+			//The output changes at the last event of any input.
 			for(unsigned int i = 0; i < inputs.size(); ++i) {
-				if(inputs[i].tick(context).triggered) {
+				ControlGeneratorOutput inputOut = inputs[i].tick(context);
+
+				if(inputOut.triggered) {
 					output_.triggered = true;
-					break;
+					output_.offset = Max(output_.offset, inputOut.offset);
 				}
 			}
 
@@ -287,6 +296,7 @@ namespace NAudio {
 			}
 			else {
 				output_.triggered = true;
+				output_.offset = Max(leftOut.triggered ? leftOut.offset : 0u, rightOut.triggered ? rightOut.offset : 0u);
 				output_.value = leftOut.value / rightOut.value;
 			}
 		}
@@ -38,6 +38,7 @@ namespace NAudio {
 			if(lhsOut.triggered) {
 				output_.value = satisfiesCondition(lhsOut.value, rhsOut.value) ? 1.0f : 0.0f;
 				output_.triggered = true;
+				output_.offset = lhsOut.offset;
 			}
 			else {
 				output_.value = 0.0f;
@@ -31,6 +31,7 @@ namespace NAudio {
 			ControlGeneratorOutput endOut = end.tick(context);
 
 			output_.triggered = tickOut.triggered;
+			output_.offset = tickOut.offset;
 
 			if(tickOut.triggered) {
 				output_.value += 1.0f;
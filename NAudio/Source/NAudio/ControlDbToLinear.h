@@ -15,6 +15,7 @@ namespace NAudio {
 			ControlGeneratorOutput inputOutput = input_.tick(context);
 
 			output_.triggered = inputOutput.triggered;
+			output_.offset = inputOutput.offset;
 
 			if(inputOutput.triggered) {
 				output_.value = DBToLin(inputOutput.value);
@@ -9,7 +9,8 @@ namespace NAudio {
 
 		void
 		ControlDelay_::initialize(float maxDelayTime) {
-			maxDelay_ = Max(maxDelayTime * SampleRate() / kSynthesisBlockSize, 1.0f);
+			//Sized for the smallest block, so the maximum delay holds at any block size.
+			maxDelay_ = Max(maxDelayTime * SampleRate() / kMinSynthesisBlockSize, 1.0f);
 			delayLine_.resize(maxDelay_);
 			readHead_ = maxDelay_ - 1;
 		}
@@ -33,10 +33,13 @@ namespace NAudio {
 		ControlDelay_::computeOutput(const SynthesisContext_& context) {
 			delayLine_[writeHead_] = input_.tick(context);
 
+			//The input's list of changes is gone by the time the block is read back, only its last change is delayed.
+			delayLine_[writeHead_].events = NULL;
+
 			ControlGeneratorOutput delayTimeOutput = delayTimeCtrlGen_.tick(context);
 
 			if(delayTimeOutput.triggered) {
-				unsigned int delayBlocks = (unsigned int)(Max(delayTimeOutput.value * SampleRate() / kSynthesisBlockSize, 1.0f));
+				unsigned int delayBlocks = (unsigned int)(Max(delayTimeOutput.value * context.sampleRate / context.blockSize, 1.0f));
 
 				if((long)delayBlocks >= maxDelay_) {
 					LOG(NLOG_DEBUG, "Delay time greater than maximum delay (defaults to 1 scond). Use constructor to set max delay. Example: ControlDelay(2.0);");
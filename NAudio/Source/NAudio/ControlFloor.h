@@ -7,8 +7,11 @@ namespace NAudio {
 		class ControlFloor_ : public ControlConditioner_ {
 			inline void
 			computeOutput(const SynthesisContext_& context) {
-				output_.value = (int)(input_.tick(context).value);
-				output_.triggered = input_.tick(context).triggered;
+				ControlGeneratorOutput inputOut = input_.tick(context);
+
+				output_.value = (int)(inputOut.value);
+				output_.triggered = inputOut.triggered;
+				output_.offset = inputOut.offset;
 			}
 		};
 	}
@@ -1,19 +1,123 @@
 #pragma once
 
 #include "NAudioCore.h"
+#include "GraphSchedule.h"
 
 namespace NAudio {
+	//Most changes a control keeps for one block. Changes past this replace the last one.
+	static const unsigned int kMaxControlEvents = 16;
+
+	//One change of a control, offset frames into the block.
+	struct ControlEvent {
+		float value;
+		unsigned int offset;
+	};
+
 	struct ControlGeneratorOutput {
 		float value;
 		bool triggered;
+
+		//Frame within the current block at which a triggered output takes effect. 0 is the start of the block.
+		//Consumers that don't care about sub-block timing can ignore it and apply the change to the whole block.
+		unsigned int offset;
+
+		//Every change in the current block in frame order, for generators that keep more than one, or NULL. value and offset are those of the last one.
+		//Owned by the generator and valid until it computes its next output. Read them with numEvents() and event().
+		const ControlEvent* events;
+		unsigned int nEvents;
 		
 		ControlGeneratorOutput() :
-			value(0), triggered(false)
+			value(0), triggered(false), offset(0), events(NULL), nEvents(0)
 		{
 		}
+
+		//Changes to apply in this block. A triggered output without a list is one change.
+		unsigned int
+		numEvents() const {
+			return(events ? nEvents : (triggered ? 1u : 0u));
+		}
+
+		ControlEvent
+		event(unsigned int i) const {
+			if(events) {
+				return(events[i]);
+			}
+
+			ControlEvent change = { value, offset };
+
+			return(change);
+		}
 	};
 	
 	namespace NAudio_DSP {
+		//Changes of a control within one block, in frame order. Fixed size, so adding one on the audio thread never allocates.
+		class ControlEventList_ {
+		private:
+			ControlEvent events_[kMaxControlEvents];
+			unsigned int nEvents_;
+
+		public:
+			ControlEventList_() :
+				nEvents_(0)
+			{
+			}
+
+			//A change at the same frame as an earlier one replaces it.
+			void
+			add(float value, unsigned int offset) {
+				unsigned int i = nEvents_;
+
+				while(i > 0 && events_[i - 1].offset > offset) {
+					--i;
+				}
+
+				if(i > 0 && events_[i - 1].offset == offset) {
+					events_[i - 1].value = value;
+					return;
+				}
+
+				//Full, the last change goes.
+				if(nEvents_ == kMaxControlEvents) {
+					--nEvents_;
+					i = Min(i, nEvents_);
+				}
+
+				for(unsigned int j = nEvents_; j > i; --j) {
+					events_[j] = events_[j - 1];
+				}
+
+				events_[i].value = value;
+				events_[i].offset = offset;
+				++nEvents_;
+			}
+
+			void
+			clear() {
+				nEvents_ = 0;
+			}
+
+			unsigned int
+			size() const {
+				return(nEvents_);
+			}
+
+			const ControlEvent&
+			operator[](unsigned int i) const {
+				return(events_[i]);
+			}
+
+			//Point output at these changes and set its value and offset to the last one. Leaves output alone if there are none.
+			void
+			report(ControlGeneratorOutput& output) const {
+				if(nEvents_ > 0) {
+					output.events = events_;
+					output.nEvents = nEvents_;
+					output.value = events_[nEvents_ - 1].value;
+					output.offset = events_[nEvents_ - 1].offset;
+				}
+			}
+		};
+
 		class ControlGenerator_ {
 		protected:
 			ControlGeneratorOutput output_;
@@ -67,7 +171,13 @@ namespace NAudio {
 		
 		inline ControlGeneratorOutput
 		tick(const NAudio_DSP::SynthesisContext_& context) {
-			return(obj->tick(context));
+			ControlGeneratorOutput output = obj->tick(context);
+
+			if(context.recorder != NULL) {
+				context.recorder->record(obj);
+			}
+
+			return(output);
 		}
 		
 		//Shortcut for creating ramped value.
@@ -25,17 +25,23 @@ namespace NAudio {
 		inline void
 		ControlMetro_::computeOutput(const SynthesisContext_& context) {
 			double sPerBeat = 60.0 / (double)Max(0.001f, bpm_.tick(context).value);
+			double blockTime = (double)context.blockSize / context.sampleRate;
 			double delta = context.elapsedTime - lastClickTime_;
 
+			output_.offset = 0;
+
 			if(delta >= 2.0 * sPerBeat || delta < 0.0) {
 				//Account for bpm interval outrunning tick interval or timer wrap-around
 				lastClickTime_ = context.elapsedTime;
 				output_.triggered = true;
 			}
-			else if(delta >= sPerBeat) {
-				//Acocunt for drift
+			else if(delta + blockTime > sPerBeat) {
+				//The next click falls inside this block. Acocunt for drift and report the frame it falls on.
 				lastClickTime_ += sPerBeat;
 				output_.triggered = true;
+
+				double clickFrame = (lastClickTime_ - context.elapsedTime) * context.sampleRate;
+				output_.offset = (unsigned int)Clamp(clickFrame + 0.5, 0.0, (double)(context.blockSize - 1));
 			}
 			else {
 				output_.triggered = false;
@@ -36,11 +36,14 @@ namespace NAudio {
 
 			output_.triggered = false;
 
-			if(input_.tick(context).triggered) {
+			ControlGeneratorOutput inputOut = input_.tick(context);
+
+			if(inputOut.triggered) {
 				unsigned int modcount = (tickCounter_++ + offset_) % divisions;
 
 				if(modcount == 0u) {
 					output_.triggered = true;
+					output_.offset = inputOut.offset;
 				}
 
 				if(tickCounter_ >= divisions) {
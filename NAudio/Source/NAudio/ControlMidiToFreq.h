@@ -11,6 +11,7 @@ namespace NAudio {
 				ControlGeneratorOutput inputOut = input_.tick(context);
 
 				output_.triggered = inputOut.triggered;
+				output_.offset = inputOut.offset;
 				output_.value = MtoF(inputOut.value);
 			}
 		};
@@ -11,12 +11,12 @@ namespace NAudio {
 		}
 
 		void
-		ControlParameter_::setNormalizedValue(float normVal) {
+		ControlParameter_::setNormalizedValue(float normVal, unsigned int offset) {
 			if(isLogarithmic_) {
-				setValue(MapLinToLog(normVal, min_, max_));
+				setValue(MapLinToLog(normVal, min_, max_), offset);
 			}
 			else {
-				setValue(MapFloat(normVal, 0.0f, 1.0f, min_, max_, true));
+				setValue(MapFloat(normVal, 0.0f, 1.0f, min_, max_, true), offset);
 			}
 		}
 
@@ -59,8 +59,8 @@ namespace NAudio {
 	}
 
 	ControlParameter&
-	ControlParameter::value(float value) {
-		gen()->setValue(value);
+	ControlParameter::value(float value, unsigned int offset) {
+		gen()->setValue(value, offset);
 		return(*this);
 	}
 
@@ -109,8 +109,8 @@ namespace NAudio {
 	}
 
 	ControlParameter&
-	ControlParameter::setNormalizedValue(float value) {
-		gen()->setNormalizedValue(value);
+	ControlParameter::setNormalizedValue(float value, unsigned int offset) {
+		gen()->setNormalizedValue(value, offset);
 		return(*this);
 	}
 
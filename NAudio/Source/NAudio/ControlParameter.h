@@ -88,7 +88,7 @@ namespace NAudio {
 			}
 
 			void
-			setNormalizedValue(float normVal);
+			setNormalizedValue(float normVal, unsigned int offset = 0);
 
 			float
 			getNormalizedValue();
@@ -112,8 +112,9 @@ namespace NAudio {
 		float
 		getValue();
 
+		//offset is the frame within the next block at which the change takes effect (see ControlValue_::setValue).
 		ControlParameter&
-		value(float value);
+		value(float value, unsigned int offset = 0);
 
 		float
 		getMin();
@@ -144,6 +145,6 @@ namespace NAudio {
 		getNormalizedValue();
 
 		ControlParameter&
-		setNormalizedValue(float value);
+		setNormalizedValue(float value, unsigned int offset = 0);
 	};
 }
\ No newline at end of file
@@ -47,6 +47,7 @@ namespace NAudio {
 				state_ = ControlPulseStateOn;
 				lastOnTime_ = context.elapsedTime;
 				output_.triggered = true;
+				output_.offset = tickIn.offset;
 				output_.value = 1.0f;
 			}
 			else if(state_ == ControlPulseStateOn) {
@@ -56,6 +57,7 @@ namespace NAudio {
 					state_ = ControlPulseStateOff;
 					output_.value = 0.0f;
 					output_.triggered = true;
+					output_.offset = 0;
 				}
 			}
 		}
@@ -1,11 +1,14 @@
 #pragma once
 
 #include "ControlConditioner.h"
+#include "RandomUtils.h"
 
 namespace NAudio {
 	namespace NAudio_DSP {
 		class ControlRandom_ : public ControlGenerator_ {
 		private:
+			Xoshiro128 random_;
+
 			void
 			computeOutput(const SynthesisContext_& context);
 
@@ -30,6 +33,11 @@ namespace NAudio {
 			setTrigger(ControlGenerator arg) {
 				trigger = arg;
 			}
+
+			void
+			setSeed(unsigned long long seed) {
+				random_.seed(seed);
+			}
 		};
 		
 		inline void
@@ -39,9 +47,12 @@ namespace NAudio {
 
 			bool outInRange = (output_.value >= minOut.value) && (output_.value <= maxOut.value);
 
-			if(!outInRange || trigger.tick(context).triggered) {
+			ControlGeneratorOutput triggerOut = trigger.tick(context);
+
+			if(!outInRange || triggerOut.triggered) {
 				output_.triggered = true;
-				output_.value = NRNG::GetInstance()->GetFloat(minOut.value, maxOut.value);
+				output_.offset = triggerOut.triggered ? triggerOut.offset : 0u;
+				output_.value = random_.getFloat(minOut.value, maxOut.value);
 			}
 			else {
 				output_.triggered = false;
@@ -54,5 +65,12 @@ namespace NAudio {
 		NAUDIO_MAKE_CTRL_GEN_SETTERS(ControlRandom, max, setMax)
 		NAUDIO_MAKE_CTRL_GEN_SETTERS(ControlRandom, min, setMin)
 		NAUDIO_MAKE_CTRL_GEN_SETTERS(ControlRandom, trigger, setTrigger)
+
+		//Restart the random values from seed.
+		ControlRandom&
+		seed(unsigned long long seed) {
+			gen()->setSeed(seed);
+			return(*this);
+		}
 	};
 }
\ No newline at end of file
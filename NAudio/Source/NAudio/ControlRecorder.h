@@ -39,6 +39,10 @@ namespace NAudio {
 		inline void
 		ControlRecorder_::computeOutput(const SynthesisContext_& context) {
 			ControlGeneratorOutput inputOut = input_.tick(context);
+
+			//Recordings outlive the input's list of changes, only its last change is kept.
+			inputOut.events = NULL;
+
 			ControlGeneratorOutput modeOut = mode.tick(context);
 
 			ControlRecorder::Mode currentMode = (ControlRecorder::Mode)((int)modeOut.value);
@@ -25,8 +25,10 @@ namespace NAudio {
 		ControlSnapToScale_::computeOutput(const SynthesisContext_& context) {
 			static const int NOTES_PER_OCTAVE = 12;
 
-			if(input_.tick(context).triggered) {
-				float number = input_.tick(context).value;
+			ControlGeneratorOutput inputOut = input_.tick(context);
+
+			if(inputOut.triggered) {
+				float number = inputOut.value;
 
 				int octave = (int)(number / NOTES_PER_OCTAVE);
 
@@ -36,6 +38,7 @@ namespace NAudio {
 				if(output_.value != snappedValue) {
 					output_.value = snappedValue;
 					output_.triggered = true;
+					output_.offset = inputOut.offset;
 				}
 				else {
 					output_.triggered = false;
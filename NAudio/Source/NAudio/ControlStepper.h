@@ -56,7 +56,10 @@ namespace NAudio {
 
 			bool bi = (bidirectional.tick(context).value) ? true : false;
 
-			output_.triggered = trigger.tick(context).triggered;
+			ControlGeneratorOutput triggerOut = trigger.tick(context);
+
+			output_.triggered = triggerOut.triggered;
+			output_.offset = triggerOut.offset;
 
 			if(hasBeenTriggered) {
 				if(output_.triggered) {
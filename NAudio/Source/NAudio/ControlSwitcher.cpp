@@ -41,6 +41,9 @@ namespace NAudio {
 
 					if(index++ == cleanedInput) {
 						output_ = tempOut;
+
+						//The value may be moved up an octave below, which the input's list of changes would not follow.
+						output_.events = NULL;
 					}
 				}
 
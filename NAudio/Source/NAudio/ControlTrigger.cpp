@@ -8,14 +8,15 @@ namespace NAudio {
 		}
 
 		void
-		ControlTrigger_::trigger(float value) {
+		ControlTrigger_::trigger(float value, unsigned int offset) {
 			doTrigger = true;
+			pending_.add(value, offset);
 			output_.value = value;
 		}
 	} 
 
 	void
-	ControlTrigger::trigger(float value) {
-		gen()->trigger(value);
+	ControlTrigger::trigger(float value, unsigned int offset) {
+		gen()->trigger(value, offset);
 	}
 }
\ No newline at end of file
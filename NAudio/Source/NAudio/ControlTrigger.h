@@ -8,6 +8,10 @@ namespace NAudio {
 		protected:
 			bool doTrigger;
 
+			//Triggers for the next block, and the ones reported for the current block.
+			ControlEventList_ pending_;
+			ControlEventList_ events_;
+
 			void
 			computeOutput(const SynthesisContext_& context);
 
@@ -15,20 +19,35 @@ namespace NAudio {
 			ControlTrigger_();
 
 			void
-			trigger(float value);
+			trigger(float value, unsigned int offset);
 		};
 
 		inline void
 		ControlTrigger_::computeOutput(const SynthesisContext_& context) {
 			output_.triggered = doTrigger;
+			output_.offset = 0;
+			output_.events = NULL;
+			output_.nEvents = 0;
 			doTrigger = false;
+
+			//Triggers past the end of the block happen at its start.
+			events_.clear();
+
+			for(unsigned int i = 0; i < pending_.size(); ++i) {
+				events_.add(pending_[i].value, pending_[i].offset < context.blockSize ? pending_[i].offset : 0u);
+			}
+
+			pending_.clear();
+			events_.report(output_);
 		}
 	}
 
 	//Status changes to ControlGeneratorStatusHasChanged when trigger is called.
 	class ControlTrigger : public TemplatedControlGenerator<NAudio_DSP::ControlTrigger_> {
 	public:
+		//offset is the frame within the next block at which the trigger happens. Only meaningful when called on the audio thread between blocks.
+		//Several triggers in one block are all reported, see ControlGeneratorOutput::events.
 		void
-		trigger(float value = 1.0f);
+		trigger(float value = 1.0f, unsigned int offset = 0);
 	};
 }
\ No newline at end of file
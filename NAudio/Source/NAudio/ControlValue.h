@@ -9,16 +9,23 @@ namespace NAudio {
 			float value_;
 			bool changed_;
 
+			//Changes set for the next block, and the ones reported for the current block.
+			ControlEventList_ pending_;
+			ControlEventList_ events_;
+
 			void
 			computeOutput(const SynthesisContext_& context);
 
 		public:
 			ControlValue_();
 			
+			//offset is the frame within the next computed block at which the change takes effect. Only meaningful when called on the audio thread between blocks.
+			//Every change set before the block is kept (up to kMaxControlEvents) and reported in frame order, see ControlGeneratorOutput::events.
 			inline void
-			setValue(float value) {
+			setValue(float value, unsigned int offset = 0) {
 				value_ = value;
 				changed_ = true;
+				pending_.add(value, offset);
 			}
             
 			//Get current value directly.
@@ -31,8 +38,24 @@ namespace NAudio {
 		inline void
 		ControlValue_::computeOutput(const SynthesisContext_& context) {
 			output_.triggered =  (changed_ || context.forceNewOutput);
+			output_.offset = 0;
+			output_.events = NULL;
+			output_.nEvents = 0;
 			changed_ = context.forceNewOutput; 
 			output_.value = value_;
+
+			//Changes past the end of the block take effect at its start.
+			events_.clear();
+
+			for(unsigned int i = 0; i < pending_.size(); ++i) {
+				events_.add(pending_[i].value, pending_[i].offset < context.blockSize ? pending_[i].offset : 0u);
+			}
+
+			pending_.clear();
+
+			//The value is the one the block ends on, whatever order the changes were set in.
+			events_.report(output_);
+			value_ = output_.value;
 		}
 	}
 	
@@ -43,8 +66,8 @@ namespace NAudio {
 		}
 		
 		ControlValue&
-		value(float value) {
-			gen()->setValue(value);
+		value(float value, unsigned int offset = 0) {
+			gen()->setValue(value, offset);
 			return(*this);
 		}
 		
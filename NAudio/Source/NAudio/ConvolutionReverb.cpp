@@ -0,0 +1,362 @@
+#include "ConvolutionReverb.h"
+#include "NAudioSIMD.h"
+
+namespace NAudio {
+	namespace NAudio_DSP {
+		//Length of ConvolutionChannel_::pending. Power of two, and longer than the furthest ahead a stage writes (one tail partition).
+		static const unsigned int kConvolutionPendingSize = 2 * kConvolutionTailPartitionSize;
+
+		PartitionedConvolver::PartitionedConvolver() :
+			partitionSize_(0), nPartitions_(0), nBins_(0), fdlHead_(0)
+		{
+		}
+
+		void
+		PartitionedConvolver::initialize(const float* ir, unsigned int stride, size_t length, unsigned int partitionSize) {
+			partitionSize_ = partitionSize;
+			nPartitions_ = (unsigned int)((length + partitionSize - 1) / partitionSize);
+			nBins_ = partitionSize + 1;
+
+			fft_.initialize(2 * partitionSize);
+
+			irReal_.assign(nPartitions_ * nBins_, 0.0f);
+			irImag_.assign(nPartitions_ * nBins_, 0.0f);
+			fdlReal_.assign(nPartitions_ * nBins_, 0.0f);
+			fdlImag_.assign(nPartitions_ * nBins_, 0.0f);
+			fdlHead_ = 0;
+
+			window_.assign(2 * partitionSize, 0.0f);
+			accReal_.assign(nBins_, 0.0f);
+			accImag_.assign(nBins_, 0.0f);
+			timeFrames_.assign(2 * partitionSize, 0.0f);
+
+			//Each partition is zero-padded to twice its size, so the circular convolution of overlap-save doesn't wrap into the kept half.
+			for(unsigned int p = 0; p < nPartitions_; ++p) {
+				std::fill(timeFrames_.begin(), timeFrames_.end(), 0.0f);
+
+				for(unsigned int i = 0; i < partitionSize && p * partitionSize + i < length; ++i) {
+					timeFrames_[i] = ir[(p * partitionSize + i) * stride];
+				}
+
+				fft_.forwardReal(&timeFrames_[0], &irReal_[p * nBins_], &irImag_[p * nBins_]);
+			}
+		}
+
+		void
+		PartitionedConvolver::process(const float* in, float* out) {
+			const unsigned int n = partitionSize_;
+
+			//Slide the window and transform it into the newest slot of the delay line.
+			memmove(&window_[0], &window_[n], sizeof(float) * n);
+			memcpy(&window_[n], in, sizeof(float) * n);
+
+			fdlHead_ = (fdlHead_ + nPartitions_ - 1) % nPartitions_;
+
+			fft_.forwardReal(&window_[0], &fdlReal_[fdlHead_ * nBins_], &fdlImag_[fdlHead_ * nBins_]);
+
+			//Partition p of the response meets the input from p partitions ago.
+			std::fill(accReal_.begin(), accReal_.end(), 0.0f);
+			std::fill(accImag_.begin(), accImag_.end(), 0.0f);
+
+			const SIMDKernels_& simd = SIMD();
+			unsigned int slot = fdlHead_;
+
+			for(unsigned int p = 0; p < nPartitions_; ++p) {
+				simd.complexMultiplyAdd(&accReal_[0], &accImag_[0], &irReal_[p * nBins_], &irImag_[p * nBins_], &fdlReal_[slot * nBins_], &fdlImag_[slot * nBins_], nBins_);
+
+				if(++slot == nPartitions_) {
+					slot = 0;
+				}
+			}
+
+			fft_.inverseReal(&accReal_[0], &accImag_[0], &timeFrames_[0]);
+
+			//The first half wrapped around, the second half is the linear convolution.
+			memcpy(out, &timeFrames_[n], sizeof(float) * n);
+		}
+
+		ConvolutionEngine_::ConvolutionEngine_() :
+			irLength_(0), headFill_(0), tailFill_(0), position_(0), hasTail_(false), tailJobStarted_(false), tailJobPending_(false), stopTailThread_(false)
+		{
+		}
+
+		ConvolutionEngine_::~ConvolutionEngine_() {
+			if(tailThread_.joinable()) {
+				stopTailThread_.store(true);
+
+				{
+					std::lock_guard<std::mutex> lock(tailMutex_);
+					tailCondition_.notify_all();
+				}
+
+				tailThread_.join();
+			}
+		}
+
+		void
+		ConvolutionEngine_::initialize(SampleTable ir, unsigned int nChannels, bool tailThread) {
+			const unsigned int stride = ir.channels();
+			const size_t length = (size_t)ir.frames();
+
+			const unsigned int headSize = kConvolutionHeadSize;
+			const unsigned int tailSize = kConvolutionTailPartitionSize;
+			const size_t tailOffset = 2 * tailSize;
+
+			irLength_ = (unsigned long)length;
+			hasTail_ = length > tailOffset;
+
+			channels_.resize(nChannels);
+
+			for(unsigned int c = 0; c < nChannels; ++c) {
+				ConvolutionChannel_& channel = channels_[c];
+				const float* data = ir.dataPointer() + Min(c, stride - 1);
+
+				channel.headTaps.assign(headSize, 0.0f);
+
+				for(unsigned int t = 0; t < headSize; ++t) {
+					const unsigned int tap = headSize - 1 - t;
+
+					if(tap < length) {
+						channel.headTaps[t] = data[tap * stride];
+					}
+				}
+
+				if(length > headSize) {
+					channel.body.initialize(data + headSize * stride, stride, Min(length, tailOffset) - headSize, headSize);
+				}
+
+				if(hasTail_) {
+					channel.tail.initialize(data + tailOffset * stride, stride, length - tailOffset, tailSize);
+
+					channel.tailFrame.assign(tailSize, 0.0f);
+					channel.tailInput.assign(tailSize, 0.0f);
+					channel.tailOutput.assign(tailSize, 0.0f);
+				}
+
+				channel.history.assign(2 * headSize - 1, 0.0f);
+				channel.pending.assign(kConvolutionPendingSize, 0.0f);
+				channel.input.assign(kMaxSynthesisBlockSize, 0.0f);
+				channel.output.assign(kMaxSynthesisBlockSize, 0.0f);
+				channel.partition.assign(headSize, 0.0f);
+			}
+
+			if(tailThread && hasTail_) {
+				tailThread_ = std::thread(&ConvolutionEngine_::tailThreadLoop, this);
+			}
+		}
+
+		void
+		ConvolutionEngine_::runTailJob() {
+			for(size_t c = 0; c < channels_.size(); ++c) {
+				channels_[c].tail.process(&channels_[c].tailInput[0], &channels_[c].tailOutput[0]);
+			}
+		}
+
+		void
+		ConvolutionEngine_::tailThreadLoop() {
+			while(true) {
+				while(!tailJobPending_.load(std::memory_order_acquire)) {
+					if(stopTailThread_.load()) {
+						return;
+					}
+
+					std::unique_lock<std::mutex> lock(tailMutex_);
+					tailCondition_.wait_for(lock, std::chrono::milliseconds(1));
+				}
+
+				runTailJob();
+
+				tailJobPending_.store(false, std::memory_order_release);
+			}
+		}
+
+		void
+		ConvolutionEngine_::headPartitionDone() {
+			const unsigned int headSize = kConvolutionHeadSize;
+			const unsigned int mask = kConvolutionPendingSize - 1;
+
+			for(size_t c = 0; c < channels_.size(); ++c) {
+				ConvolutionChannel_& channel = channels_[c];
+				const float* partition = &channel.history[headSize - 1];
+
+				//The body starts one partition into the response, so its output for this partition starts right now.
+				if(!channel.body.isEmpty()) {
+					channel.body.process(partition, &channel.partition[0]);
+
+					for(unsigned int i = 0; i < headSize; ++i) {
+						channel.pending[(position_ + i) & mask] += channel.partition[i];
+					}
+				}
+
+				if(hasTail_) {
+					memcpy(&channel.tailFrame[tailFill_], partition, sizeof(float) * headSize);
+				}
+
+				//Keep the last headSize - 1 samples for the direct taps.
+				memmove(&channel.history[0], &channel.history[headSize], sizeof(float) * (headSize - 1));
+			}
+
+			if(!hasTail_) {
+				return;
+			}
+
+			tailFill_ += headSize;
+
+			if(tailFill_ < kConvolutionTailPartitionSize) {
+				return;
+			}
+
+			tailFill_ = 0;
+
+			//The tail starts two partitions into the response. The job started one partition ago covers the next partition of output.
+			if(tailJobStarted_) {
+				while(tailJobPending_.load(std::memory_order_acquire)) {
+					std::this_thread::yield();
+				}
+
+				for(size_t c = 0; c < channels_.size(); ++c) {
+					ConvolutionChannel_& channel = channels_[c];
+
+					for(unsigned int i = 0; i < kConvolutionTailPartitionSize; ++i) {
+						channel.pending[(position_ + i) & mask] += channel.tailOutput[i];
+					}
+				}
+			}
+
+			for(size_t c = 0; c < channels_.size(); ++c) {
+				channels_[c].tailInput.swap(channels_[c].tailFrame);
+			}
+
+			tailJobStarted_ = true;
+
+			if(tailThread_.joinable()) {
+				tailJobPending_.store(true, std::memory_order_release);
+
+				//notify without the lock, the audio thread must not block on it. The thread wakes up on its own timeout if it misses it.
+				tailCondition_.notify_one();
+			}
+			else {
+				runTailJob();
+			}
+		}
+
+		void
+		ConvolutionEngine_::process(const NAudioFrames& in, NAudioFrames& out) {
+			const unsigned int nFrames = out.Frames();
+
+			if(channels_.empty()) {
+				out.Clear();
+				return;
+			}
+
+			//Blocks can be longer than the scratch buffers inside an Oversampled subgraph.
+			for(unsigned int offset = 0; offset < nFrames; offset += kMaxSynthesisBlockSize) {
+				processChunk(in, out, offset, Min(nFrames - offset, kMaxSynthesisBlockSize));
+			}
+		}
+
+		void
+		ConvolutionEngine_::processChunk(const NAudioFrames& in, NAudioFrames& out, unsigned int offset, unsigned int nFrames) {
+			const unsigned int nChannels = (unsigned int)channels_.size();
+			const unsigned int headSize = kConvolutionHeadSize;
+			const unsigned int mask = kConvolutionPendingSize - 1;
+			const SIMDKernels_& simd = SIMD();
+
+			for(unsigned int c = 0; c < nChannels; ++c) {
+				const unsigned int inChannel = Min(c, in.Channels() - 1);
+				float* input = &channels_[c].input[0];
+
+				for(unsigned int i = 0; i < nFrames; ++i) {
+					input[i] = in(offset + i, inChannel);
+				}
+			}
+
+			//Run up to each head partition boundary, where the FFT stages take the partition that just completed.
+			unsigned int done = 0;
+
+			while(done < nFrames) {
+				const unsigned int count = Min(nFrames - done, headSize - headFill_);
+
+				for(unsigned int c = 0; c < nChannels; ++c) {
+					ConvolutionChannel_& channel = channels_[c];
+					float* output = &channel.output[done];
+
+					memcpy(&channel.history[headSize - 1 + headFill_], &channel.input[done], sizeof(float) * count);
+
+					simd.fir(output, &channel.history[headFill_], &channel.headTaps[0], headSize, count);
+
+					for(unsigned int i = 0; i < count; ++i) {
+						float& pending = channel.pending[(position_ + i) & mask];
+
+						output[i] += pending;
+						pending = 0.0f;
+					}
+				}
+
+				position_ += count;
+				headFill_ += count;
+				done += count;
+
+				if(headFill_ == headSize) {
+					headPartitionDone();
+					headFill_ = 0;
+				}
+			}
+
+			for(unsigned int c = 0; c < out.Channels(); ++c) {
+				const float* output = &channels_[Min(c, nChannels - 1)].output[0];
+
+				for(unsigned int i = 0; i < nFrames; ++i) {
+					out(offset + i, c) = output[i];
+				}
+			}
+		}
+
+		ConvolutionReverb_::ConvolutionReverb_() :
+			hasImpulseResponse_(false), tailThread_(false)
+		{
+		}
+
+		void
+		ConvolutionReverb_::setImpulseResponse(SampleTable ir) {
+			if(ir.channels() != 1u && ir.channels() != 2u) {
+				LOG(NLOG_ERROR, "ConvolutionReverb expects an impulse response with 1 or 2 channels.");
+				return;
+			}
+
+			impulseResponse_ = ir;
+			hasImpulseResponse_ = true;
+
+			setIsStereoOutput(isStereoInput_ || ir.channels() == 2u);
+			rebuildEngine();
+		}
+
+		void
+		ConvolutionReverb_::setTailThread(bool tailThread) {
+			tailThread_ = tailThread;
+
+			if(hasImpulseResponse_) {
+				rebuildEngine();
+			}
+		}
+
+		void
+		ConvolutionReverb_::setIsStereoInput(bool stereo) {
+			WetDryEffect_::setIsStereoInput(stereo);
+
+			setIsStereoOutput(stereo || (hasImpulseResponse_ && impulseResponse_.channels() == 2u));
+
+			if(hasImpulseResponse_) {
+				rebuildEngine();
+			}
+		}
+
+		void
+		ConvolutionReverb_::rebuildEngine() {
+			ConvolutionEngine_* engine = new ConvolutionEngine_();
+			engine->initialize(impulseResponse_, isStereoOutput() ? 2u : 1u, tailThread_);
+
+			engine_.publish(engine);
+		}
+	}
+}
\ No newline at end of file
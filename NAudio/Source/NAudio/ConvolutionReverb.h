@@ -0,0 +1,219 @@
+#pragma once
+
+#include "Effect.h"
+#include "FFT.h"
+#include "SampleTable.h"
+#include "SwapSlot.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace NAudio {
+	//Taps of the impulse response convolved directly, sample by sample, so the reverb adds no latency. Also the partition size of the FFT stage right after them.
+	static const unsigned int kConvolutionHeadSize = 64;
+
+	//Partition size of the long tail. The tail starts at twice this many samples into the impulse response, so its result is only due one partition after its input is complete.
+	static const unsigned int kConvolutionTailPartitionSize = 1024;
+
+	namespace NAudio_DSP {
+		//Uniformly partitioned overlap-save convolution with one segment of an impulse response. This is not a Generator_ subclass and is optimized for the purposes of the ConvolutionReverb_ class.
+		class PartitionedConvolver {
+		protected:
+			FFT fft_;
+
+			unsigned int partitionSize_;
+			unsigned int nPartitions_;
+			unsigned int nBins_;
+
+			//Spectrum of every partition of the segment, back to back.
+			std::vector<float> irReal_;
+			std::vector<float> irImag_;
+
+			//Spectra of the last nPartitions_ input windows. Slot fdlHead_ is the newest.
+			std::vector<float> fdlReal_;
+			std::vector<float> fdlImag_;
+			unsigned int fdlHead_;
+
+			//Last two input partitions.
+			std::vector<float> window_;
+
+			std::vector<float> accReal_;
+			std::vector<float> accImag_;
+			std::vector<float> timeFrames_;
+
+		public:
+			PartitionedConvolver();
+
+			//Segment of length samples, read from ir every stride samples (the channel count of an interleaved table).
+			void
+			initialize(const float* ir, unsigned int stride, size_t length, unsigned int partitionSize);
+
+			bool
+			isEmpty() const {
+				return(nPartitions_ == 0);
+			}
+
+			//Take the next partitionSize samples of input and write the segment's convolution for those same input times.
+			void
+			process(const float* in, float* out);
+		};
+
+		//One channel of a ConvolutionEngine_.
+		struct ConvolutionChannel_ {
+			//First kConvolutionHeadSize taps, reversed so they line up with the history.
+			std::vector<float> headTaps;
+
+			//kConvolutionHeadSize - 1 past input samples followed by the head partition being filled.
+			std::vector<float> history;
+
+			//Taps from kConvolutionHeadSize up to twice kConvolutionTailPartitionSize, and everything after.
+			PartitionedConvolver body;
+			PartitionedConvolver tail;
+
+			//Tail input being filled, the input handed to the tail job, and the job's result.
+			std::vector<float> tailFrame;
+			std::vector<float> tailInput;
+			std::vector<float> tailOutput;
+
+			//Output of the FFT stages, by absolute frame. Read and cleared as frames go out.
+			std::vector<float> pending;
+
+			//Scratch for the input and output of up to kMaxSynthesisBlockSize frames.
+			std::vector<float> input;
+			std::vector<float> output;
+			std::vector<float> partition;
+		};
+
+		//Impulse response and convolution state for every channel. Replaced as a whole through a SwapSlot when a new impulse response is set.
+		class ConvolutionEngine_ {
+		protected:
+			std::vector<ConvolutionChannel_> channels_;
+
+			unsigned long irLength_;
+
+			//Frames into the current head partition and the current tail partition.
+			unsigned int headFill_;
+			unsigned int tailFill_;
+
+			//Absolute frame of the next output sample, wraps around the pending buffers.
+			unsigned long position_;
+
+			bool hasTail_;
+
+			//A tail job was started and its result has not been collected yet.
+			bool tailJobStarted_;
+
+			//Optional thread that runs the tail jobs.
+			std::thread tailThread_;
+			std::atomic<bool> tailJobPending_;
+			std::atomic<bool> stopTailThread_;
+			std::mutex tailMutex_;
+			std::condition_variable tailCondition_;
+
+			ConvolutionEngine_(const ConvolutionEngine_&);
+			ConvolutionEngine_& operator=(const ConvolutionEngine_&);
+
+			void
+			runTailJob();
+
+			void
+			tailThreadLoop();
+
+			//Convolve nFrames frames of in, starting at offset, into the same frames of out. nFrames is at most kMaxSynthesisBlockSize.
+			void
+			processChunk(const NAudioFrames& in, NAudioFrames& out, unsigned int offset, unsigned int nFrames);
+
+			//Called at every head partition boundary.
+			void
+			headPartitionDone();
+
+		public:
+			ConvolutionEngine_();
+			~ConvolutionEngine_();
+
+			//Build the partitions of ir for nChannels output channels. A mono impulse response is used for every channel.
+			void
+			initialize(SampleTable ir, unsigned int nChannels, bool tailThread);
+
+			unsigned long
+			getIRLength() const {
+				return(irLength_);
+			}
+
+			unsigned int
+			getNumChannels() const {
+				return((unsigned int)channels_.size());
+			}
+
+			//Convolve in into out. Channels missing from in reuse its last channel, channels missing from the engine reuse its last channel.
+			void
+			process(const NAudioFrames& in, NAudioFrames& out);
+		};
+
+		//Convolution reverb. Reproduces a real room (or any linear system) from its impulse response.
+		class ConvolutionReverb_ : public WetDryEffect_ {
+		protected:
+			SwapSlot<ConvolutionEngine_> engine_;
+
+			SampleTable impulseResponse_;
+			bool hasImpulseResponse_;
+			bool tailThread_;
+
+			//Build a new engine for the current impulse response and layout, and hand it to the audio thread.
+			void
+			rebuildEngine();
+
+			void
+			computeSynthesisBlock(const SynthesisContext_& context);
+
+		public:
+			ConvolutionReverb_();
+
+			void
+			setImpulseResponse(SampleTable ir);
+
+			void
+			setTailThread(bool tailThread);
+
+			//Overridden so a stereo input gets a stereo output.
+			void
+			setIsStereoInput(bool stereo);
+		};
+
+		inline void
+		ConvolutionReverb_::computeSynthesisBlock(const SynthesisContext_& context) {
+			engine_.update();
+
+			ConvolutionEngine_& engine = engine_.current();
+
+			engine.process(dryFrames_, outputFrames_);
+
+			//The impulse response is taken to be at the graph's rate.
+			tailLength_ = (float)engine.getIRLength() / context.sampleRate;
+		}
+	}
+
+	//Convolution reverb. Convolves its input with an impulse response loaded from a SampleTable, for example a recording of a real room.
+	//The first kConvolutionHeadSize taps are convolved directly and the rest with FFT partitions that grow with the distance into the response, so no latency is added and long responses stay cheap.
+	//The impulse response is read at the graph's sample rate, resample it beforehand if the rates differ. It is applied as is, lower wetLevel for loud responses.
+	//A stereo impulse response or a stereo input (setIsStereoInput) gives a stereo output. With both, each channel of the input goes through the same channel of the response.
+	//NOTE: SET THE IMPULSE RESPONSE FROM ONE THREAD AT A TIME. IT IS PARTITIONED ON THE CALLING THREAD AND SWAPPED IN AT THE NEXT BLOCK, WHICH RESTARTS THE REVERB.
+	class ConvolutionReverb : public TemplatedWetDryEffect<ConvolutionReverb, NAudio_DSP::ConvolutionReverb_> {
+	public:
+		ConvolutionReverb&
+		impulseResponse(SampleTable ir) {
+			gen()->setImpulseResponse(ir);
+			return(*this);
+		}
+
+		//Compute the long tail of the response on a background thread instead of the audio thread, spreading its cost over time. Off by default.
+		//The audio thread waits for the tail if the thread falls more than one tail partition behind.
+		ConvolutionReverb&
+		tailThread(bool enabled) {
+			gen()->setTailThread(enabled);
+			return(*this);
+		}
+	};
+}
\ No newline at end of file
@@ -1,8 +1,19 @@
 #include "DSPUtils.h"
+#include "FFT.h"
 
 namespace NAudio {
+	static bool
+	isFFTLength(int length) {
+		return(length >= 2 && (length & (length - 1)) == 0);
+	}
+
 	void
 	DFT(int length, float* realTimeIn, float* imagTimeIn, float* realFreqOut, float* imagFreqOut) {
+		if(isFFTLength(length)) {
+			FFT(length).forward(realTimeIn, imagTimeIn, realFreqOut, imagFreqOut);
+			return;
+		}
+
 		float sr;
 		float si;
 		float p;
@@ -24,6 +35,11 @@ namespace NAudio {
 
 	void
 	InverseDFT(int length, float* realFreqIn, float* imagFreqIn, float* realTimeOut, float* imagTimeOut) {
+		if(isFFTLength(length)) {
+			FFT(length).inverse(realFreqIn, imagFreqIn, realTimeOut, imagTimeOut);
+			return;
+		}
+
 		float sr;
 		float si;
 		float p;
@@ -70,8 +86,18 @@ namespace NAudio {
 		DFT(length, realTime, imagTime, realFreq, imagFreq);
 
 		//Calculate log of absolute value.
+		//Magnitudes are floored 100 dB below the peak. The FFT gives exact zeros where the brute force DFT left rounding noise, and the reconstruction is very sensitive to how deep those go.
+		float peak = 0.0f;
+
+		for(i = 0; i < length; ++i) {
+			realFreq[i] = cabs(realFreq[i], imagFreq[i]);
+			peak = fmaxf(peak, realFreq[i]);
+		}
+
+		const float magnitudeFloor = peak * 1e-5f;
+
 		for(i = 0; i < length; ++i) {
-			realFreq[i] = logf(cabs(realFreq[i], imagFreq[i]));
+			realFreq[i] = logf(fmaxf(realFreq[i], magnitudeFloor));
 			imagFreq[i] = 0.0f;
 		}
 
@@ -83,10 +109,10 @@ namespace NAudio {
 			realCepstrumOut[i] = realTime[i];
 		}
 
-		delete realTime;
-		delete imagTime;
-		delete realFreq;
-		delete imagFreq;
+		delete[] realTime;
+		delete[] imagTime;
+		delete[] realFreq;
+		delete[] imagFreq;
 	}
 
 	void
@@ -146,10 +172,10 @@ namespace NAudio {
 			minimumPhase[i] = realTime[i];
 		}
 
-		delete realTime;
-		delete imagTime;
-		delete realFreq;
-		delete imagFreq;
+		delete[] realTime;
+		delete[] imagTime;
+		delete[] realFreq;
+		delete[] imagFreq;
 	}
 
 	float*
@@ -164,7 +190,7 @@ namespace NAudio {
 		float* buffer2;
 		float* minBLEP;
 
-		//Use power-of-two for DFT/Cepstrum for potential future speed boost.
+		//Use power-of-two for DFT/Cepstrum, so they run on the FFT.
 		n = (zeroCrossings * 2 * overSampling) + 1;
 		m = n - 1;
 
@@ -211,8 +237,8 @@ namespace NAudio {
 			minBLEP[i] *= a;
 		}
 
-		delete buffer1;
-		delete buffer2;
+		delete[] buffer1;
+		delete[] buffer2;
 
 		return(minBLEP);
 	}
@@ -53,13 +53,13 @@ namespace NAudio {
 		}
 	}
 
-	//Discrete Fourier Transform. Non-FFT, brute force approach intended for wavetable generation.
-	//NOTE: Do not use for real-time processing.
+	//Discrete Fourier Transform. Power-of-two lengths run on the FFT, other lengths use a brute force O(n^2) loop.
+	//NOTE: Allocates. For real-time processing keep an FFT object instead.
 	void
 	DFT(int length, float* realTimeIn, float* imagTimeIn, float* realFreqOut, float* imagFreqOut);
 
-	//Inverse Discrete Fourier Transform. Non-FFT, brute force approach intended for wavetable generation.
-	//NOTE: Do not use for real-time processing.
+	//Inverse Discrete Fourier Transform. Power-of-two lengths run on the FFT, other lengths use a brute force O(n^2) loop.
+	//NOTE: Allocates. For real-time processing keep an FFT object instead.
 	void
 	InverseDFT(int length, float* realFreqIn, float* imagFreqIn, float* realTimeOut, float* imagTimeOut);
 
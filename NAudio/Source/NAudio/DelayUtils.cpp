@@ -2,25 +2,174 @@
 
 namespace NAudio {
 	DelayLine::DelayLine() :
-		lastDelayTime_(0.0f), readHead_(0.0f), writeHead_(0l),
-		isInitialized_(false), interpolates_(true)
+		isInitialized_(false), interpolation_(DelayInterpolationLinear),
+		writeHead_(0ul), mask_(0ul),
+		lastDelayTime_(-1.0f), lastDelayFixed_(0ull),
+		maxDelay_(0.0f), maxDelayFrames_(0ul), sampleRate_(NAudio::SampleRate())
 	{
 		Resize(kSynthesisBlockSize, 1u, 0.0f);
 	}
 
 	void
 	DelayLine::initialize(float maxDelay, unsigned int channels) {
-		unsigned int nFrames = (unsigned int)Max(2.0f, maxDelay * NAudio::SampleRate());
+		maxDelay_ = maxDelay;
+		maxDelayFrames_ = (unsigned long)Max(2.0f, maxDelay_ * sampleRate_);
 
-		Resize(nFrames, channels, 0.0f);
+		//Room for the maximum delay, a block written ahead of it and the frames around a cubic read.
+		unsigned long nLineFrames = 1ul;
+
+		while(nLineFrames < maxDelayFrames_ + kMaxSynthesisBlockSize + 2) {
+			nLineFrames <<= 1;
+		}
+
+		Resize(nLineFrames, channels, 0.0f);
+
+		mask_ = nLineFrames - 1;
+		writeHead_ = 0ul;
+		lastDelayTime_ = -1.0f;
+
+		allpassStates_.assign(channels, 0.0f);
 
 		isInitialized_ = true;
 	}
 
+	void
+	DelayLine::setSampleRate(float sampleRate) {
+		if(sampleRate == sampleRate_) {
+			return;
+		}
+
+		sampleRate_ = sampleRate;
+
+		if(isInitialized_) {
+			initialize(maxDelay_, nChannels);
+		}
+	}
+
 	void
 	DelayLine::clear() {
 		if(isInitialized_) {
 			memset(data, 0, size * sizeof(float));
+			std::fill(allpassStates_.begin(), allpassStates_.end(), 0.0f);
+		}
+	}
+
+	unsigned int
+	DelayLine::getFeedbackRunFrames(const float* delayTimes, unsigned int delayStride, unsigned int count) const {
+		const unsigned int nDelays = (delayStride == 0) ? 1u : count;
+
+		float shortest = delayTimes[0];
+
+		for(unsigned int i = 1; i < nDelays; ++i) {
+			shortest = Min(shortest, delayTimes[i * delayStride]);
+		}
+
+		//Cubic reads reach one frame further ahead.
+		float run = floorf(Clamp(shortest * sampleRate_, 0.0f, (float)maxDelayFrames_));
+
+		if(interpolation_ == DelayInterpolationCubic) {
+			run -= 1.0f;
+		}
+
+		return((run < 1.0f) ? 1u : Min(count, (unsigned int)run));
+	}
+
+	void
+	DelayLine::write(const float* src, unsigned int count) {
+		const unsigned int first = Min(count, (unsigned int)(nFrames - writeHead_));
+
+		memcpy(data + writeHead_ * nChannels, src, sizeof(float) * first * nChannels);
+
+		if(first < count) {
+			memcpy(data, src + first * nChannels, sizeof(float) * (count - first) * nChannels);
+		}
+	}
+
+	void
+	DelayLine::write(const float* src, unsigned int srcStride, unsigned int count, unsigned int channel) {
+		if(nChannels == 1 && srcStride == 1) {
+			write(src, count);
+			return;
+		}
+
+		for(unsigned int i = 0; i < count; ++i) {
+			data[((writeHead_ + i) & mask_) * nChannels + channel] = src[i * srcStride];
+		}
+	}
+
+	void
+	DelayLine::read(float* dst, unsigned int dstStride, const float* delayTimes, unsigned int delayStride, unsigned int count, unsigned int channel) {
+		if(delayStride != 0) {
+			for(unsigned int i = 0; i < count; ++i) {
+				dst[i * dstStride] = readAt(readPosition(i, delayToFixed(delayTimes[i * delayStride])), channel);
+			}
+
+			return;
+		}
+
+		unsigned long long position = readPosition(0, delayToFixed(delayTimes[0]));
+
+		//A fixed delay on a whole frame reads the frames as they are. The allpass still has to follow them.
+		if(interpolation_ == DelayInterpolationNone || ((unsigned int)position == 0 && interpolation_ != DelayInterpolationAllpass)) {
+			const unsigned long frame = (unsigned long)(position >> 32) & mask_;
+			const unsigned int first = Min(count, (unsigned int)(nFrames - frame));
+
+			if(nChannels == 1 && dstStride == 1) {
+				memcpy(dst, data + frame, sizeof(float) * first);
+				memcpy(dst + first, data, sizeof(float) * (count - first));
+			}
+			else {
+				const float* src = data + frame * nChannels + channel;
+
+				for(unsigned int i = 0; i < first; ++i) {
+					dst[i * dstStride] = src[i * nChannels];
+				}
+
+				src = data + channel;
+				dst += first * dstStride;
+
+				for(unsigned int i = 0; i < count - first; ++i) {
+					dst[i * dstStride] = src[i * nChannels];
+				}
+			}
+
+			return;
+		}
+
+		for(unsigned int i = 0; i < count; ++i) {
+			dst[i * dstStride] = readAt(position, channel);
+			position += 1ull << 32;
+		}
+	}
+
+	void
+	DelayLine::readAdd(float* dst, float delayTime, float gain, unsigned int count, unsigned int channel) {
+		const unsigned long long position = readPosition(0, delayToFixed(delayTime));
+		const float frac = (interpolation_ == DelayInterpolationNone) ? 0.0f : (float)(unsigned int)position * (1.0f / 4294967296.0f);
+
+		//The tap is the older frame and the one after it, each read as a whole-frame tap.
+		const unsigned long older = (unsigned long)(position >> 32) & mask_;
+		const float gains[2] = { gain * (1.0f - frac), gain * frac };
+
+		const NAudio_DSP::SIMDKernels_& simd = NAudio_DSP::SIMD();
+
+		for(unsigned int n = 0; n < 2; ++n) {
+			if(gains[n] == 0.0f) {
+				continue;
+			}
+
+			const unsigned long frame = (older + n) & mask_;
+			const unsigned int first = Min(count, (unsigned int)(nFrames - frame));
+
+			if(nChannels == 1) {
+				simd.addScaled(dst, data + frame, gains[n], first);
+				simd.addScaled(dst + first, data, gains[n], count - first);
+			}
+			else {
+				for(unsigned int i = 0; i < count; ++i) {
+					dst[i] += gains[n] * data[((frame + i) & mask_) * nChannels + channel];
+				}
+			}
 		}
 	}
 }
\ No newline at end of file
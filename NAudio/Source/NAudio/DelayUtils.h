@@ -3,73 +3,175 @@
 #include "NAudioFrames.h"
 
 namespace NAudio {
+	//How a DelayLine reads between frames.
+	typedef enum {
+		DelayInterpolationNone = 0,		//Frame at or before the read head.
+		DelayInterpolationLinear,
+		DelayInterpolationCubic,		//4-point Catmull-Rom. Reads one frame further back and one further ahead than linear.
+		DelayInterpolationAllpass		//First-order allpass. Flat magnitude, keeps a filter state per channel, best for slowly moving delays.
+	} DelayInterpolation;
+
 	//Tonicframes subclass with ability to tick in and out. Allows random-access/multi-tap/etc.
+	//The line is a power of two frames long, with room for the maximum delay plus a block written ahead of reading it. Heads are integer frames, reads are 32.32 fixed point behind the write head, so long lines keep their precision.
 	class DelayLine : public NAudioFrames {
 	private:
 		bool isInitialized_;
-		bool interpolates_;
+		DelayInterpolation interpolation_;
+
+		unsigned long writeHead_;
+		unsigned long mask_;
 
-		long writeHead_;
-		float readHead_;
+		//Fixed point delay of the last tickOut.
 		float lastDelayTime_;
+		unsigned long long lastDelayFixed_;
+
+		//Maximum delay in seconds and in frames, and the sample rate the line is sized for.
+		float maxDelay_;
+		unsigned long maxDelayFrames_;
+		float sampleRate_;
+
+		//Last output of each channel, for allpass interpolation.
+		std::vector<float> allpassStates_;
+
+		//Delay of delayTime seconds in 32.32 fixed point frames, clamped to the maximum delay.
+		inline unsigned long long
+		delayToFixed(float delayTime) const {
+			//Frames are computed in float, so delays that come out a rounding error off a whole frame land on it.
+			const float frames = Clamp(delayTime * sampleRate_, 0.0f, (float)maxDelayFrames_);
+
+			return((unsigned long long)((double)frames * 4294967296.0));
+		}
+
+		//Fixed point position of the frame offset frames after the write head, delayFixed behind it. Kept positive by starting a whole line ahead.
+		inline unsigned long long
+		readPosition(unsigned long offset, unsigned long long delayFixed) const {
+			return(((unsigned long long)(writeHead_ + nFrames + offset) << 32) - delayFixed);
+		}
+
+		//Sample of channel at a fixed point position, interpolated the current way.
+		inline float
+		readAt(unsigned long long position, unsigned int channel) {
+			const unsigned long frame = (unsigned long)(position >> 32);
+			const float* base = data + channel;
+
+			if(interpolation_ == DelayInterpolationNone) {
+				return(base[(frame & mask_) * nChannels]);
+			}
+
+			const float frac = (float)(unsigned int)position * (1.0f / 4294967296.0f);
+			const float older = base[(frame & mask_) * nChannels];
+			const float newer = base[((frame + 1) & mask_) * nChannels];
+
+			switch(interpolation_) {
+				case DelayInterpolationCubic: {
+					const float before = base[((frame - 1) & mask_) * nChannels];
+					const float after = base[((frame + 2) & mask_) * nChannels];
+
+					const float c1 = 0.5f * (newer - before);
+					const float c2 = before - 2.5f * older + 2.0f * newer - 0.5f * after;
+					const float c3 = 0.5f * (after - before) + 1.5f * (older - newer);
+
+					return(((c3 * frac + c2) * frac + c1) * frac + older);
+				}
+				case DelayInterpolationAllpass: {
+					//The newer frame is one frame closer than the older one, the allpass makes up the remaining 1 - frac frames.
+					float& state = allpassStates_[channel];
+					const float coef = frac / (2.0f - frac);
+
+					state = coef * (newer - state) + older;
+
+					return(state);
+				}
+				default:
+					return(older + frac * (newer - older));
+			}
+		}
 
 	public:
 		//Allocation parameters are binding. No post-allocation resizing or modifying channel layout (for now anyway). Samples are interleaved if allocated with multiple channels.
 		DelayLine();
 
-		//MUST be called prior to usage!
+		//MUST be called prior to usage! Also resets the line for a new channel count.
 		void
 		initialize(float maxDelay = 1.0f, unsigned int channels = 1u);
 
-		//Set whether interpolates or not.
+		//Resize the line for a graph running at sampleRate, keeping the maximum delay time. Clears the line if the rate changes.
+		//Owners call this at the start of each block with context.sampleRate. Only allocates when the rate changes.
+		void
+		setSampleRate(float sampleRate);
+
+		float
+		getMaxDelay() const {
+			return(maxDelay_);
+		}
+
+		//Set whether interpolates (linearly) or not.
 		void
 		setInterpolates(bool doesInterpolate) {
-			interpolates_ = doesInterpolate;
+			setInterpolation(doesInterpolate ? DelayInterpolationLinear : DelayInterpolationNone);
+		}
+
+		void
+		setInterpolation(DelayInterpolation interpolation) {
+			interpolation_ = interpolation;
+		}
+
+		DelayInterpolation
+		getInterpolation() const {
+			return(interpolation_);
 		}
 
 		//Zero delay line.
 		void
 		clear();
 
-		//The below functions are single-sample and very one-purposed for a reason: As a helper class this will allow the most flexibility for feedback and more complex delay structures such as comb filters, etc.
-		//Return one interpolated, delayed sample. Does not advance read/write head. NOTE: No bounds checking on channel index. Improper use will result in access outside array bounds.
-		inline float
-		tickOut(float delayTime, unsigned int channel = 0u) {
-			if(delayTime != lastDelayTime_) {
-				float dSamp = Clamp(delayTime * NAudio::SampleRate(), 0.0f, (float)nFrames);
-				readHead_ = (float)writeHead_ - dSamp;
+		//Block interface. A block is written at the write head and read relative to it, frame i of a read being delayTime seconds behind frame i of the block.
+		//Write first and read after to include the block itself (zero delay reads the input), or read first and write after for feedback.
 
-				if(readHead_ < 0) {
-					readHead_ += (float)nFrames;
-				}
+		//Most frames that can be written ahead of reading them. Longer blocks must be split.
+		unsigned long
+		getWriteAheadFrames() const {
+			return(nFrames - maxDelayFrames_ - 2);
+		}
 
-				lastDelayTime_ = delayTime;
-			}
+		//Most frames of a run that is read before it is written, so no frame of the run reads a frame the run itself writes. At least 1.
+		//delayTimes is read every delayStride samples, 0 for a fixed delay.
+		unsigned int
+		getFeedbackRunFrames(const float* delayTimes, unsigned int delayStride, unsigned int count) const;
 
-			if(interpolates_) {
-				//Fractional and integral part of read head.
-				float fidx;
-				float frac = modff(readHead_, &fidx);
+		//Write count interleaved frames with all channels of the line. Does not advance the write head.
+		void
+		write(const float* src, unsigned int count);
 
-				int idx_a = ((int)fidx * nChannels + channel);
-				
-				//This happens occasionally due to floating point rounding.
-				if(idx_a >= (int)size) {
-					idx_a -= (int)size;
-				}
+		//Write count samples of one channel, read every srcStride samples. Does not advance the write head.
+		void
+		write(const float* src, unsigned int srcStride, unsigned int count, unsigned int channel);
 
-				int idx_b = idx_a + nChannels;
+		//Read count samples of channel into dst, every dstStride samples, at delays read every delayStride samples (0 for a fixed delay).
+		//Fixed delays that land on a whole frame, or don't interpolate, are straight copies.
+		void
+		read(float* dst, unsigned int dstStride, const float* delayTimes, unsigned int delayStride, unsigned int count, unsigned int channel = 0u);
 
-				if(idx_b >= (int)size) {
-					idx_b -= (int)size;
-				}
+		//Add gain times count samples of channel, delayTime seconds behind, into dst. Interpolates linearly unless interpolation is off, for multi-tap lines.
+		void
+		readAdd(float* dst, float delayTime, float gain, unsigned int count, unsigned int channel = 0u);
 
-				//Linear interpolation.
-				return(data[idx_a] + frac * (data[idx_b] - data[idx_a]));
-			}
-			else {
-				return((data[((int)(readHead_)) * nChannels + channel]));
+		//Advance the write head by count frames.
+		inline void
+		advance(unsigned int count) {
+			writeHead_ = (writeHead_ + count) & mask_;
+		}
+
+		//The below functions are single-sample and very one-purposed for a reason: As a helper class this will allow the most flexibility for feedback and more complex delay structures such as comb filters, etc.
+		//Return one interpolated, delayed sample. Does not advance read/write head. NOTE: No bounds checking on channel index. Improper use will result in access outside array bounds.
+		inline float
+		tickOut(float delayTime, unsigned int channel = 0u) {
+			if(delayTime != lastDelayTime_) {
+				lastDelayFixed_ = delayToFixed(delayTime);
+				lastDelayTime_ = delayTime;
 			}
+
+			return(readAt(readPosition(0, lastDelayFixed_), channel));
 		}
 
 		//Tick one sample in (write at write head). Does not advance read/write head. NOTE: No bounds checking on channel index. Improper use will result in access outside array bounds.
@@ -81,16 +183,22 @@ namespace NAudio {
 		//Advance read/write heads.
 		inline void
 		advance() {
-			if(++writeHead_ >= (long)nFrames) {
-				writeHead_ = 0;
-			}
+			writeHead_ = (writeHead_ + 1) & mask_;
+		}
+	};
 
-			//Assume read head advances by 1 for efficiency in constant-delay lines.
-			readHead_ += 1.0f;
+	//Seconds until the output of a delay with feedback falls floorDb below the last sample fed into it. Negative if the feedback never dies out.
+	inline static float
+	feedbackDelayTail(float delayTime, float feedback, float floorDb) {
+		float gain = fabsf(feedback);
 
-			if(readHead_ >= nFrames) {
-				readHead_ -= (float)nFrames;
-			}
+		if(gain >= 1.0f) {
+			return(-1.0f);
 		}
-	};
+
+		//Number of echoes after the first one that are still above the floor.
+		float repeats = (gain > 0.0f) ? ceilf(floorDb / LinTodB(gain)) : 0.0f;
+
+		return(delayTime * (1.0f + repeats));
+	}
 }
\ No newline at end of file
@@ -3,6 +3,9 @@
 #include "Generator.h"
 
 namespace NAudio {
+	//Level, relative to the input, below which an effect's tail counts as finished.
+	static const float kEffectTailFloorDb = -100.0f;
+
 	namespace NAudio_DSP {
 		class Effect_ : public Generator_ {
 		protected:
@@ -12,6 +15,17 @@ namespace NAudio {
 
 			bool isStereoInput_;
 
+			//How long, in seconds, the output can keep sounding after the input goes silent, for the current settings. Negative if unknown, which is the default.
+			//Subclasses with a known tail keep it up to date in computeSynthesisBlock(). Once the input has been silent for longer, blocks are not computed.
+			float tailLength_;
+
+			//Frames of silent input since the input last had sound in it. Stops counting once the tail has ended.
+			unsigned long silentInputFrames_;
+
+			//Call once per block. Returns true if the input has been silent for longer than the tail, so the output block is silent and needs no computing.
+			bool
+			tailHasEnded(bool inputIsSilent, const SynthesisContext_& context);
+
 		public:
 			Effect_();
 
@@ -33,50 +47,92 @@ namespace NAudio {
 				return(isStereoInput_);
 			}
 
-			virtual void
-			tick(NAudioFrames& frames, const SynthesisContext_& context);
+			virtual const NAudioFrames&
+			tickView(const SynthesisContext_& context);
 
 			//Apply effect directly to passed in frames (output in-place). Do NOT mix calls to tick() with calls to tickThrough().
 			virtual void
 			tickThrough(NAudioFrames& inFrames, NAudioFrames& outFrames, const SynthesisContext_& context);
+
+			//Same as tickThrough(), for callers that know whether inFrames is silent. Skips the block once the tail has ended. Returns true if outFrames is silent.
+			bool
+			tickThroughWithSilence(NAudioFrames& inFrames, NAudioFrames& outFrames, const SynthesisContext_& context, bool inputIsSilent);
 		};
 
+		inline bool
+		Effect_::tailHasEnded(bool inputIsSilent, const SynthesisContext_& context) {
+			if(!inputIsSilent) {
+				silentInputFrames_ = 0ul;
+				return(false);
+			}
+
+			if(tailLength_ < 0.0f) {
+				return(false);
+			}
+
+			if((float)silentInputFrames_ >= tailLength_ * context.sampleRate) {
+				return(true);
+			}
+
+			silentInputFrames_ += context.blockSize;
+
+			return(false);
+		}
+
 		inline void
 		Effect_::setIsStereoInput(bool stereo) {
 			if(stereo != isStereoInput_) {
-				dryFrames_.Resize(kSynthesisBlockSize, stereo ? 2u : 1u, 0.0f);
+				dryFrames_.Resize(dryFrames_.Frames(), stereo ? 2u : 1u, 0.0f);
 			}
 
 			isStereoInput_ = stereo;
 		}
 
-		//Overridden tick - pre-ticks input to fill dryFrames_. Subclasses don't need to tick input, dryFrames_ contains "dry" input by the time. computeSynthesisBlock() is called.
-		inline void
-		Effect_::tick(NAudioFrames& frames, const SynthesisContext_& context) {
+		//Overridden tickView - pre-ticks input to fill dryFrames_. Subclasses don't need to tick input, dryFrames_ contains "dry" input by the time. computeSynthesisBlock() is called.
+		inline const NAudioFrames&
+		Effect_::tickView(const SynthesisContext_& context) {
 			//Check context to see if we need new frames.
 			if(context.elapsedFrames == 0 || lastFrameIndex_ != context.elapsedFrames) {
 				//Get dry input frames.
+				const bool resized = resizeOutput(context);
 				input_.tick(dryFrames_, context);
-				computeSynthesisBlock(context);
 
-				//Bypass processing - still need to compute block so all generators stay in sync.
-				if(bypassGen_.tick(context).value != 0.0f) {
-					outputFrames_.Copy(dryFrames_);
+				//Input has been silent for longer than the tail, nothing left to compute. Bypassing would also output silence.
+				outputIsSilent_ = tailHasEnded(input_.isSilent(), context);
+
+				if(!resized) {
+					//Out of memory, outputBlock() stands in silence for this block.
+					outputIsSilent_ = true;
+					bypassGen_.tick(context);
+				}
+				else if(outputIsSilent_) {
+					outputFrames_.Clear();
+					bypassGen_.tick(context);
+				}
+				else {
+					computeSynthesisBlock(context);
+
+					//Bypass processing - still need to compute block so all generators stay in sync.
+					if(bypassGen_.tick(context).value != 0.0f) {
+						outputFrames_.Copy(dryFrames_);
+					}
 				}
 
 				lastFrameIndex_ = context.elapsedFrames;
 			}
 
-			frames.Copy(outputFrames_);
-
-			if(!isfinite(frames(0, 0u))) {
+			if(!isfinite(outputFrames_(0, 0u))) {
 				LOG(NLOG_ERROR, "NaN or inf detected.");
 			}
+
+			return(outputBlock(context));
 		}
 
 		inline void
 		Effect_::tickThrough(NAudioFrames& inFrames, NAudioFrames& outFrames, const SynthesisContext_& context) {
 			//Do not check context here, assume each call should produce new output.
+			outputFrames_.Resize(inFrames.Frames(), outputFrames_.Channels());
+			dryFrames_.Resize(inFrames.Frames(), dryFrames_.Channels());
 			dryFrames_.Copy(inFrames);
 			computeSynthesisBlock(context);
 
@@ -88,6 +144,19 @@ namespace NAudio {
 				outFrames.Copy(outputFrames_);
 			}
 		}
+
+		inline bool
+		Effect_::tickThroughWithSilence(NAudioFrames& inFrames, NAudioFrames& outFrames, const SynthesisContext_& context, bool inputIsSilent) {
+			if(tailHasEnded(inputIsSilent, context)) {
+				outFrames.Resize(inFrames.Frames(), outFrames.Channels());
+				outFrames.Clear();
+				return(true);
+			}
+
+			tickThrough(inFrames, outFrames, context);
+
+			return(false);
+		}
 	}
 
 	template<class EffectType, class EffectType_>
@@ -110,6 +179,12 @@ namespace NAudio {
 			this->gen()->tickThrough(inFrames, outFrames, context);
 		}
 
+		//In-place tickThrough that skips the block once inFrames has been silent for longer than the effect's tail. Returns true if the output is silent.
+		bool
+		tickThrough(NAudioFrames& inFrames, const NAudio_DSP::SynthesisContext_& context, bool inputIsSilent) {
+			return(this->gen()->tickThroughWithSilence(inFrames, inFrames, context, inputIsSilent));
+		}
+
 		void
 		setIsStereoInput(bool isStereoInput) {
 			this->gen()->setIsStereoInput(isStereoInput);
@@ -132,7 +207,10 @@ namespace NAudio {
 		protected:
 			Generator dryLevelGen_;
 			Generator wetLevelGen_;
-			NAudioFrames mixWorkspace_;
+
+			//Scale outputFrames_ and dryFrames_ by the wet and dry levels and sum them into outputFrames_.
+			void
+			mixWetAndDry(const SynthesisContext_& context);
 
 		public:
 			WetDryEffect_();
@@ -147,49 +225,84 @@ namespace NAudio {
 				wetLevelGen_ = gen;
 			}
 
-			virtual void tick(NAudioFrames& frames, const SynthesisContext_& context);
+			virtual const NAudioFrames& tickView(const SynthesisContext_& context);
 
 			//Apply effect directly to passed in frames (output in-place). Do NOT mix calls to tick() with calls to tickThrough().
 			virtual void tickThrough(NAudioFrames& inFrames, NAudioFrames& outFrames, const SynthesisContext_& context);
 		};
 		
-		//Overridden tick, pre-ticks input to fill dryFrames_. Subclasses don't need to tick input, dryFrames_ contains "dry" input by the time. computeSynthesisBlock() is called.
 		inline void
-		WetDryEffect_::tick(NAudioFrames& frames, const SynthesisContext_& context) {
+		WetDryEffect_::mixWetAndDry(const SynthesisContext_& context) {
+			const NAudioFrames& wetLevel = wetLevelGen_.tickView(context);
+			const NAudioFrames& dryLevel = dryLevelGen_.tickView(context);
+
+			//Levels are almost always fixed, those scale by a single value.
+			if(wetLevelGen_.isConstant()) {
+				outputFrames_ *= wetLevel(0, 0u);
+			}
+			else {
+				outputFrames_ *= wetLevel;
+			}
+
+			if(dryLevelGen_.isConstant()) {
+				dryFrames_ *= dryLevel(0, 0u);
+			}
+			else {
+				dryFrames_ *= dryLevel;
+			}
+
+			outputFrames_ += dryFrames_;
+		}
+
+		//Overridden tickView, pre-ticks input to fill dryFrames_. Subclasses don't need to tick input, dryFrames_ contains "dry" input by the time. computeSynthesisBlock() is called.
+		inline const NAudioFrames&
+		WetDryEffect_::tickView(const SynthesisContext_& context) {
 			//Check context to see if we need new frames.
 			if(context.elapsedFrames == 0 || lastFrameIndex_ != context.elapsedFrames) {
 				//Get dry input frames.
+				const bool resized = resizeOutput(context);
 				input_.tick(dryFrames_, context);
-				computeSynthesisBlock(context);
 
-				//Bypass processing - still need to compute block so all generators stay in sync.
-				if(bypassGen_.tick(context).value != 0.0f) {
-					outputFrames_.Copy(dryFrames_);
+				//Input has been silent for longer than the tail, so both the wet and the dry signal are silent.
+				outputIsSilent_ = tailHasEnded(input_.isSilent(), context);
+
+				if(!resized) {
+					//Out of memory, outputBlock() stands in silence for this block.
+					outputIsSilent_ = true;
+					bypassGen_.tick(context);
+				}
+				else if(outputIsSilent_) {
+					outputFrames_.Clear();
+					bypassGen_.tick(context);
 				}
 				else {
-					//Do not apply dry/wet levels if wet flag is set, offers minor CPU usage optimization.
-					wetLevelGen_.tick(mixWorkspace_, context);
-					outputFrames_ *= mixWorkspace_;
-					dryLevelGen_.tick(mixWorkspace_, context);
-					dryFrames_ *= mixWorkspace_;
-
-					outputFrames_ += dryFrames_;
+					computeSynthesisBlock(context);
+
+					//Bypass processing - still need to compute block so all generators stay in sync.
+					if(bypassGen_.tick(context).value != 0.0f) {
+						outputFrames_.Copy(dryFrames_);
+					}
+					else {
+						//Do not apply dry/wet levels if wet flag is set, offers minor CPU usage optimization.
+						mixWetAndDry(context);
+					}
 				}
 
 				lastFrameIndex_ = context.elapsedFrames;
 			}
 
-			//Copy synthesis block to frames passed in.
-			frames.Copy(outputFrames_);
-
-			if(!isfinite(frames(0, 0u))) {
+			if(!isfinite(outputFrames_(0, 0u))) {
 				LOG(NLOG_ERROR, "NaN or inf detected.");
 			}
+
+			return(outputBlock(context));
 		}
 
 		inline void
 		WetDryEffect_::tickThrough(NAudioFrames& inFrames, NAudioFrames& outFrames, const SynthesisContext_& context) {
 			//Do not check context here, assume each call should produce new output.
+			outputFrames_.Resize(inFrames.Frames(), outputFrames_.Channels());
+			dryFrames_.Resize(inFrames.Frames(), dryFrames_.Channels());
 			dryFrames_.Copy(inFrames);
 			computeSynthesisBlock(context);
 
@@ -198,12 +311,7 @@ namespace NAudio {
 				outFrames.Copy(dryFrames_);
 			}
 			else {
-				wetLevelGen_.tick(mixWorkspace_, context);
-				outputFrames_ *= mixWorkspace_;
-				dryLevelGen_.tick(mixWorkspace_, context);
-				dryFrames_ *= mixWorkspace_;
-
-				outputFrames_ += dryFrames_;
+				mixWetAndDry(context);
 				outFrames.Copy(outputFrames_);
 			}
 		}
@@ -229,6 +337,12 @@ namespace NAudio {
 			this->gen()->tickThrough(inFrames, outFrames, context);
 		}
 
+		//In-place tickThrough that skips the block once inFrames has been silent for longer than the effect's tail. Returns true if the output is silent.
+		bool
+		tickThrough(NAudioFrames& inFrames, const NAudio_DSP::SynthesisContext_& context, bool inputIsSilent) {
+			return(this->gen()->tickThroughWithSilence(inFrames, inFrames, context, inputIsSilent));
+		}
+
 		void
 		setIsStereoInput(bool isStereoInput) {
 			this->gen()->setIsStereoInput(isStereoInput);
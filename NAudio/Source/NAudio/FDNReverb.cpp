@@ -0,0 +1,227 @@
+#include "FDNReverb.h"
+#include "NAudioSIMD.h"
+
+//Length of the shortest line at the smallest and largest room size, in seconds. The longest line is NAUDIO_FDN_LINE_SPREAD times as long.
+#define NAUDIO_FDN_MIN_SHORTEST			0.008f
+#define NAUDIO_FDN_MAX_SHORTEST			0.033f
+#define NAUDIO_FDN_LINE_SPREAD			3.0f
+
+//Shortest high frequency decay, relative to the decay time.
+#define NAUDIO_FDN_MIN_HF_RATIO			0.05f
+
+//Modulation rates of the lines spread this far around the modulation rate.
+#define NAUDIO_FDN_MOD_RATE_SPREAD		0.4f
+
+namespace NAudio {
+	namespace NAudio_DSP {
+		//Signs the input enters the lines with. Irregular, so the input isn't one row of the Hadamard matrix, which would put it all in one line after the first mix.
+		static const float fdnInputSigns_[kFDNMaxLines] = { 1.0f, 1.0f, -1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f, -1.0f, 1.0f, -1.0f, -1.0f, 1.0f, -1.0f, -1.0f };
+
+		static bool
+		isPrime(unsigned int n) {
+			if(n < 2) {
+				return(false);
+			}
+
+			for(unsigned int d = 2; d * d <= n; ++d) {
+				if(n % d == 0) {
+					return(false);
+				}
+			}
+
+			return(true);
+		}
+
+		//Smallest prime at or above n. Prime line lengths share no common period, so their echoes don't pile up.
+		static unsigned int
+		nextPrime(unsigned int n) {
+			while(!isPrime(n)) {
+				++n;
+			}
+
+			return(n);
+		}
+
+		FDNReverb_::FDNReverb_() :
+			nLines_(0), nLineFrames_(0), writeFrame_(0), sampleRate_(0.0f)
+		{
+			setIsStereoOutput(true);
+
+			//Default to 50% wet.
+			setDryLevelGen(FixedValue(0.5f));
+			setWetLevelGen(FixedValue(0.5f));
+
+			workspaceFrames_.Resize(kSynthesisBlockSize, 1u, 0.0f);
+			preOutputFrames_[0].Resize(kSynthesisBlockSize, 1u, 0.0f);
+			preOutputFrames_[1].Resize(kSynthesisBlockSize, 1u, 0.0f);
+
+			preDelayLine_.initialize(0.1f);
+			preDelayLine_.setNumTaps(1u);
+
+			preDelayTimeCtrlGen_ = ControlValue(0.01f);
+			decayTimeCtrlGen_ = ControlValue(1.5f);
+			dampingCtrlGen_ = ControlValue(0.4f);
+			roomSizeCtrlGen_ = ControlValue(0.5f);
+			modulationRateCtrlGen_ = ControlValue(0.5f);
+			modulationDepthCtrlGen_ = ControlValue(0.0003f);
+			stereoWidthCtrlGen_ = ControlValue(0.5f);
+		}
+
+		void
+		FDNReverb_::initialize(unsigned int nLines) {
+			if(nLines != 8 && nLines != 16) {
+				LOG(NLOG_ERROR, "FDNReverb needs 8 or 16 delay lines, got %u. Using 8.", nLines);
+				nLines = 8;
+			}
+
+			nLines_ = nLines;
+
+			delayTimes_.assign(nLines_, 0.0f);
+			feedGains_.assign(nLines_, 0.0f);
+			dampCoefs_.assign(nLines_, 0.0f);
+			inGains_.assign(nLines_, 0.0f);
+			lows_.assign(nLines_, 0.0f);
+			modPhases_.assign(nLines_, 0.0f);
+			modRates_.assign(nLines_, 0.0f);
+			delayFrames_.assign(nLines_, 0.0f);
+			delaySteps_.assign(nLines_, 0.0f);
+			runFrames_.assign(kFDNMaxRunFrames * nLines_, 0.0f);
+
+			for(unsigned int l = 0; l < nLines_; ++l) {
+				const float position = (float)l / (float)(nLines_ - 1);
+
+				inGains_[l] = fdnInputSigns_[l] / sqrtf((float)nLines_);
+				modPhases_[l] = (float)l / (float)nLines_;
+				modRates_[l] = 1.0f + NAUDIO_FDN_MOD_RATE_SPREAD * (position - 0.5f);
+			}
+
+			//Lines are sized on the first block, at the graph's rate.
+			sampleRate_ = 0.0f;
+		}
+
+		void
+		FDNReverb_::resizeLines() {
+			//Room for the longest modulated delay, a run, and rounding the lengths up to primes.
+			nLineFrames_ = (unsigned int)ceilf((kFDNMaxDelayTime + kFDNMaxModulationDepth) * sampleRate_) + kFDNMaxRunFrames + 64;
+
+			lines_.assign(nLineFrames_ * nLines_, 0.0f);
+			writeFrame_ = 0;
+
+			std::fill(lows_.begin(), lows_.end(), 0.0f);
+		}
+
+		void
+		FDNReverb_::updateLines(const SynthesisContext_& context, bool force) {
+			ControlGeneratorOutput sizeOutput = roomSizeCtrlGen_.tick(context);
+			ControlGeneratorOutput decayOutput = decayTimeCtrlGen_.tick(context);
+			ControlGeneratorOutput dampingOutput = dampingCtrlGen_.tick(context);
+
+			if(!force && !sizeOutput.triggered && !decayOutput.triggered && !dampingOutput.triggered) {
+				return;
+			}
+
+			const float shortest = MapFloat(Clamp(sizeOutput.value, 0.0f, 1.0f), 0.0f, 1.0f, NAUDIO_FDN_MIN_SHORTEST, NAUDIO_FDN_MAX_SHORTEST, true);
+			const float decayTime = Max(0.01f, decayOutput.value);
+			const float highDecayTime = decayTime * Clamp(1.0f - dampingOutput.value, NAUDIO_FDN_MIN_HF_RATIO, 1.0f);
+
+			unsigned int previousFrames = 0;
+
+			for(unsigned int l = 0; l < nLines_; ++l) {
+				//Lengths spread exponentially from the shortest to the longest line, and are all different.
+				const float spread = powf(NAUDIO_FDN_LINE_SPREAD, (float)l / (float)(nLines_ - 1));
+				const unsigned int frames = nextPrime(Max((unsigned int)(shortest * spread * sampleRate_), previousFrames + 1));
+
+				previousFrames = frames;
+				delayTimes_[l] = (float)frames / sampleRate_;
+
+				//One-pole lowpass with a gain of lowGain at DC and highGain at Nyquist, so each line loses the same level per second whatever its length.
+				const float lowGain = powf(10.0f, -3.0f * delayTimes_[l] / decayTime);
+				const float highGain = powf(10.0f, -3.0f * delayTimes_[l] / highDecayTime);
+
+				dampCoefs_[l] = (lowGain - highGain) / (lowGain + highGain);
+				feedGains_[l] = lowGain * (1.0f - dampCoefs_[l]);
+
+				//Start on the new lengths instead of sweeping to them.
+				if(force) {
+					delayFrames_[l] = (float)frames;
+				}
+			}
+		}
+
+		void
+		FDNReverb_::updateModulation(const SynthesisContext_& context, unsigned int nFrames) {
+			const float rate = Max(0.0f, modulationRateCtrlGen_.tick(context).value);
+
+			//The shortest line stays well above its run length.
+			const float depth = Min(Clamp(modulationDepthCtrlGen_.tick(context).value, 0.0f, kFDNMaxModulationDepth), 0.25f * delayTimes_[0]);
+
+			const float blockTime = (float)nFrames / sampleRate_;
+
+			//Each line's delay ramps across the block to where its modulation will be at the end of it.
+			for(unsigned int l = 0; l < nLines_; ++l) {
+				modPhases_[l] += rate * modRates_[l] * blockTime;
+				modPhases_[l] -= floorf(modPhases_[l]);
+
+				const float target = (delayTimes_[l] + depth * sinf(TWO_PI * modPhases_[l])) * sampleRate_;
+
+				delaySteps_[l] = (target - delayFrames_[l]) / (float)nFrames;
+			}
+		}
+
+		void
+		FDNReverb_::runNetwork(const float* in, float* outLeft, float* outRight, unsigned int nFrames) {
+			const SIMDKernels_& simd = SIMD();
+			const unsigned int nLines = nLines_;
+
+			unsigned int done = 0;
+
+			while(done < nFrames) {
+				unsigned int count = Min(nFrames - done, Min(kFDNMaxRunFrames, nLineFrames_ - writeFrame_));
+
+				//Stop the run before any line would read a frame the run itself writes.
+				float shortest = (float)nLineFrames_;
+
+				for(unsigned int l = 0; l < nLines; ++l) {
+					shortest = Min(shortest, Min(delayFrames_[l], delayFrames_[l] + delaySteps_[l] * (float)count));
+				}
+
+				count = Min(count, (unsigned int)shortest - 1);
+
+				//Read every line at its modulated delay, interpolating linearly.
+				for(unsigned int l = 0; l < nLines; ++l) {
+					const double increment = 1.0 - (double)delaySteps_[l];
+					double readHead = (double)writeFrame_ - (double)delayFrames_[l];
+
+					for(unsigned int i = 0; i < count; ++i) {
+						const double position = (readHead < 0.0) ? readHead + (double)nLineFrames_ : readHead;
+						const unsigned int older = (unsigned int)position;
+						const unsigned int newer = (older + 1 == nLineFrames_) ? 0 : older + 1;
+						const float frac = (float)(position - (double)older);
+
+						const float a = lines_[older * nLines + l];
+						const float b = lines_[newer * nLines + l];
+
+						runFrames_[i * nLines + l] = a + frac * (b - a);
+						readHead += increment;
+					}
+
+					delayFrames_[l] += delaySteps_[l] * (float)count;
+				}
+
+				simd.fdn(&lines_[writeFrame_ * nLines], &runFrames_[0], &lows_[0], &feedGains_[0], &dampCoefs_[0], &inGains_[0], in + done, outLeft + done, outRight + done, nLines, count);
+
+				writeFrame_ += count;
+
+				if(writeFrame_ == nLineFrames_) {
+					writeFrame_ = 0;
+				}
+
+				done += count;
+			}
+		}
+	}
+
+	FDNReverb::FDNReverb(unsigned int nLines) {
+		gen()->initialize(nLines);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,199 @@
+#pragma once
+
+#include "Effect.h"
+#include "Reverb.h"
+
+namespace NAudio {
+	//Most delay lines an FDNReverb can have.
+	static const unsigned int kFDNMaxLines = 16;
+
+	//Most frames run through the network at a time. Runs are also shorter than the shortest delay, so all their reads were written before them.
+	static const unsigned int kFDNMaxRunFrames = 128;
+
+	//Longest delay of any line at the largest room size, and the largest modulation swing, in seconds.
+	static const float kFDNMaxDelayTime = 0.1f;
+	static const float kFDNMaxModulationDepth = 0.002f;
+
+	namespace NAudio_DSP {
+		//Feedback delay network reverb: 8 or 16 delay lines, mixed through a Hadamard matrix and fed back, each with its own decay gain and one-pole damping.
+		//The lines are interleaved, one frame holds a sample of every line, so a frame of the network is a handful of vector operations (see SIMDKernels_::fdn).
+		class FDNReverb_ : public WetDryEffect_ {
+		protected:
+			unsigned int nLines_;
+
+			//nLineFrames_ frames of nLines_ samples. All lines share the write frame.
+			std::vector<float> lines_;
+			unsigned int nLineFrames_;
+			unsigned int writeFrame_;
+			float sampleRate_;
+
+			//Per line settings and state.
+			std::vector<float> delayTimes_;
+			std::vector<float> feedGains_;
+			std::vector<float> dampCoefs_;
+			std::vector<float> inGains_;
+			std::vector<float> lows_;
+
+			//Modulation of each line. Phases are in cycles, rates relative to the modulation rate. delayFrames_ is the modulated delay at the start of the next block.
+			std::vector<float> modPhases_;
+			std::vector<float> modRates_;
+			std::vector<float> delayFrames_;
+			std::vector<float> delaySteps_;
+
+			//Delayed samples of one run, interleaved like the lines.
+			std::vector<float> runFrames_;
+
+			ReverbTapLine preDelayLine_;
+
+			//Signal vector workspaces.
+			NAudioFrames workspaceFrames_;
+			NAudioFrames preOutputFrames_[2];
+
+			//Input generators.
+			ControlGenerator preDelayTimeCtrlGen_;
+			ControlGenerator decayTimeCtrlGen_;
+			ControlGenerator dampingCtrlGen_;
+			ControlGenerator roomSizeCtrlGen_;
+			ControlGenerator modulationRateCtrlGen_;
+			ControlGenerator modulationDepthCtrlGen_;
+			ControlGenerator stereoWidthCtrlGen_;
+
+			//Size the lines for the current sample rate and clear them.
+			void
+			resizeLines();
+
+			//Recompute the delays and gains of the lines if the room, decay or damping changed.
+			void
+			updateLines(const SynthesisContext_& context, bool force);
+
+			//Advance the modulation by one block and set where each line's delay ramps to.
+			void
+			updateModulation(const SynthesisContext_& context, unsigned int nFrames);
+
+			//Run in through the network, writing the left and right outputs.
+			void
+			runNetwork(const float* in, float* outLeft, float* outRight, unsigned int nFrames);
+
+			void
+			computeSynthesisBlock(const SynthesisContext_& context);
+
+		public:
+			FDNReverb_();
+
+			void
+			initialize(unsigned int nLines);
+
+			void
+			setPreDelayTimeCtrlGen(ControlGenerator gen) {
+				preDelayTimeCtrlGen_ = gen;
+			}
+
+			void
+			setDecayTimeCtrlGen(ControlGenerator gen) {
+				decayTimeCtrlGen_ = gen;
+			}
+
+			void
+			setDampingCtrlGen(ControlGenerator gen) {
+				dampingCtrlGen_ = gen;
+			}
+
+			void
+			setRoomSizeCtrlGen(ControlGenerator gen) {
+				roomSizeCtrlGen_ = gen;
+			}
+
+			void
+			setModulationRateCtrlGen(ControlGenerator gen) {
+				modulationRateCtrlGen_ = gen;
+			}
+
+			void
+			setModulationDepthCtrlGen(ControlGenerator gen) {
+				modulationDepthCtrlGen_ = gen;
+			}
+
+			void
+			setStereoWidthCtrlGen(ControlGenerator gen) {
+				stereoWidthCtrlGen_ = gen;
+			}
+		};
+
+		inline void
+		FDNReverb_::computeSynthesisBlock(const SynthesisContext_& context) {
+			const unsigned int nFrames = outputFrames_.Frames();
+
+			//Follow the block size.
+			workspaceFrames_.Resize(nFrames, 1u);
+			preOutputFrames_[NAUDIO_LEFT].Resize(nFrames, 1u);
+			preOutputFrames_[NAUDIO_RIGHT].Resize(nFrames, 1u);
+
+			//Follow the sample rate.
+			preDelayLine_.setSampleRate(context.sampleRate);
+
+			const bool rateChanged = (context.sampleRate != sampleRate_);
+
+			if(rateChanged) {
+				sampleRate_ = context.sampleRate;
+				resizeLines();
+			}
+
+			updateLines(context, rateChanged);
+			updateModulation(context, nFrames);
+
+			//Pre-delay, then the network.
+			float preDelayTime = preDelayTimeCtrlGen_.tick(context).value;
+
+			preDelayLine_.setTap(0, preDelayTime, 1.0f);
+			preDelayLine_.process(&dryFrames_[0], &workspaceFrames_[0], nFrames);
+
+			runNetwork(&workspaceFrames_[0], &preOutputFrames_[NAUDIO_LEFT][0], &preOutputFrames_[NAUDIO_RIGHT][0], nFrames);
+
+			//Interleave pre-output frames into output frames.
+			float* outptr = &outputFrames_[0];
+			float* preoutptrL = &preOutputFrames_[NAUDIO_LEFT][0];
+			float* preoutptrR = &preOutputFrames_[NAUDIO_RIGHT][0];
+
+			float spreadValue = Clamp(1.0f - stereoWidthCtrlGen_.tick(context).value, 0.0f, 1.0f);
+			float normValue = (1.0f / (1.0f + spreadValue));
+
+			for(unsigned int i = 0; i < nFrames; ++i) {
+				*outptr++ = (*preoutptrL + (spreadValue * (*preoutptrR)))*normValue;
+				*outptr++ = (*preoutptrR++ + (spreadValue * (*preoutptrL++)))*normValue;
+			}
+
+			//The lines fall by 60 dB over the decay time, after the pre-delay and one trip through the longest line.
+			float decayTime = Max(0.0f, decayTimeCtrlGen_.tick(context).value);
+			tailLength_ = preDelayTime + kFDNMaxDelayTime + decayTime * (kEffectTailFloorDb / -60.0f);
+		}
+	}
+
+	//Feedback delay network reverb. Denser and much cheaper than Reverb at the same density, so many can run at once.
+	//8 lines (the default) are enough for most sounds, 16 give a smoother tail on percussive material for about twice the cost.
+	//Each line slowly modulates its delay, which keeps the tail from ringing at the lines' resonances.
+	class FDNReverb : public TemplatedWetDryEffect<FDNReverb, NAudio_DSP::FDNReverb_> {
+	public:
+		FDNReverb(unsigned int nLines = 8);
+
+		//Initial delay before passing through reverb.
+		NAUDIO_MAKE_CTRL_GEN_SETTERS(FDNReverb, preDelayTime, setPreDelayTimeCtrlGen);
+
+		//Value in seconds of the decay of low frequencies.
+		NAUDIO_MAKE_CTRL_GEN_SETTERS(FDNReverb, decayTime, setDecayTimeCtrlGen);
+
+		//Value 0-1, how much faster high frequencies decay. 0 decays all frequencies alike.
+		NAUDIO_MAKE_CTRL_GEN_SETTERS(FDNReverb, damping, setDampingCtrlGen);
+
+		//Value 0-1, scales the lengths of the delay lines.
+		NAUDIO_MAKE_CTRL_GEN_SETTERS(FDNReverb, roomSize, setRoomSizeCtrlGen);
+
+		//Value in Hz of the delay modulation. Each line runs at a slightly different rate.
+		NAUDIO_MAKE_CTRL_GEN_SETTERS(FDNReverb, modulationRate, setModulationRateCtrlGen);
+
+		//Value in seconds of the delay modulation swing, up to kFDNMaxModulationDepth. 0 turns modulation off.
+		NAUDIO_MAKE_CTRL_GEN_SETTERS(FDNReverb, modulationDepth, setModulationDepthCtrlGen);
+
+		//Value 0-1 for stereo width.
+		NAUDIO_MAKE_CTRL_GEN_SETTERS(FDNReverb, stereoWidth, setStereoWidthCtrlGen);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,299 @@
+#include "FFT.h"
+#include "NAudioSIMD.h"
+
+#include <map>
+
+namespace NAudio {
+	namespace NAudio_DSP {
+		static FFTPlan_*
+		buildFFTPlan(unsigned int size) {
+			FFTPlan_* plan = new FFTPlan_();
+			plan->size = size;
+
+			unsigned int bits = 0;
+
+			while((1u << bits) < size) {
+				++bits;
+			}
+
+			for(unsigned int i = 0; i < size; ++i) {
+				unsigned int j = 0;
+
+				for(unsigned int b = 0; b < bits; ++b) {
+					j |= ((i >> b) & 1u) << (bits - 1 - b);
+				}
+
+				if(i < j) {
+					plan->swaps.push_back(i);
+					plan->swaps.push_back(j);
+				}
+			}
+
+			//Twiddles are computed in double so large sizes stay accurate.
+			plan->twiddleReal.resize(size > 1 ? size - 1 : 0);
+			plan->twiddleImag.resize(size > 1 ? size - 1 : 0);
+
+			for(unsigned int h = 1; h < size; h <<= 1) {
+				for(unsigned int k = 0; k < h; ++k) {
+					const double angle = -3.14159265358979323846 * (double)k / (double)h;
+
+					plan->twiddleReal[h - 1 + k] = (float)cos(angle);
+					plan->twiddleImag[h - 1 + k] = (float)sin(angle);
+				}
+			}
+
+			return(plan);
+		}
+
+		const FFTPlan_*
+		fftPlan(unsigned int size) {
+			//Plans live as long as the program, like the oscillator tables.
+			struct PlanCache {
+				NAUDIO_MUTEX_T mutex;
+				std::map<unsigned int, FFTPlan_*> plans;
+
+				PlanCache() {
+					NAUDIO_MUTEX_INIT(mutex);
+				}
+			};
+
+			static PlanCache* s_planCache = new PlanCache();
+
+			NAUDIO_MUTEX_LOCK(s_planCache->mutex);
+
+			FFTPlan_*& plan = s_planCache->plans[size];
+
+			if(plan == NULL) {
+				plan = buildFFTPlan(size);
+			}
+
+			NAUDIO_MUTEX_UNLOCK(s_planCache->mutex);
+
+			return(plan);
+		}
+	}
+
+	FFT::FFT(unsigned int size) :
+		plan_(NULL), halfPlan_(NULL), size_(0)
+	{
+		if(size > 0) {
+			initialize(size);
+		}
+	}
+
+	void
+	FFT::initialize(unsigned int size) {
+		unsigned int po2 = 2;
+
+		while(po2 < size) {
+			po2 <<= 1;
+		}
+
+		if(po2 != size) {
+			LOG(NLOG_WARN, "FFT size must be a power of two of at least 2, using %u instead of %u.", po2, size);
+		}
+
+		size_ = po2;
+		plan_ = NAudio_DSP::fftPlan(size_);
+		halfPlan_ = NAudio_DSP::fftPlan(size_ / 2);
+
+		workReal_.assign(size_ / 2, 0.0f);
+		workImag_.assign(size_ / 2, 0.0f);
+	}
+
+	void
+	FFT::butterflies(const NAudio_DSP::FFTPlan_* plan, float* real, float* imag) {
+		const unsigned int n = plan->size;
+
+		if(n < 4) {
+			if(n == 2) {
+				const float r = real[1];
+				const float i = imag[1];
+
+				real[1] = real[0] - r;
+				imag[1] = imag[0] - i;
+				real[0] += r;
+				imag[0] += i;
+			}
+
+			return;
+		}
+
+		//The first two stages only have twiddles of 1 and -i, so they run together as one radix-4 pass.
+		for(unsigned int g = 0; g < n; g += 4) {
+			float* re = real + g;
+			float* im = imag + g;
+
+			const float r0 = re[0] + re[1];
+			const float i0 = im[0] + im[1];
+			const float r1 = re[0] - re[1];
+			const float i1 = im[0] - im[1];
+			const float r2 = re[2] + re[3];
+			const float i2 = im[2] + im[3];
+			const float r3 = re[2] - re[3];
+			const float i3 = im[2] - im[3];
+
+			re[0] = r0 + r2;
+			im[0] = i0 + i2;
+			re[2] = r0 - r2;
+			im[2] = i0 - i2;
+
+			//Times -i.
+			re[1] = r1 + i3;
+			im[1] = i1 - r3;
+			re[3] = r1 - i3;
+			im[3] = i1 + r3;
+		}
+
+		const NAudio_DSP::SIMDKernels_& simd = NAudio_DSP::SIMD();
+
+		for(unsigned int h = 4; h < n; h <<= 1) {
+			const float* wr = &plan->twiddleReal[h - 1];
+			const float* wi = &plan->twiddleImag[h - 1];
+
+			for(unsigned int g = 0; g < n; g += 2 * h) {
+				simd.fftButterfly(real + g, imag + g, real + g + h, imag + g + h, wr, wi, h);
+			}
+		}
+	}
+
+	void
+	FFT::transform(const NAudio_DSP::FFTPlan_* plan, const float* realIn, const float* imagIn, float* realOut, float* imagOut) {
+		const unsigned int n = plan->size;
+
+		if(realOut != realIn) {
+			memcpy(realOut, realIn, sizeof(float) * n);
+		}
+
+		if(imagOut != imagIn) {
+			memcpy(imagOut, imagIn, sizeof(float) * n);
+		}
+
+		const unsigned int* swaps = plan->swaps.empty() ? NULL : &plan->swaps[0];
+		const size_t nSwaps = plan->swaps.size();
+
+		for(size_t s = 0; s < nSwaps; s += 2) {
+			std::swap(realOut[swaps[s]], realOut[swaps[s + 1]]);
+			std::swap(imagOut[swaps[s]], imagOut[swaps[s + 1]]);
+		}
+
+		butterflies(plan, realOut, imagOut);
+	}
+
+	void
+	FFT::forward(const float* realIn, const float* imagIn, float* realOut, float* imagOut) {
+		if(plan_ == NULL) {
+			return;
+		}
+
+		transform(plan_, realIn, imagIn, realOut, imagOut);
+	}
+
+	void
+	FFT::inverse(const float* realIn, const float* imagIn, float* realOut, float* imagOut) {
+		if(plan_ == NULL) {
+			return;
+		}
+
+		//Swapping real and imaginary parts turns the forward transform into the inverse one.
+		transform(plan_, imagIn, realIn, imagOut, realOut);
+
+		const float norm = 1.0f / (float)size_;
+
+		NAudio_DSP::SIMD().scale(realOut, norm, size_);
+		NAudio_DSP::SIMD().scale(imagOut, norm, size_);
+	}
+
+	void
+	FFT::forwardReal(const float* in, float* realOut, float* imagOut) {
+		if(plan_ == NULL) {
+			return;
+		}
+
+		const unsigned int half = size_ / 2;
+
+		float* zr = &workReal_[0];
+		float* zi = &workImag_[0];
+
+		//Even samples as the real part and odd samples as the imaginary part of a half size transform.
+		for(unsigned int k = 0; k < half; ++k) {
+			zr[k] = in[2 * k];
+			zi[k] = in[2 * k + 1];
+		}
+
+		transform(halfPlan_, zr, zi, zr, zi);
+
+		//Split the result into the transforms of the even and odd samples, then combine them with exp(-2 * i * PI * k / size).
+		const float* wr = &plan_->twiddleReal[half - 1];
+		const float* wi = &plan_->twiddleImag[half - 1];
+
+		realOut[0] = zr[0] + zi[0];
+		imagOut[0] = 0.0f;
+		realOut[half] = zr[0] - zi[0];
+		imagOut[half] = 0.0f;
+
+		for(unsigned int k = 1; k <= half / 2; ++k) {
+			const unsigned int m = half - k;
+
+			const float er = 0.5f * (zr[k] + zr[m]);
+			const float ei = 0.5f * (zi[k] - zi[m]);
+			const float orr = 0.5f * (zi[k] + zi[m]);
+			const float oi = -0.5f * (zr[k] - zr[m]);
+
+			const float tr = wr[k] * orr - wi[k] * oi;
+			const float ti = wr[k] * oi + wi[k] * orr;
+
+			realOut[k] = er + tr;
+			imagOut[k] = ei + ti;
+			realOut[m] = er - tr;
+			imagOut[m] = ti - ei;
+		}
+	}
+
+	void
+	FFT::inverseReal(const float* realIn, const float* imagIn, float* out) {
+		if(plan_ == NULL) {
+			return;
+		}
+
+		const unsigned int half = size_ / 2;
+
+		float* zr = &workReal_[0];
+		float* zi = &workImag_[0];
+
+		const float* wr = &plan_->twiddleReal[half - 1];
+		const float* wi = &plan_->twiddleImag[half - 1];
+
+		//Undo the split of forwardReal to get back the half size transform.
+		zr[0] = 0.5f * (realIn[0] + realIn[half]);
+		zi[0] = 0.5f * (realIn[0] - realIn[half]);
+
+		for(unsigned int k = 1; k <= half / 2; ++k) {
+			const unsigned int m = half - k;
+
+			const float er = 0.5f * (realIn[k] + realIn[m]);
+			const float ei = 0.5f * (imagIn[k] - imagIn[m]);
+			const float dr = 0.5f * (realIn[k] - realIn[m]);
+			const float di = 0.5f * (imagIn[k] + imagIn[m]);
+
+			//Times the conjugate twiddle.
+			const float orr = dr * wr[k] + di * wi[k];
+			const float oi = di * wr[k] - dr * wi[k];
+
+			zr[k] = er - oi;
+			zi[k] = ei + orr;
+			zr[m] = er + oi;
+			zi[m] = orr - ei;
+		}
+
+		//Inverse through the swapped forward transform, scaled by 1 / half.
+		transform(halfPlan_, zi, zr, zi, zr);
+
+		const float norm = 1.0f / (float)half;
+
+		for(unsigned int k = 0; k < half; ++k) {
+			out[2 * k] = zr[k] * norm;
+			out[2 * k + 1] = zi[k] * norm;
+		}
+	}
+}
\ No newline at end of file
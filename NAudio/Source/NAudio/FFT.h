@@ -0,0 +1,88 @@
+#pragma once
+
+#include "NAudioCore.h"
+
+#include <vector>
+
+namespace NAudio {
+	namespace NAudio_DSP {
+		//Bit-reversal permutation and twiddle factors for one power-of-two FFT size. Shared by every FFT of that size and never freed.
+		struct FFTPlan_ {
+			unsigned int size;
+
+			//Pairs (i, j) with i < j to swap for the bit-reversal permutation.
+			std::vector<unsigned int> swaps;
+
+			//Twiddles of every stage back to back. The stage with butterflies of span h starts at h - 1 and holds exp(-i * PI * k / h) for k < h.
+			//The last stage's twiddles are exp(-2 * i * PI * k / size), which the real transforms reuse.
+			std::vector<float> twiddleReal;
+			std::vector<float> twiddleImag;
+		};
+
+		//Plan for a power-of-two size, built the first time it is asked for. Thread-safe.
+		const FFTPlan_*
+		fftPlan(unsigned int size);
+	}
+
+	//Power-of-two FFT on split complex data (separate real and imaginary arrays).
+	//Plans are cached per size, so creating an FFT is cheap once a size has been used. Transforms don't allocate and can run on the audio thread.
+	//Input and output may be the same arrays for in-place transforms. Inverse transforms are scaled by 1 / size, like InverseDFT.
+	class FFT {
+	protected:
+		const NAudio_DSP::FFTPlan_* plan_;
+
+		//Plan of half the size, used by the real transforms.
+		const NAudio_DSP::FFTPlan_* halfPlan_;
+
+		unsigned int size_;
+
+		//Scratch for the real transforms.
+		std::vector<float> workReal_;
+		std::vector<float> workImag_;
+
+		//Run the butterflies on data that is already in bit-reversed order.
+		void
+		butterflies(const NAudio_DSP::FFTPlan_* plan, float* real, float* imag);
+
+		//Copy (or permute in place) into bit-reversed order and transform.
+		void
+		transform(const NAudio_DSP::FFTPlan_* plan, const float* realIn, const float* imagIn, float* realOut, float* imagOut);
+
+	public:
+		FFT(unsigned int size = 0);
+
+		//Set the transform size. Must be a power of two, other sizes are rounded up.
+		void
+		initialize(unsigned int size);
+
+		unsigned int
+		size() const {
+			return(size_);
+		}
+
+		//Complex transforms of size() points.
+		void
+		forward(const float* realIn, const float* imagIn, float* realOut, float* imagOut);
+
+		void
+		inverse(const float* realIn, const float* imagIn, float* realOut, float* imagOut);
+
+		void
+		forward(float* real, float* imag) {
+			forward(real, imag, real, imag);
+		}
+
+		void
+		inverse(float* real, float* imag) {
+			inverse(real, imag, real, imag);
+		}
+
+		//Transform size() real samples into the size() / 2 + 1 bins from DC to Nyquist. Runs a complex FFT of half the size.
+		void
+		forwardReal(const float* in, float* realOut, float* imagOut);
+
+		//Rebuild size() real samples from the size() / 2 + 1 bins from DC to Nyquist. The imaginary parts of DC and Nyquist are ignored.
+		void
+		inverseReal(const float* realIn, const float* imagIn, float* out);
+	};
+}
\ No newline at end of file
@@ -1,11 +1,214 @@
 #include "FilterUtils.h"
+#include "NAudioSIMD.h"
 
 namespace NAudio {
 
-	Biquad::Biquad() {
-		memset(coef_, 0, 5 * sizeof(float));
+	BiquadCascade::BiquadCascade(unsigned int nStages) :
+		nStages_(1), nChannels_(1), interpolates_(false), primed_(false)
+	{
+		memset(stageCoef_, 0, sizeof(stageCoef_));
+		memset(coef_, 0, sizeof(coef_));
+		memset(coefStep_, 0, sizeof(coefStep_));
 
-		inputVec_.Resize(kSynthesisBlockSize + 4, 1u, 0.0f);
-		outputVec_.Resize(kSynthesisBlockSize + 4, 1u, 0.0f);
+		setNumStages(nStages);
+	}
+
+	void
+	BiquadCascade::setNumStages(unsigned int nStages) {
+		if(nStages < 1 || nStages * nChannels_ > kBiquadMaxLanes) {
+			LOG(NLOG_ERROR, "A biquad cascade runs at most %u biquads, got %u stages of %u channels.", kBiquadMaxLanes, nStages, nChannels_);
+			nStages = Clamp(nStages, 1u, kBiquadMaxLanes / nChannels_);
+		}
+
+		nStages_ = nStages;
+
+		clear();
+	}
+
+	void
+	BiquadCascade::setIsStereo(bool stereo) {
+		const unsigned int nChannels = stereo ? 2u : 1u;
+
+		if(nChannels == nChannels_) {
+			return;
+		}
+
+		nChannels_ = nChannels;
+
+		if(nStages_ * nChannels_ > kBiquadMaxLanes) {
+			LOG(NLOG_ERROR, "A stereo biquad cascade runs at most %u stages, dropping the rest.", kBiquadMaxLanes / 2);
+			nStages_ = kBiquadMaxLanes / 2;
+		}
+
+		clear();
+	}
+
+	void
+	BiquadCascade::setCoefficients(unsigned int stage, float b0, float b1, float b2, float a1, float a2) {
+		if(stage >= kBiquadMaxLanes) {
+			return;
+		}
+
+		stageCoef_[stage][0] = b0;
+		stageCoef_[stage][1] = b1;
+		stageCoef_[stage][2] = b2;
+		stageCoef_[stage][3] = a1;
+		stageCoef_[stage][4] = a2;
+	}
+
+	void
+	BiquadCascade::setCoefficients(unsigned int stage, const float* newCoef) {
+		if(stage >= kBiquadMaxLanes) {
+			return;
+		}
+
+		memcpy(stageCoef_[stage], newCoef, 5 * sizeof(float));
+	}
+
+	void
+	BiquadCascade::clear() {
+		memset(state_, 0, sizeof(state_));
+
+		//Nothing to glide from.
+		primed_ = false;
+	}
+
+	void
+	BiquadCascade::filter(NAudioFrames& inFrames, NAudioFrames& outFrames) {
+		const unsigned int nFrames = inFrames.Frames();
+
+		if(inFrames.Channels() != nChannels_) {
+			setIsStereo(inFrames.Channels() == 2);
+		}
+
+		if(nFrames == 0) {
+			return;
+		}
+
+		//Spread the stages over the lanes. Lanes past the cascade stay at zero.
+		float target[5 * kBiquadMaxLanes];
+
+		memset(target, 0, sizeof(target));
+
+		for(unsigned int s = 0; s < nStages_; ++s) {
+			for(unsigned int c = 0; c < nChannels_; ++c) {
+				for(unsigned int k = 0; k < 5; ++k) {
+					target[k * kBiquadMaxLanes + s * nChannels_ + c] = stageCoef_[s][k];
+				}
+			}
+		}
+
+		const float* step = NULL;
+
+		if(interpolates_ && primed_) {
+			for(unsigned int n = 0; n < 5 * kBiquadMaxLanes; ++n) {
+				coefStep_[n] = (target[n] - coef_[n]) / (float)nFrames;
+			}
+
+			step = coefStep_;
+		}
+		else {
+			memcpy(coef_, target, sizeof(coef_));
+		}
+
+		NAudio_DSP::SIMD().biquadCascade(&outFrames[0], &inFrames[0], state_, coef_, step, nChannels_, nStages_, nFrames);
+
+		//Land exactly on the targets, whatever rounding the steps added up to.
+		if(step != NULL) {
+			memcpy(coef_, target, sizeof(coef_));
+		}
+
+		primed_ = true;
+
+		if(outFrames(0, 0u) != outFrames(0, 0u)) {
+			LOG(NLOG_ERROR, "NaN detected.", false);
+		}
+	}
+
+	//Zeroth order modified Bessel function of the first kind, for the Kaiser window.
+	static double
+	besselI0(double x) {
+		double sum = 1.0;
+		double term = 1.0;
+
+		for(int k = 1; k < 50; ++k) {
+			term *= (x / (2.0 * k)) * (x / (2.0 * k));
+			sum += term;
+
+			if(term < sum * 1e-12) {
+				break;
+			}
+		}
+
+		return(sum);
+	}
+
+	void
+	halfBandCoef(unsigned int nPairs, float beta, float* coefOut) {
+		//Side tap j (1-based) sits 2j - 1 taps from the centre. The window reaches zero just past the outermost tap.
+		const double halfLength = 2.0 * nPairs;
+		const double windowNorm = besselI0(beta);
+		double sum = 0.0;
+
+		for(unsigned int j = 1; j <= nPairs; ++j) {
+			double d = 2.0 * j - 1.0;
+			double sinc = ((j & 1u) ? 1.0 : -1.0) / (PI * d);
+			double r = d / halfLength;
+			double tap = sinc * besselI0(beta * sqrt(1.0 - r * r)) / windowNorm;
+
+			coefOut[nPairs - j] = (float)tap;
+			sum += tap;
+		}
+
+		//With the 0.5 centre tap, unity gain at DC needs the taps on each side to add up to 0.25.
+		for(unsigned int t = 0; t < nPairs; ++t) {
+			coefOut[t] = (float)(coefOut[t] * 0.25 / sum);
+		}
+	}
+
+	HalfBandUpsampler::HalfBandUpsampler() :
+		nPairs_(0)
+	{
+		initialize(8, 8.0f);
+	}
+
+	void
+	HalfBandUpsampler::initialize(unsigned int nPairs, float beta) {
+		nPairs_ = Max(nPairs, 1u);
+
+		//Zero stuffing halves the level, so the taps are doubled.
+		coef_.resize(nPairs_);
+		halfBandCoef(nPairs_, beta, &coef_[0]);
+
+		for(unsigned int t = 0; t < nPairs_; ++t) {
+			coef_[t] *= 2.0f;
+		}
+
+		for(unsigned int c = 0; c < 2; ++c) {
+			history_[c].assign(2 * nPairs_ - 1 + kSynthesisBlockSize, 0.0f);
+		}
+
+		filtered_.resize(kSynthesisBlockSize);
+	}
+
+	HalfBandDownsampler::HalfBandDownsampler() :
+		nPairs_(0)
+	{
+		initialize(8, 8.0f);
+	}
+
+	void
+	HalfBandDownsampler::initialize(unsigned int nPairs, float beta) {
+		nPairs_ = Max(nPairs, 1u);
+
+		coef_.resize(nPairs_);
+		halfBandCoef(nPairs_, beta, &coef_[0]);
+
+		for(unsigned int c = 0; c < 2; ++c) {
+			evenHistory_[c].assign(2 * nPairs_ - 1 + kSynthesisBlockSize, 0.0f);
+			oddHistory_[c].assign(nPairs_ + kSynthesisBlockSize, 0.0f);
+		}
+
+		filtered_.resize(kSynthesisBlockSize);
 	}
 }
\ No newline at end of file
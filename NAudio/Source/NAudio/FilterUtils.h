@@ -2,19 +2,34 @@
 
 #include "NAudioFrames.h"
 
+#include <vector>
+
 namespace NAudio {
 
+	//The coefficient helpers below take the sample rate of the graph they are used in. Pass context.sampleRate from inside a graph.
+
 	//Calculate coefficient for a pole with given time constant to reach -60dB delta in t60s seconds.
 	inline static float
-	t60ToOnePoleCoef(float t60s) {
-		float coef = expf(-1.0f / ((t60s / 6.91f) * SampleRate()));
+	t60ToOnePoleCoef(float t60s, float sampleRate = SampleRate()) {
+		float coef = expf(-1.0f / ((t60s / 6.91f) * sampleRate));
 		return((coef == coef) ? coef : 0.0f);		//NaN checking.
 	}
 
 	//Calculate coefficient for a pole with a given desired cutoff in hz.
 	inline static float
-	cutoffToOnePoleCoef(float cutoffHz) {
-		return(Clamp(expf(-TWO_PI*cutoffHz / SampleRate()), 0.0f, 1.0f));
+	cutoffToOnePoleCoef(float cutoffHz, float sampleRate = SampleRate()) {
+		return(Clamp(expf(-TWO_PI*cutoffHz / sampleRate), 0.0f, 1.0f));
+	}
+
+	//Tangent of 0 <= x < PI / 2, as the ratio of sine and cosine series. Within 4 parts per million up to 0.49 PI, and plain arithmetic, so loops over it vectorize.
+	//Trapezoidal filters use tan(PI * cutoff / sampleRate) to prewarp their cutoff, fast enough to do per sample.
+	inline float
+	fastTan(float x) {
+		const float x2 = x * x;
+		const float s = x * (1.0f + x2 * (-1.0f / 6.0f + x2 * (1.0f / 120.0f + x2 * (-1.0f / 5040.0f + x2 * (1.0f / 362880.0f + x2 * (-1.0f / 39916800.0f))))));
+		const float c = 1.0f + x2 * (-0.5f + x2 * (1.0f / 24.0f + x2 * (-1.0f / 720.0f + x2 * (1.0f / 40320.0f + x2 * (-1.0f / 3628800.0f + x2 * (1.0f / 479001600.0f))))));
+
+		return(s / c);
 	}
 
 	//Tick one sample through one-pole lowpass filter.
@@ -36,8 +51,8 @@ namespace NAudio {
 	//		   s^2 + a1 s + a0
 	//And be normalized for a cutoff of 1 rad/s. fc is the desired frequency cutoff in Hz. coef_out is a pointer to a float array of length 5. No bounds checking is performed.
 	inline static void
-	bltCoef(float b2, float b1, float b0, float a1, float a0, float fc, float* coef_out) {
-		float sf = 1.0f / tanf(PI * fc / NAudio::SampleRate());
+	bltCoef(float b2, float b1, float b0, float a1, float a0, float fc, float* coef_out, float sampleRate = SampleRate()) {
+		float sf = 1.0f / tanf(PI * fc / sampleRate);
 		float sfsq = sf * sf;
 		float norm = a0 + a1 * sf + sfsq;
 
@@ -48,78 +63,202 @@ namespace NAudio {
 		coef_out[4] = (a0 - a1 * sf + sfsq) / norm;
 	}
 
-	//Biquad Class. Biquad_ is an IIR biquad filter which provides a base object on which to build more advanced filters.
-	class Biquad {
+	//Design a half-band lowpass FIR (cutoff at a quarter of its sample rate) for 2x resampling. Windowed sinc with a Kaiser window of the given beta, unity gain at DC.
+	//Every other tap of a half-band filter is zero and the centre tap is always 0.5, so only the nPairs non-zero taps on one side are written to coefOut,
+	//outermost first, in the layout SIMDKernels_::firSymmetric expects. The whole filter is 4 * nPairs - 1 taps long.
+	void
+	halfBandCoef(unsigned int nPairs, float beta, float* coefOut);
+
+	//Most biquads one BiquadCascade can run, stages times channels. One SIMD lane each.
+	static const unsigned int kBiquadMaxLanes = 4;
+
+	//BiquadCascade Class. Up to 4 biquads in series, or 2 per channel in stereo, in transposed direct form II.
+	//Every biquad of the cascade gets its own SIMD lane and the state stays in registers for the block, so the whole cascade is one pass over the frames.
+	class BiquadCascade {
 	protected:
-		float coef_[5];
+		unsigned int nStages_;
+		unsigned int nChannels_;
+		bool interpolates_;
+		bool primed_;
 
-		NAudioFrames inputVec_;
-		NAudioFrames outputVec_;
+		//Coefficients each stage was last set to: b0, b1, b2, a1, a2.
+		float stageCoef_[kBiquadMaxLanes][5];
+
+		//Coefficients, their per sample steps and state of every lane, in the layout SIMDKernels_::biquadCascade expects.
+		float coef_[5 * kBiquadMaxLanes];
+		float coefStep_[5 * kBiquadMaxLanes];
+		float state_[2 * kBiquadMaxLanes];
 
 	public:
-		Biquad();
+		BiquadCascade(unsigned int nStages = 1);
 
+		//Changing the number of stages or channels clears the state.
 		void
-		setIsStereo(bool stereo) {
-			//Resize vectors to match number of channels.
-			inputVec_.Resize(kSynthesisBlockSize + 4, stereo ? 2u : 1u, 0.0f);
-			outputVec_.Resize(kSynthesisBlockSize + 4, stereo ? 2u : 1u, 0.0f);
+		setNumStages(unsigned int nStages);
+
+		unsigned int
+		getNumStages() const {
+			return(nStages_);
 		}
 
-		//Set the coefficients for the filtering operation.
+		void
+		setIsStereo(bool stereo);
+
+		//When on, new coefficients are reached with a linear ramp across the next block instead of a jump, so cutoffs can move every block without zipper noise.
+		void
+		setInterpolates(bool interpolates) {
+			interpolates_ = interpolates;
+		}
+
+		//Set the coefficients of one stage.
 		//		  b0 + b1*z^-1 + b2*z^-2
 		//H(z) = ------------------------
 		//		  1 + a1*z^-1 + a2*z^-2
 		void
-		setCoefficients(float b0, float b1, float b2, float a1, float a2);
+		setCoefficients(unsigned int stage, float b0, float b1, float b2, float a1, float a2);
+		void
+		setCoefficients(unsigned int stage, const float* newCoef);
+
+		//Silence the filter.
 		void
-		setCoefficients(float* newCoef);
+		clear();
 
+		//inFrames and outFrames may be the same frames.
 		void
 		filter(NAudioFrames& inFrames, NAudioFrames& outFrames);
 	};
 
-	inline void
-	Biquad::setCoefficients(float b0, float b1, float b2, float a1, float a2) {
-		coef_[0] = b0;
-		coef_[1] = b1;
-		coef_[2] = b2;
-		coef_[3] = a1;
-		coef_[4] = a2;
-	}
+	//Biquad Class. A single biquad, on the same engine as BiquadCascade.
+	class Biquad : public BiquadCascade {
+	public:
+		Biquad() :
+			BiquadCascade(1u)
+		{}
+
+		void
+		setCoefficients(float b0, float b1, float b2, float a1, float a2) {
+			BiquadCascade::setCoefficients(0u, b0, b1, b2, a1, a2);
+		}
+
+		void
+		setCoefficients(float* newCoef) {
+			BiquadCascade::setCoefficients(0u, newCoef);
+		}
+	};
+
+	//2x upsampler using a polyphase half-band FIR. Each input sample gives one filtered output sample and one delayed copy of the input (the centre tap), so only half of the non-zero taps are ever computed.
+	//Mono or stereo, following the frames passed in. History is kept per channel, buffers only grow when the block does.
+	class HalfBandUpsampler {
+	protected:
+		std::vector<float> coef_;
+		unsigned int nPairs_;
+
+		//Last 2 * nPairs - 1 input samples of each channel, followed by the current block.
+		std::vector<float> history_[2];
+		std::vector<float> filtered_;
+
+	public:
+		HalfBandUpsampler();
+
+		//Set the filter length in non-zero tap pairs and clear the history. Longer filters have a steeper transition band around the input's Nyquist frequency.
+		void
+		initialize(unsigned int nPairs, float beta);
+
+		//Upsample inFrames into outFrames. outFrames must have twice as many frames and the same number of channels.
+		void
+		process(const NAudioFrames& inFrames, NAudioFrames& outFrames);
+	};
 
 	inline void
-	Biquad::setCoefficients(float* newCoef) {
-		memcpy(coef_, newCoef, 5 * sizeof(float));
+	HalfBandUpsampler::process(const NAudioFrames& inFrames, NAudioFrames& outFrames) {
+		const unsigned int nFrames = inFrames.Frames();
+		const unsigned int nChannels = inFrames.Channels();
+		const unsigned int historySize = 2 * nPairs_ - 1;
+
+		const float* in = inFrames.Data();
+		float* out = &outFrames[0];
+
+		filtered_.resize(nFrames);
+
+		for(unsigned int c = 0; c < nChannels; ++c) {
+			std::vector<float>& history = history_[c];
+
+			history.resize(historySize + nFrames);
+
+			for(unsigned int i = 0; i < nFrames; ++i) {
+				history[historySize + i] = in[i * nChannels + c];
+			}
+
+			NAudio_DSP::SIMD().firSymmetric(&filtered_[0], &history[0], &coef_[0], nPairs_, nFrames);
+
+			//The zero-stuffed input only meets the centre tap on odd output samples, which are the input delayed to line up with the filter.
+			for(unsigned int i = 0; i < nFrames; ++i) {
+				out[(2 * i) * nChannels + c] = filtered_[i];
+				out[(2 * i + 1) * nChannels + c] = history[i + nPairs_];
+			}
+
+			memmove(&history[0], &history[nFrames], historySize * sizeof(float));
+		}
 	}
 
+	//2x downsampler using a polyphase half-band FIR. Only the even input samples go through the filter taps, the odd ones only meet the centre tap.
+	//Mono or stereo, following the frames passed in. History is kept per channel, buffers only grow when the block does.
+	class HalfBandDownsampler {
+	protected:
+		std::vector<float> coef_;
+		unsigned int nPairs_;
+
+		//Last 2 * nPairs - 1 even input samples of each channel, followed by the even samples of the current block.
+		std::vector<float> evenHistory_[2];
+
+		//Last nPairs odd input samples of each channel, followed by the odd samples of the current block.
+		std::vector<float> oddHistory_[2];
+
+		std::vector<float> filtered_;
+
+	public:
+		HalfBandDownsampler();
+
+		//Set the filter length in non-zero tap pairs and clear the history. Longer filters let less of the band above the output's Nyquist frequency alias back.
+		void
+		initialize(unsigned int nPairs, float beta);
+
+		//Downsample inFrames into outFrames. inFrames must have twice as many frames and the same number of channels.
+		void
+		process(const NAudioFrames& inFrames, NAudioFrames& outFrames);
+	};
+
 	inline void
-	Biquad::filter(NAudioFrames& inFrames, NAudioFrames& outFrames) {
-		//Initialize vectors.
-		memcpy(&inputVec_[0], &inputVec_(kSynthesisBlockSize, 0u), 2 * inputVec_.Channels() * sizeof(float));
-		memcpy(&inputVec_(2, 0u), &inFrames[0], inFrames.Size() * sizeof(float));
-		memcpy(&outputVec_[0], &outputVec_(kSynthesisBlockSize, 0u), 2 * outputVec_.Channels() * sizeof(float));
+	HalfBandDownsampler::process(const NAudioFrames& inFrames, NAudioFrames& outFrames) {
+		const unsigned int nFrames = outFrames.Frames();
+		const unsigned int nChannels = outFrames.Channels();
+		const unsigned int historySize = 2 * nPairs_ - 1;
 
-		//Perform IIR filter.
-		unsigned int stride = inFrames.Channels();
+		const float* in = inFrames.Data();
+		float* out = &outFrames[0];
 
-		for(unsigned int c = 0; c < stride; ++c) {
-			float* in = &inputVec_(2, c);
-			float* out = &outputVec_(2, c);
+		filtered_.resize(nFrames);
 
-			for(unsigned int i = 0; i < kSynthesisBlockSize; ++i) {
-				*out = *(in)*coef_[0] + *(in - stride)*coef_[1] + *(in - 2 * stride)*coef_[2] - *(out - stride)*coef_[3] - *(out - 2 * stride)*coef_[4];
+		for(unsigned int c = 0; c < nChannels; ++c) {
+			std::vector<float>& even = evenHistory_[c];
+			std::vector<float>& odd = oddHistory_[c];
 
-				in += stride;
-				out += stride;
+			even.resize(historySize + nFrames);
+			odd.resize(nPairs_ + nFrames);
+
+			for(unsigned int i = 0; i < nFrames; ++i) {
+				even[historySize + i] = in[(2 * i) * nChannels + c];
+				odd[nPairs_ + i] = in[(2 * i + 1) * nChannels + c];
 			}
-		}
 
-		if(outFrames(0, 0u) != outFrames(0, 0u)) {
-			LOG(NLOG_ERROR, "NaN detected.", false);
-		}
+			NAudio_DSP::SIMD().firSymmetric(&filtered_[0], &even[0], &coef_[0], nPairs_, nFrames);
+
+			for(unsigned int i = 0; i < nFrames; ++i) {
+				out[i * nChannels + c] = filtered_[i] + 0.5f * odd[i];
+			}
 
-		//Copy to synthesis block.
-		memcpy(&outFrames[0], &outputVec_(2, 0u), kSynthesisBlockSize * stride * sizeof(float));
+			memmove(&even[0], &even[nFrames], historySize * sizeof(float));
+			memmove(&odd[0], &odd[nFrames], nPairs_ * sizeof(float));
+		}
 	}
 };
\ No newline at end of file
@@ -5,9 +5,8 @@ namespace NAudio {
 		Filter_::Filter_() :
 			cutoff_(FixedValue(20000.0f)), Q_(FixedValue(0.7071f)),
 			bypass_(ControlValue(0.0f)),
-			bNormalizeGain_(true)
+			bNormalizeGain_(true), lastCutoff_(-1.0f), lastQ_(-1.0f), lastSampleRate_(0.0f), coefficientsChanged_(true)
 		{
-			workspace_.Resize(kSynthesisBlockSize, 1u, 0.0f);
 		}
 
 		void
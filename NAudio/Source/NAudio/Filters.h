@@ -12,8 +12,6 @@ namespace NAudio {
 		//Basic filter Effect_ subclass with inputs for cutoff and Q.
 		class Filter_ : public Effect_ {
 		protected:
-			NAudioFrames workspace_;
-
 			Generator cutoff_;
 			Generator Q_;
 
@@ -21,10 +19,21 @@ namespace NAudio {
 
 			bool bNormalizeGain_;
 
+			//Cutoff, Q and sample rate the current coefficients were computed for.
+			float lastCutoff_;
+			float lastQ_;
+			float lastSampleRate_;
+
+			//True when cutoff, Q, sample rate or gain normalization changed since the last block. Subclasses only recompute coefficients when it's set.
+			bool coefficientsChanged_;
+
+			//Every filter runs as a cascade of biquads, one stage per 2 poles. Subclasses set the coefficients of each stage.
+			BiquadCascade biquads_;
+
 			void
 			computeSynthesisBlock(const SynthesisContext_& context);
 
-			//Subclasses override to compute new coefficients and apply filter
+			//Subclasses override to set the coefficients of biquads_, which then filter the block.
 			virtual void
 			applyFilter(float cutoff, float Q, const SynthesisContext_& context) = 0;
 
@@ -35,9 +44,24 @@ namespace NAudio {
 			virtual void
 			setInput(Generator input);
 
+			virtual void
+			setIsStereoInput(bool stereo) {
+				Effect_::setIsStereoInput(stereo);
+				biquads_.setIsStereo(stereo);
+			}
+
+			//Glide the coefficients across each block instead of switching them at its start. Smoother sweeps of cutoff and Q, for a little more work per sample. Off by default.
+			void
+			setInterpolatesCoefficients(bool interpolates) {
+				biquads_.setInterpolates(interpolates);
+			}
+
 			void
 			setNormalizesGain(bool norm) {
 				bNormalizeGain_ = norm;
+
+				//Force the coefficients to be recomputed on the next block.
+				lastCutoff_ = -1.0f;
 			}
 
 			void
@@ -62,252 +86,172 @@ namespace NAudio {
 			float cQ;
 
 			//Get cutoff and Q inputs. For now only using first frame of output. Setting coefficients each frame is very inefficient.
-			//Updating cutoff every 64-samples is typically fast enough to avoid audible artifacts when sweeping filters.
-			cutoff_.tick(workspace_, context);
-			cCutoff = Clamp(workspace_(0, 0u), 20.0f, SampleRate() / 2.0f);
+			//Updating cutoff every 64-samples is typically fast enough to avoid audible artifacts when sweeping filters. For longer blocks, setInterpolatesCoefficients ramps to the new coefficients across the block.
+			cCutoff = Clamp(cutoff_.tickView(context)(0, 0u), 20.0f, context.sampleRate / 2.0f);
+			cQ = Max(Q_.tickView(context)(0, 0u), 0.7071f);
+
+			//Cutoff and Q usually come from fixed values, so most blocks can keep the coefficients of the block before.
+			coefficientsChanged_ = (cCutoff != lastCutoff_ || cQ != lastQ_ || context.sampleRate != lastSampleRate_);
 
-			Q_.tick(workspace_, context);
-			cQ = Max(workspace_(0, 0u), 0.7071f);
+			if(coefficientsChanged_) {
+				lastCutoff_ = cCutoff;
+				lastQ_ = cQ;
+				lastSampleRate_ = context.sampleRate;
+
+				//Ringing at the cutoff decays with a time constant of Q / (PI * cutoff). Doubled to cover the cascaded sections of the 4-pole filters.
+				tailLength_ = 2.0f * logf(1.0f / DBToLin(kEffectTailFloorDb)) * cQ / (PI * cCutoff);
+			}
 
 			applyFilter(cCutoff, cQ, context);
+
+			biquads_.filter(dryFrames_, outputFrames_);
 		}
 
 		//LPF 6. One-pole lowpass filter. Q is undefined for this filter.
 		class LPF6_ : public Filter_ {
-		private:
-			float lastOut_[2];
-
 		protected:
 			inline void
 			applyFilter(float cutoff, float Q, const SynthesisContext_& context) {
-				float* inptr = &dryFrames_[0];
-				float* outptr = &outputFrames_[0];
+				//y = norm * x + coef * y[-1], as a biquad.
+				if(coefficientsChanged_) {
+					float coef = cutoffToOnePoleCoef(cutoff, context.sampleRate);
 
-				float coef = cutoffToOnePoleCoef(cutoff);
-				float norm = bNormalizeGain_ ? 1.0f - coef : 1.0f;
-
-				unsigned int nChannels = dryFrames_.Channels();
-
-				for(unsigned int i = 0; i < kSynthesisBlockSize; ++i) {
-					for(unsigned int c = 0; c < nChannels; ++c) {
-						lastOut_[c] = (norm * (*inptr++)) + (coef * lastOut_[c]);
-						*outptr++ = lastOut_[c];
-					}
+					biquads_.setCoefficients(0u, bNormalizeGain_ ? 1.0f - coef : 1.0f, 0.0f, 0.0f, -coef, 0.0f);
 				}
 			}
-
-		public:
-			LPF6_() {
-				lastOut_[0] = 0;
-				lastOut_[1] = 0;
-			}
 		};
 
 		//HPF 6. One-pole highpass filter. Q is undefined for this filter.
 		class HPF6_ : public Filter_ {
-		private:
-			float lastOut_[2];
-
 		protected:
 			inline void
 			applyFilter(float cutoff, float Q, const SynthesisContext_& context) {
-				float* inptr = &dryFrames_[0];
-				float* outptr = &outputFrames_[0];
-
-				float coef = 1.0f - cutoffToOnePoleCoef(cutoff);
-				float norm = bNormalizeGain_ ? 1.0f - coef : 1.0f;
-
-				unsigned int nChannels = dryFrames_.Channels();
+				//y = norm * x - coef * y[-1], as a biquad.
+				if(coefficientsChanged_) {
+					float coef = 1.0f - cutoffToOnePoleCoef(cutoff, context.sampleRate);
 
-				for(unsigned int i = 0; i < kSynthesisBlockSize; ++i) {
-					for(unsigned int c = 0; c < nChannels; ++c) {
-						lastOut_[c] = (norm * (*inptr++)) - (coef * lastOut_[c]);
-						*outptr++ = lastOut_[c];
-					}
+					biquads_.setCoefficients(0u, bNormalizeGain_ ? 1.0f - coef : 1.0f, 0.0f, 0.0f, coef, 0.0f);
 				}
 			}
-
-		public:
-			HPF6_() {
-				lastOut_[0] = 0;
-				lastOut_[1] = 0;
-			}
 		};
 
 		//LPF 12. Butterworth 2-pole LPF.
 		class LPF12_ : public Filter_ {
-		private:
-			Biquad biquad_;
-
 		protected:
 			inline void
 			applyFilter(float cutoff, float Q, const SynthesisContext_& context) {
 				//Set coefficients.
-				float newCoef[5];
+				if(coefficientsChanged_) {
+					float newCoef[5];
 
-				bltCoef(0.0f, 0.0f, bNormalizeGain_ ? 1.0f / Q : 1.0f, 1.0f / Q, 1.0f, cutoff, newCoef);
-				biquad_.setCoefficients(newCoef);
-
-				//Compute.
-				biquad_.filter(dryFrames_, outputFrames_);
-			}
-
-		public:
-			void
-			setIsStereoInput(bool isStereoInput) {
-				Filter_::setIsStereoInput(isStereoInput);
-				biquad_.setIsStereo(isStereoInput);
+					bltCoef(0.0f, 0.0f, bNormalizeGain_ ? 1.0f / Q : 1.0f, 1.0f / Q, 1.0f, cutoff, newCoef, context.sampleRate);
+					biquads_.setCoefficients(0u, newCoef);
+				}
 			}
 		};
 
 		//LPF 24. Butterworth 4-pole LPF.
 		class LPF24_ : public Filter_ {
-		private:
-			Biquad biquads_[2];
-
 		protected:
 			inline void
 			applyFilter(float cutoff, float Q, const SynthesisContext_& context) {
 				//Set coefficients.
-				float newCoef[5];
-
-				//Stage 1.
-				bltCoef(0.0f, 0.0f, bNormalizeGain_ ? 1.0f / Q : 1.0f, 0.5412f / Q, 1.0f, cutoff, newCoef);
-				biquads_[0].setCoefficients(newCoef);
+				if(coefficientsChanged_) {
+					float newCoef[5];
 
-				//Stage 2.
-				bltCoef(0.0f, 0.0f, bNormalizeGain_ ? 1.0f / Q : 1.0f, 1.3066f / Q, 1.0f, cutoff, newCoef);
-				biquads_[1].setCoefficients(newCoef);
+					//Stage 1.
+					bltCoef(0.0f, 0.0f, bNormalizeGain_ ? 1.0f / Q : 1.0f, 0.5412f / Q, 1.0f, cutoff, newCoef, context.sampleRate);
+					biquads_.setCoefficients(0u, newCoef);
 
-				//Compute.
-				biquads_[0].filter(dryFrames_, outputFrames_);
-				biquads_[1].filter(outputFrames_, outputFrames_);
+					//Stage 2.
+					bltCoef(0.0f, 0.0f, bNormalizeGain_ ? 1.0f / Q : 1.0f, 1.3066f / Q, 1.0f, cutoff, newCoef, context.sampleRate);
+					biquads_.setCoefficients(1u, newCoef);
+				}
 			}
 
 		public:
-			void
-			setIsStereoInput(bool isStereoInput) {
-				Filter_::setIsStereoInput(isStereoInput);
-				biquads_[0].setIsStereo(isStereoInput);
-				biquads_[1].setIsStereo(isStereoInput);
+			LPF24_() {
+				biquads_.setNumStages(2u);
 			}
 		};
 
 		//HPF 12. Butterworth 2-pole HPF.
 		class HPF12_ : public Filter_ {
-		private:
-			Biquad biquad_;
-
 		protected:
 			inline void
 			applyFilter(float cutoff, float Q, const SynthesisContext_& context) {
 				//Set coefficients.
-				float newCoef[5];
-
-				bltCoef(bNormalizeGain_ ? 1.0f / Q : 1.0f, 0.0f, 0.0f, 1.0f / Q, 1.0f, cutoff, newCoef);
-				biquad_.setCoefficients(newCoef);
+				if(coefficientsChanged_) {
+					float newCoef[5];
 
-				//Compute.
-				biquad_.filter(dryFrames_, outputFrames_);
-			}
-
-		public:
-			void
-			setIsStereoInput(bool isStereoInput) {
-				Filter_::setIsStereoInput(isStereoInput);
-				biquad_.setIsStereo(isStereoInput);
+					bltCoef(bNormalizeGain_ ? 1.0f / Q : 1.0f, 0.0f, 0.0f, 1.0f / Q, 1.0f, cutoff, newCoef, context.sampleRate);
+					biquads_.setCoefficients(0u, newCoef);
+				}
 			}
 		};
 
 		//HPF 24. Butterworth 4-pole HPF.
 		class HPF24_ : public Filter_ {
-		private:
-			Biquad biquads_[2];
-
 		protected:
 			inline void
 			applyFilter(float cutoff, float Q, const SynthesisContext_& context) {
 				//Set coefficients.
-				float newCoef[5];
+				if(coefficientsChanged_) {
+					float newCoef[5];
 
-				//Stage 1.
-				bltCoef(bNormalizeGain_ ? 1.0f / Q : 1.0f, 0.0f, 0.0f, 0.5412f / Q, 1.0f, cutoff, newCoef);
-				biquads_[0].setCoefficients(newCoef);
+					//Stage 1.
+					bltCoef(bNormalizeGain_ ? 1.0f / Q : 1.0f, 0.0f, 0.0f, 0.5412f / Q, 1.0f, cutoff, newCoef, context.sampleRate);
+					biquads_.setCoefficients(0u, newCoef);
 
-				//Stage 2.
-				bltCoef(bNormalizeGain_ ? 1.0f / Q : 1.0f, 0.0f, 0.0f, 1.3066f / Q, 1.0f, cutoff, newCoef);
-				biquads_[1].setCoefficients(newCoef);
-
-				//Compute.
-				biquads_[0].filter(dryFrames_, outputFrames_);
-				biquads_[1].filter(outputFrames_, outputFrames_);
+					//Stage 2.
+					bltCoef(bNormalizeGain_ ? 1.0f / Q : 1.0f, 0.0f, 0.0f, 1.3066f / Q, 1.0f, cutoff, newCoef, context.sampleRate);
+					biquads_.setCoefficients(1u, newCoef);
+				}
 			}
 
 		public:
-			void
-			setIsStereoInput(bool isStereoInput) {
-				Filter_::setIsStereoInput(isStereoInput);
-				biquads_[0].setIsStereo(isStereoInput);
-				biquads_[1].setIsStereo(isStereoInput);
+			HPF24_() {
+				biquads_.setNumStages(2u);
 			}
 		};
 
 		//BPF 12. Butterworth 2-pole BPF, constant 0dB peak
 		class BPF12_ : public Filter_ {
-		private:
-			Biquad biquad_;
-
 		protected:
 			inline void
 			applyFilter(float cutoff, float Q, const SynthesisContext_& context) {
 				//Set coefficients.
-				float newCoef[5];
-
-				bltCoef(0.0f, bNormalizeGain_ ? 1.0f / Q : 1.0f, 0.0f, 1.0f / Q, 1.0f, cutoff, newCoef);
-				biquad_.setCoefficients(newCoef);
-
-				//Compute.
-				biquad_.filter(dryFrames_, outputFrames_);
-			}
+				if(coefficientsChanged_) {
+					float newCoef[5];
 
-		public:
-			virtual void
-			setIsStereoInput(bool isStereoInput) {
-				Filter_::setIsStereoInput(isStereoInput);
-				biquad_.setIsStereo(isStereoInput);
+					bltCoef(0.0f, bNormalizeGain_ ? 1.0f / Q : 1.0f, 0.0f, 1.0f / Q, 1.0f, cutoff, newCoef, context.sampleRate);
+					biquads_.setCoefficients(0u, newCoef);
+				}
 			}
 		};
 
 		//BPF 24. Butterworth 4-pole BPF.
 		class BPF24_ : public Filter_ {
-		private:
-			Biquad biquads_[2];
-
 		protected:
 			inline void
 			applyFilter(float cutoff, float Q, const SynthesisContext_& context) {
 				//Set coefficients.
-				float newCoef[5];
-
-				//Stage 1.
-				bltCoef(0.0f, bNormalizeGain_ ? 1.0f / Q : 1.0f, 0.0f, 0.5412f / Q, 1.0f, cutoff, newCoef);
-				biquads_[0].setCoefficients(newCoef);
+				if(coefficientsChanged_) {
+					float newCoef[5];
 
-				//Stage 2.
-				bltCoef(0.0f, bNormalizeGain_ ? 1.0f / Q : 1.0f, 0.0f, 1.3066f / Q, 1.0f, cutoff, newCoef);
-				biquads_[1].setCoefficients(newCoef);
+					//Stage 1.
+					bltCoef(0.0f, bNormalizeGain_ ? 1.0f / Q : 1.0f, 0.0f, 0.5412f / Q, 1.0f, cutoff, newCoef, context.sampleRate);
+					biquads_.setCoefficients(0u, newCoef);
 
-				//Compute.
-				biquads_[0].filter(dryFrames_, outputFrames_);
-				biquads_[1].filter(outputFrames_, outputFrames_);
+					//Stage 2.
+					bltCoef(0.0f, bNormalizeGain_ ? 1.0f / Q : 1.0f, 0.0f, 1.3066f / Q, 1.0f, cutoff, newCoef, context.sampleRate);
+					biquads_.setCoefficients(1u, newCoef);
+				}
 			}
 
 		public:
-			void
-			setIsStereoInput(bool isStereoInput) {
-				Filter_::setIsStereoInput(isStereoInput);
-				biquads_[0].setIsStereo(isStereoInput);
-				biquads_[1].setIsStereo(isStereoInput);
+			BPF24_() {
+				biquads_.setNumStages(2u);
 			}
 		};
 	}
@@ -324,6 +268,12 @@ namespace NAudio {
 			this->gen()->setNormalizesGain(norm);
 			return(static_cast<FilterType&>(*this));
 		}
+
+		FilterType&
+		interpolatesCoefficients(bool interpolates) {
+			this->gen()->setInterpolatesCoefficients(interpolates);
+			return(static_cast<FilterType&>(*this));
+		}
 	};
 
 	//LPF 6.
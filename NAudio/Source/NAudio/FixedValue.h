@@ -24,11 +24,44 @@ namespace NAudio {
 		inline void
 		FixedValue_::computeSynthesisBlock(const SynthesisContext_& context) {
 			float* buffStart = &outputFrames_[0];
+			float* buffEnd = buffStart + outputFrames_.Size();
 
 			ControlGeneratorOutput valueOutput = valueGen.tick(context);
 
-			if(valueOutput.triggered) {
-				std::fill(buffStart, buffStart + outputFrames_.Size(), valueOutput.value);
+			//Also refill after a block that changed part way through, or after a block size change, which leaves the block silent.
+			if(valueOutput.triggered || *buffStart != valueOutput.value || *(buffEnd - 1) != valueOutput.value) {
+				const unsigned int nChannels = outputFrames_.Channels();
+
+				//Frames before the first change keep the previous value, then each change holds until the next one.
+				float value = *(buffEnd - 1);
+				float* runStart = buffStart;
+
+				bool silent = true;
+				bool constant = true;
+
+				for(unsigned int i = 0; i < valueOutput.numEvents(); ++i) {
+					ControlEvent change = valueOutput.event(i);
+					float* changeStart = buffStart + Min(change.offset, (unsigned int)outputFrames_.Frames()) * nChannels;
+
+					if(changeStart > runStart) {
+						std::fill(runStart, changeStart, value);
+
+						silent = silent && value == 0.0f;
+						constant = constant && value == valueOutput.value;
+						runStart = changeStart;
+					}
+
+					value = change.value;
+				}
+
+				std::fill(runStart, buffEnd, valueOutput.value);
+
+				outputIsSilent_ = silent && valueOutput.value == 0.0f;
+				outputIsConstant_ = constant;
+			}
+			else {
+				outputIsSilent_ = (valueOutput.value == 0.0f);
+				outputIsConstant_ = true;
 			}
 		}
 	}
@@ -2,10 +2,45 @@
 
 namespace NAudio {
 	namespace NAudio_DSP {
+		//Number of block sizes a generator can be asked for, the powers of two from kMinSynthesisBlockSize to kMaxNestedBlockSize.
+		static const unsigned int kNumSynthesisBlockSizes = 11;
+
+		const NAudioFrames&
+		silentFrames(unsigned int nFrames, unsigned int nChannels) {
+			struct SilentBlocks_ {
+				NAudioFrames blocks[2][kNumSynthesisBlockSizes];
+
+				SilentBlocks_() {
+					for(unsigned int c = 0; c < 2; ++c) {
+						for(unsigned int i = 0; i < kNumSynthesisBlockSizes; ++i) {
+							blocks[c][i].Resize(kMinSynthesisBlockSize << i, c + 1, 0.0f);
+						}
+					}
+				}
+			};
+
+			static const SilentBlocks_ silent;
+
+			unsigned int i = 0;
+
+			while((kMinSynthesisBlockSize << i) < nFrames && i < kNumSynthesisBlockSizes - 1) {
+				++i;
+			}
+
+			if((kMinSynthesisBlockSize << i) < nFrames) {
+				LOG(NLOG_ERROR, "No silent block of %u frames, blocks are at most %u frames.", nFrames, kMaxNestedBlockSize);
+			}
+
+			return(silent.blocks[nChannels > 1 ? 1 : 0][i]);
+		}
+
 		Generator_::Generator_() :
-			lastFrameIndex_(0), isStereoOutput_(false)
+			lastFrameIndex_(0), isStereoOutput_(false), outputIsSilent_(false), outputIsConstant_(false)
 		{
 			outputFrames_.Resize(kSynthesisBlockSize, 1u, 0.0f);
+
+			//Build the shared silence here, off the audio thread.
+			silentFrames(kSynthesisBlockSize, 1u);
 		}
 
 		Generator_::~Generator_() {
@@ -14,7 +49,7 @@ namespace NAudio {
 		void
 		Generator_::setIsStereoOutput(bool stereo) {
 			if(stereo != isStereoOutput_) {
-				outputFrames_.Resize(kSynthesisBlockSize, stereo ? 2u : 1u, 0.0f);
+				outputFrames_.Resize(outputFrames_.Frames(), stereo ? 2u : 1u, 0.0f);
 			}
 
 			isStereoOutput_ = stereo;
@@ -1,22 +1,48 @@
 #pragma once
 
 #include "NAudioFrames.h"
+#include "GraphSchedule.h"
 
 namespace NAudio {
 	namespace NAudio_DSP {
+		//Shared all-zero block of any size a graph or subgraph runs at, up to kMaxNestedBlockSize, mono or stereo. Built with the first generator, so getting it later never allocates.
+		const NAudioFrames&
+		silentFrames(unsigned int nFrames, unsigned int nChannels);
+
 		class Generator_ {
 		public:
 			Generator_();
 			virtual ~Generator_();
 
-			virtual void
+			//Copy this generator's block for the current context into frames, converting the channel layout if needed.
+			void
 			tick(NAudioFrames& frames, const SynthesisContext_& context);
 
+			//Return a read-only view of this generator's block for the current context, without copying it.
+			//The view has this generator's channel layout and stays valid until the generator computes its next block.
+			//Subclasses that need extra work per block (such as ticking their own inputs) should override this rather than tick().
+			virtual const NAudioFrames&
+			tickView(const SynthesisContext_& context);
+
 			bool
 			isStereoOutput() {
 				return(isStereoOutput_);
 			}
 
+			//True if the current block is known to be all zeros. Only generators that can tell cheaply set it, so false does not mean the block has sound in it.
+			//Consumers use it to skip work on blocks that can't change their output.
+			bool
+			isSilent() const {
+				return(outputIsSilent_);
+			}
+
+			//True if every sample of the current block, in every channel, equals the first one. Silent blocks count as constant. Like isSilent(), only set when cheap to know.
+			//Consumers read the value once from frame 0 and use scalar code instead of per-sample vectors.
+			bool
+			isConstant() const {
+				return(outputIsConstant_ || outputIsSilent_);
+			}
+
 			//Set stereo/mono - changes number of channels in outputFrames_. Subclasses should call in constructor to determine channel output.
 			virtual void
 			setIsStereoOutput(bool stereo);
@@ -28,22 +54,60 @@ namespace NAudio {
 
 			bool isStereoOutput_;
 
+			//Set by computeSynthesisBlock() when the block it computed is all zeros. Cleared before every block.
+			bool outputIsSilent_;
+
+			//Set by computeSynthesisBlock() when every sample of the block it computed is the same. Cleared before every block.
+			bool outputIsConstant_;
+
 			//Override point for defining generator behavior. Subclasses should implement to fill frames with new data.
 			virtual void
 			computeSynthesisBlock(const SynthesisContext_&context) {
 			}
+
+			//Follow the context's block size. Resized blocks start out silent. Only allocates when the block grows past anything seen before.
+			//Returns false if out of memory, the block is then left at its old size.
+			bool
+			resizeOutput(const SynthesisContext_& context) {
+				return(outputFrames_.Frames() == context.blockSize || outputFrames_.Resize(context.blockSize, outputFrames_.Channels(), 0.0f));
+			}
+
+			//What tickView() hands out. A block that could not grow to the context's size is stood in for by silence of that size, so consumers never read past its end.
+			const NAudioFrames&
+			outputBlock(const SynthesisContext_& context) const {
+				if(outputFrames_.Frames() != context.blockSize) {
+					return(silentFrames(context.blockSize, outputFrames_.Channels()));
+				}
+
+				return(outputFrames_);
+			}
 		};
 
-		inline void
-		Generator_::tick(NAudioFrames& frames, const SynthesisContext_& context) {
+		inline const NAudioFrames&
+		Generator_::tickView(const SynthesisContext_& context) {
 			//Check context to see if we need new frames.
 			if(context.forceNewOutput || lastFrameIndex_ != context.elapsedFrames) {
-				computeSynthesisBlock(context);
+				//Out of memory, skip the block. outputBlock() stands in silence for it.
+				outputIsSilent_ = !resizeOutput(context);
+				outputIsConstant_ = false;
+
+				if(!outputIsSilent_) {
+					computeSynthesisBlock(context);
+				}
+
 				lastFrameIndex_ = context.elapsedFrames;
 			}
 
-			//Copy synthesis block to frames passed in.
-			frames.Copy(outputFrames_);
+			return(outputBlock(context));
+		}
+
+		inline void
+		Generator_::tick(NAudioFrames& frames, const SynthesisContext_& context) {
+			//Copy synthesis block to frames passed in, sizing them to the block first.
+			const NAudioFrames& view = tickView(context);
+
+			frames.Resize(view.Frames(), frames.Channels());
+			frames.Copy(view);
 		}
 	}
 
@@ -62,6 +126,78 @@ namespace NAudio {
 		virtual void
 		tick(NAudioFrames& frames, const NAudio_DSP::SynthesisContext_& context) {
 			obj->tick(frames, context);
+
+			if(context.recorder != NULL) {
+				context.recorder->record(obj);
+			}
+		}
+
+		//Whether the block from the last tick is known to be silent. See Generator_::isSilent().
+		inline bool
+		isSilent() {
+			return(obj->isSilent());
+		}
+
+		//Whether the block from the last tick is known to be constant. See Generator_::isConstant().
+		inline bool
+		isConstant() {
+			return(obj->isConstant());
+		}
+
+		//Zero-copy alternative to tick(). See Generator_::tickView().
+		inline const NAudioFrames&
+		tickView(const NAudio_DSP::SynthesisContext_& context) {
+			const NAudioFrames& frames = obj->tickView(context);
+
+			if(context.recorder != NULL) {
+				context.recorder->record(obj);
+			}
+
+			return(frames);
+		}
+
+		//Tick and return a pointer for reading the block one mono sample per frame, advancing by stride after each frame.
+		//Constant blocks are read from frame 0 with a stride of 0 and mono blocks straight from the generator's output, neither is copied.
+		//Stereo blocks are downmixed into workspace first, the same as tick() into mono frames.
+		inline const float*
+		tickSamples(NAudioFrames& workspace, const NAudio_DSP::SynthesisContext_& context, unsigned int& stride) {
+			const NAudioFrames& frames = tickView(context);
+
+			if(obj->isConstant()) {
+				stride = 0u;
+				return(frames.Data());
+			}
+
+			stride = 1u;
+
+			if(frames.Channels() == 1u) {
+				return(frames.Data());
+			}
+
+			workspace.Resize(frames.Frames(), 1u);
+			workspace.Copy(frames);
+
+			return(workspace.Data());
+		}
+
+		//Same as tickSamples(), but every sample is multiplied by scale (oscillators use it to turn frequencies into phase increments).
+		//A constant block is scaled once into constantValue, which the returned pointer then points at. Other blocks are always copied into workspace to be scaled.
+		inline const float*
+		tickScaledSamples(NAudioFrames& workspace, float scale, float& constantValue, const NAudio_DSP::SynthesisContext_& context, unsigned int& stride) {
+			const NAudioFrames& frames = tickView(context);
+
+			if(obj->isConstant()) {
+				constantValue = frames(0, 0u) * scale;
+				stride = 0u;
+				return(&constantValue);
+			}
+
+			workspace.Resize(frames.Frames(), 1u);
+			workspace.Copy(frames);
+			workspace *= scale;
+
+			stride = 1u;
+			return(workspace.Data());
 		}
 	};
 
@@ -0,0 +1,112 @@
+#include "GraphSchedule.h"
+#include "Generator.h"
+
+namespace NAudio {
+	namespace NAudio_DSP {
+		GraphSchedule_::GraphSchedule_(size_t capacity) :
+			recording_(false), valid_(false), overflowed_(false)
+		{
+			entries_.reserve(capacity);
+
+			size_t nSlots = 1;
+
+			while(nSlots < 2 * capacity) {
+				nSlots <<= 1;
+			}
+
+			seen_.assign(nSlots, NULL);
+		}
+
+		void
+		GraphSchedule_::invalidate() {
+			entries_.clear();
+			std::fill(seen_.begin(), seen_.end(), (const void*)NULL);
+
+			recording_ = false;
+			valid_ = false;
+			overflowed_ = false;
+		}
+
+		void
+		GraphSchedule_::beginRecording() {
+			invalidate();
+			recording_ = true;
+		}
+
+		void
+		GraphSchedule_::endRecording() {
+			recording_ = false;
+			valid_ = !overflowed_;
+
+			if(overflowed_) {
+				entries_.clear();
+			}
+		}
+
+		bool
+		GraphSchedule_::markSeen(const void* node) {
+			const size_t mask = seen_.size() - 1;
+
+			//Nodes are heap objects, so the low bits carry little. Fibonacci hashing spreads the rest.
+			size_t slot = (size_t)(((unsigned long long)(size_t)node >> 4) * 11400714819323198485ull >> 32) & mask;
+
+			while(seen_[slot] != NULL) {
+				if(seen_[slot] == node) {
+					return(false);
+				}
+
+				slot = (slot + 1) & mask;
+			}
+
+			seen_[slot] = node;
+
+			return(true);
+		}
+
+		void
+		GraphSchedule_::addEntry(const void* node, const Entry_& entry) {
+			if(!recording_ || overflowed_) {
+				return;
+			}
+
+			//Keep the first time a node is seen. This runs on the audio thread in the recording block, so the lookup has to stay constant time.
+			if(entries_.size() == entries_.capacity()) {
+				//Already recorded nodes are still fine.
+				if(markSeen(node)) {
+					LOG(NLOG_WARN, "Graph has more than %u nodes, it will not be compiled.", (unsigned int)entries_.capacity());
+					overflowed_ = true;
+				}
+
+				return;
+			}
+
+			if(markSeen(node)) {
+				entries_.push_back(entry);
+			}
+		}
+
+		void
+		GraphSchedule_::record(Generator_* generator) {
+			Entry_ entry = { generator, NULL };
+			addEntry(generator, entry);
+		}
+
+		void
+		GraphSchedule_::record(ControlGenerator_* controlGenerator) {
+			Entry_ entry = { NULL, controlGenerator };
+			addEntry(controlGenerator, entry);
+		}
+
+		void
+		GraphSchedule_::run(const SynthesisContext_& context) {
+			for(std::vector<Entry_>::iterator it = entries_.begin(); it != entries_.end(); ++it) {
+				if(it->generator != NULL) {
+					it->generator->tickView(context);
+				}
+				else {
+					it->controlGenerator->tick(context);
+				}
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "NAudioCore.h"
+
+namespace NAudio {
+	namespace NAudio_DSP {
+		class Generator_;
+		class ControlGenerator_;
+
+		//Flat execution order for a generator graph.
+		//Generators don't expose their inputs, so the order is recorded from one normal (recursive) block: every Generator and ControlGenerator ticked through its
+		//smart pointer is recorded the first time a tick returns, which is always after all of its inputs. Running the nodes in that order computes each one
+		//exactly once, with its inputs already cached, instead of recursing through the whole graph.
+		//All memory is reserved up front, recording and running never allocate.
+		class GraphSchedule_ {
+		private:
+			struct Entry_ {
+				Generator_* generator;
+				ControlGenerator_* controlGenerator;
+			};
+
+			std::vector<Entry_> entries_;
+
+			//Open addressing set of the nodes recorded so far, a power of two at least twice the capacity. NULL is an empty slot.
+			std::vector<const void*> seen_;
+
+			bool recording_;
+			bool valid_;
+			bool overflowed_;
+
+			//Add node to the set of recorded nodes. Returns false if it was already there.
+			bool
+			markSeen(const void* node);
+
+			//Shared by both record() overloads.
+			void
+			addEntry(const void* node, const Entry_& entry);
+
+		public:
+			GraphSchedule_(size_t capacity = 4096);
+
+			//True if the schedule can be run.
+			bool
+			isValid() {
+				return(valid_);
+			}
+
+			//True if the last recording had more nodes than the capacity. The graph then keeps running recursively until invalidate() is called.
+			bool
+			hasOverflowed() {
+				return(overflowed_);
+			}
+
+			//Drop the schedule, for example because the graph changed.
+			void
+			invalidate();
+
+			//Start recording. Set the context's recorder to this schedule and tick the graph's roots once.
+			void
+			beginRecording();
+
+			void
+			endRecording();
+
+			//Called by the Generator and ControlGenerator smart pointers when ticked with a recording context.
+			void
+			record(Generator_* generator);
+
+			void
+			record(ControlGenerator_* controlGenerator);
+
+			//Compute every node for this context, in schedule order.
+			//This only fills the nodes' caches. The caller still ticks the graph's roots to get their output, which no longer recurses: every node already has its block for the context and returns it at once.
+			void
+			run(const SynthesisContext_& context);
+		};
+	}
+}
\ No newline at end of file
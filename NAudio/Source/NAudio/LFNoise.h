@@ -1,7 +1,7 @@
 #pragma once
 
 #include "Generator.h"
-#include "NRNG/NRNG.h"
+#include "RandomUtils.h"
 
 namespace NAudio {
 	namespace NAudio_DSP {
@@ -13,6 +13,8 @@ namespace NAudio {
 			float mLevel;
 			signed long mCounter;
 
+			Xoshiro128 random_;
+
 			void
 			computeSynthesisBlock(const SynthesisContext_& context);
 
@@ -23,6 +25,11 @@ namespace NAudio {
 
 			void
 			setFreq(ControlGenerator freq);
+
+			void
+			setSeed(unsigned long long seed) {
+				random_.seed(seed);
+			}
 		};
 
 		inline void
@@ -33,10 +40,10 @@ namespace NAudio {
 
 			do {
 				if(mCounter <= 0) {
-					mCounter = (long)(SampleRate() / std::max<float>(mFreq.tick(context).value, .001f));
+					mCounter = (long)(context.sampleRate / std::max<float>(mFreq.tick(context).value, .001f));
 					mCounter = (long)(std::max<float>(1.0f, (float)mCounter));
 
-					float nextlevel = NRNG::GetInstance()->GetFloat(-1.0f, 1.0f);
+					float nextlevel = random_.getFloat(-1.0f, 1.0f);
 
 					mSlope = (nextlevel - mLevel) / mCounter;
 				}
@@ -58,5 +65,12 @@ namespace NAudio {
 	class LFNoise : public TemplatedGenerator<NAudio_DSP::LFNoise_> {
 	public:
 		NAUDIO_MAKE_CTRL_GEN_SETTERS(LFNoise, setFreq, setFreq);
+
+		//Restart the random levels from seed.
+		LFNoise&
+		seed(unsigned long long seed) {
+			gen()->setSeed(seed);
+			return(*this);
+		}
 	};
 }
\ No newline at end of file
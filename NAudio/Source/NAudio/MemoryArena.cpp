@@ -0,0 +1,147 @@
+#include "MemoryArena.h"
+
+#if defined(_MSC_VER)
+	#include <malloc.h>
+#else
+	#include <stdlib.h>
+#endif
+
+namespace NAudio {
+	//Round bytes up to whole cache lines.
+	static size_t
+	alignedSize(size_t bytes) {
+		return((bytes + kMemoryAlignment - 1) & ~(kMemoryAlignment - 1));
+	}
+
+	void*
+	alignedAlloc(size_t bytes) {
+		bytes = alignedSize(Max(bytes, (size_t)1));
+
+		#if defined(_MSC_VER)
+			return(_aligned_malloc(bytes, kMemoryAlignment));
+		#else
+			void* memory = NULL;
+
+			if(posix_memalign(&memory, kMemoryAlignment, bytes) != 0) {
+				return(NULL);
+			}
+
+			return(memory);
+		#endif
+	}
+
+	void
+	alignedFree(void* memory) {
+		#if defined(_MSC_VER)
+			_aligned_free(memory);
+		#else
+			free(memory);
+		#endif
+	}
+
+	namespace NAudio_DSP {
+		//Room taken by a block's header, so the memory after it stays aligned.
+		static const size_t kBlockHeaderSize = (sizeof(void*) * 3 + kMemoryAlignment - 1) & ~(kMemoryAlignment - 1);
+
+		static thread_local MemoryArena_* currentArena_ = NULL;
+
+		MemoryArena_::MemoryArena_() :
+			block_(NULL), retired_(NULL), overflow_(0), references_(1u)
+		{
+		}
+
+		MemoryArena_::~MemoryArena_() {
+			freeRetired();
+
+			while(block_) {
+				Block_* previous = block_->previous;
+
+				alignedFree(block_);
+				block_ = previous;
+			}
+		}
+
+		void
+		MemoryArena_::release() {
+			if(references_.fetch_sub(1u, std::memory_order_acq_rel) == 1u) {
+				delete this;
+			}
+		}
+
+		void
+		MemoryArena_::freeRetired() {
+			void* retired = retired_.exchange(NULL, std::memory_order_acquire);
+
+			while(retired) {
+				void* next = *(void**)retired;
+
+				alignedFree(retired);
+				retired = next;
+			}
+		}
+
+		bool
+		MemoryArena_::reserve(size_t bytes) {
+			freeRetired();
+
+			bytes = alignedSize(bytes);
+
+			if(bytes <= available()) {
+				return(true);
+			}
+
+			Block_* block = (Block_*)alignedAlloc(kBlockHeaderSize + bytes);
+
+			if(block == NULL) {
+				return(false);
+			}
+
+			block->previous = block_;
+			block->capacity = bytes;
+			block->used = 0;
+
+			block_ = block;
+
+			return(true);
+		}
+
+		void*
+		MemoryArena_::allocate(size_t bytes) {
+			bytes = alignedSize(Max(bytes, (size_t)1));
+
+			if(bytes > available()) {
+				return(NULL);
+			}
+
+			void* memory = (char*)block_ + kBlockHeaderSize + block_->used;
+			block_->used += bytes;
+
+			return(memory);
+		}
+
+		void
+		MemoryArena_::retire(void* memory) {
+			//Buffers from alignedAlloc() are at least one cache line, so the link always fits.
+			void* head = retired_.load(std::memory_order_relaxed);
+
+			do {
+				*(void**)memory = head;
+			} while(!retired_.compare_exchange_weak(head, memory, std::memory_order_release, std::memory_order_relaxed));
+		}
+
+		MemoryArena_*
+		currentMemoryArena() {
+			return(currentArena_);
+		}
+
+		MemoryArenaScope_::MemoryArenaScope_(MemoryArena_* arena) :
+			previous_(currentArena_)
+		{
+			currentArena_ = arena;
+		}
+
+		MemoryArenaScope_::~MemoryArenaScope_() {
+			currentArena_ = previous_;
+		}
+	}
+}
\ No newline at end of file
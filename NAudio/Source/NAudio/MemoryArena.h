@@ -0,0 +1,111 @@
+#pragma once
+
+#include "NAudioCore.h"
+
+#include <atomic>
+
+namespace NAudio {
+	//Alignment of every sample buffer, one cache line. Wide enough for aligned AVX-512 loads.
+	static const size_t kMemoryAlignment = 64;
+
+	//Heap memory aligned to kMemoryAlignment, rounded up to whole cache lines. Returns NULL if out of memory.
+	void*
+	alignedAlloc(size_t bytes);
+
+	void
+	alignedFree(void* memory);
+
+	namespace NAudio_DSP {
+		//Memory for the buffers a graph grows while it runs, such as generator blocks after a block size change or delay lines after a sample rate change.
+		//Reserved up front by the control side, then handed out by the audio thread with a pointer bump, so growing a buffer never calls the system allocator.
+		//Memory is only returned when the arena itself is deleted, which happens once its owner and every buffer using it let go (see retain()).
+		//NOTE: reserve() MUST NOT RUN WHILE THE GRAPH IS BEING TICKED. allocate() IS ONLY CALLED BY THE THREAD TICKING THE GRAPH.
+		class MemoryArena_ {
+		private:
+			//Blocks are chained through a header at their start. Only the newest one is allocated from.
+			struct Block_ {
+				Block_* previous;
+				size_t capacity;
+				size_t used;
+			};
+
+			Block_* block_;
+
+			//Heap buffers given up by the audio thread, freed later by the control side. Chained through their first bytes.
+			std::atomic<void*> retired_;
+
+			//Bytes that did not fit and came from the heap instead.
+			std::atomic<size_t> overflow_;
+
+			std::atomic<unsigned int> references_;
+
+			MemoryArena_(const MemoryArena_&);
+			MemoryArena_& operator=(const MemoryArena_&);
+
+			//Deleted by the last release().
+			~MemoryArena_();
+
+			void
+			freeRetired();
+
+		public:
+			//Starts empty, with one reference held by the caller.
+			MemoryArena_();
+
+			void
+			retain() {
+				references_.fetch_add(1u, std::memory_order_relaxed);
+			}
+
+			void
+			release();
+
+			//Control side. Make sure at least bytes can be allocated. Also frees retired heap buffers. Returns false if out of memory.
+			bool
+			reserve(size_t bytes);
+
+			//Audio thread. Aligned memory from the newest block, or NULL if it does not fit. Never calls the system allocator.
+			void*
+			allocate(size_t bytes);
+
+			//Audio thread. Take a buffer from alignedAlloc() that is no longer used, to be freed by the control side.
+			void
+			retire(void* memory);
+
+			//Audio thread. Count bytes that had to come from the heap.
+			void
+			addOverflow(size_t bytes) {
+				overflow_.fetch_add(bytes, std::memory_order_relaxed);
+			}
+
+			//Bytes still free in the newest block.
+			size_t
+			available() const {
+				return(block_ ? block_->capacity - block_->used : 0);
+			}
+
+			//Total bytes that had to come from the heap. Reserve at least this much more next time.
+			size_t
+			overflow() const {
+				return(overflow_.load(std::memory_order_relaxed));
+			}
+		};
+
+		//Arena used by buffers grown on this thread, or NULL if there is none.
+		MemoryArena_*
+		currentMemoryArena();
+
+		//Makes arena the current arena of this thread until it goes out of scope. BufferFiller_ sets one around every block.
+		class MemoryArenaScope_ {
+		private:
+			MemoryArena_* previous_;
+
+			MemoryArenaScope_(const MemoryArenaScope_&);
+			MemoryArenaScope_& operator=(const MemoryArenaScope_&);
+
+		public:
+			MemoryArenaScope_(MemoryArena_* arena);
+			~MemoryArenaScope_();
+		};
+	}
+}
\ No newline at end of file
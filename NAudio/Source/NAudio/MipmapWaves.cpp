@@ -0,0 +1,41 @@
+#include "MipmapWaves.h"
+
+namespace NAudio {
+	//Fourier series of the ideal waveforms, which swing between -1 and 1.
+	static float
+	sawtoothHarmonic(unsigned int harmonic) {
+		return(((harmonic & 1) ? 2.0f : -2.0f) / (PI * (float)harmonic));
+	}
+
+	static float
+	squareHarmonic(unsigned int harmonic) {
+		return((harmonic & 1) ? 4.0f / (PI * (float)harmonic) : 0.0f);
+	}
+
+	static float
+	triangleHarmonic(unsigned int harmonic) {
+		if((harmonic & 1) == 0) {
+			return(0.0f);
+		}
+
+		return((((harmonic >> 1) & 1) ? -8.0f : 8.0f) / (PI * PI * (float)(harmonic * harmonic)));
+	}
+
+	SawtoothWaveMipmap::SawtoothWaveMipmap() {
+		static std::string const NAUDIO_SAW_MIPMAP_TABLE = "_NAUDIO_SAW_MIPMAP_TABLE_";
+
+		this->gen()->setMipmappedTable(NAudio_DSP::mipmappedOscillatorTable(NAUDIO_SAW_MIPMAP_TABLE, sawtoothHarmonic));
+	}
+
+	SquareWaveMipmap::SquareWaveMipmap() {
+		static std::string const NAUDIO_SQUARE_MIPMAP_TABLE = "_NAUDIO_SQUARE_MIPMAP_TABLE_";
+
+		this->gen()->setMipmappedTable(NAudio_DSP::mipmappedOscillatorTable(NAUDIO_SQUARE_MIPMAP_TABLE, squareHarmonic));
+	}
+
+	TriangleWaveMipmap::TriangleWaveMipmap() {
+		static std::string const NAUDIO_TRIANGLE_MIPMAP_TABLE = "_NAUDIO_TRIANGLE_MIPMAP_TABLE_";
+
+		this->gen()->setMipmappedTable(NAudio_DSP::mipmappedOscillatorTable(NAUDIO_TRIANGLE_MIPMAP_TABLE, triangleHarmonic));
+	}
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "TableLookupOsc.h"
+
+namespace NAudio {
+	//Band-limited oscillators at table lookup cost. Each reads a per-octave mipmapped table, generated the first time one is created and shared by all of them.
+	//The level is picked from the frequency and blended with the next one across the octave, so no harmonic passes Nyquist even while the frequency is swept.
+	//Unlike SawtoothWaveBL and SquareWaveBL there's no per-discontinuity work, but the waveform can't be changed at run time (no PWM or slope).
+	//The highest harmonics fade out over the octave below Nyquist.
+
+	//Band-limited rising saw.
+	class SawtoothWaveMipmap : public TemplatedGenerator<NAudio_DSP::TableLookupOsc_> {
+	public:
+		SawtoothWaveMipmap();
+
+		NAUDIO_MAKE_GEN_SETTERS(SawtoothWaveMipmap, freq, setFrequency);
+	};
+
+	//Band-limited square wave.
+	class SquareWaveMipmap : public TemplatedGenerator<NAudio_DSP::TableLookupOsc_> {
+	public:
+		SquareWaveMipmap();
+
+		NAUDIO_MAKE_GEN_SETTERS(SquareWaveMipmap, freq, setFrequency);
+	};
+
+	//Band-limited triangle wave.
+	class TriangleWaveMipmap : public TemplatedGenerator<NAudio_DSP::TableLookupOsc_> {
+	public:
+		TriangleWaveMipmap();
+
+		NAUDIO_MAKE_GEN_SETTERS(TriangleWaveMipmap, freq, setFrequency);
+	};
+}
\ No newline at end of file
@@ -1,24 +1,130 @@
 #include "Mixer.h"
 
+#include <chrono>
+
 namespace NAudio {
 	namespace NAudio_DSP {
-		Mixer_::Mixer_() {
-			workSpace_.Resize(kSynthesisBlockSize, 2u, 0.0f);
+		//Every this many blocks, the mode currently judged slower is run once so both time estimates follow the load.
+		//Each probe that loses doubles the interval, up to kMixerMaxProbeInterval, so a mode that keeps missing its deadline is hardly ever tried.
+		static const unsigned long kMixerProbeInterval = 64;
+		static const unsigned long kMixerMaxProbeInterval = 64 * 1024;
+
+		//Weight of the newest block in the running time averages.
+		static const double kMixerTimeSmoothing = 0.1;
+
+		Mixer_::Mixer_() :
+			currentInputs_(NULL), currentContext_(NULL), serialBlockTime_(0.0), parallelBlockTime_(0.0),
+			probeInterval_(kMixerProbeInterval), blocksUntilProbe_(kMixerProbeInterval)
+		{
+		}
+
+		void
+		Mixer_::computeSynthesisBlock(const SynthesisContext_& context) {
+			//Clear buffer.
+			outputFrames_.Clear();
+
+			MixerInputs_& inputs = inputs_.current();
+
+			if(!inputs.pool || inputs.inputs.size() < 2) {
+				mixSerial(inputs, context);
+				return;
+			}
+
+			//Use the faster mode, but never parallel if it can't meet the block deadline.
+			const double deadline = (double)context.blockSize / context.sampleRate;
+			bool parallel = (parallelBlockTime_ <= serialBlockTime_ && parallelBlockTime_ < deadline);
+
+			const bool probe = (--blocksUntilProbe_ == 0);
+
+			if(probe) {
+				parallel = !parallel;
+			}
+
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+			if(parallel) {
+				mixParallel(inputs, context);
+			}
+			else {
+				mixSerial(inputs, context);
+			}
+
+			double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			double& estimate = parallel ? parallelBlockTime_ : serialBlockTime_;
+
+			if(probe) {
+				//Back off while the probed mode keeps losing, probe at the normal rate again once it wins.
+				const double otherEstimate = parallel ? serialBlockTime_ : parallelBlockTime_;
+				const bool lost = (elapsed >= otherEstimate) || (parallel && elapsed >= deadline);
+
+				probeInterval_ = lost ? Min(probeInterval_ * 2, kMixerMaxProbeInterval) : kMixerProbeInterval;
+				blocksUntilProbe_ = probeInterval_;
+			}
+
+			estimate = (estimate == 0.0) ? elapsed : estimate + kMixerTimeSmoothing * (elapsed - estimate);
+		}
+
+		void
+		Mixer_::renderInputTask(size_t index, void* userData) {
+			Mixer_* mixer = static_cast<Mixer_*>(userData);
+
+			mixer->currentInputs_->views[index] = &mixer->currentInputs_->inputs[index].tickView(*mixer->currentContext_);
+		}
+
+		void
+		Mixer_::publishInputs(MixerInputs_* next) {
+			next->views.assign(next->inputs.size(), NULL);
+			inputs_.publish(next);
 		}
 
 		void
 		Mixer_::addInput(BufferFiller input) {
-			//No checking for duplicates, maybe we should.
-			inputs_.push_back(input);
+			lockMutex();
+			{
+				MixerInputs_* next = new MixerInputs_(inputs_.latest());
+
+				//No checking for duplicates, maybe we should.
+				next->inputs.push_back(input);
+				publishInputs(next);
+			}
+			unlockMutex();
 		}
 
 		void
 		Mixer_::removeInput(BufferFiller input) {
-			vector<BufferFiller>::iterator it = std::find(inputs_.begin(), inputs_.end(), input);
+			lockMutex();
+			{
+				MixerInputs_* next = new MixerInputs_(inputs_.latest());
+				vector<BufferFiller>::iterator it = std::find(next->inputs.begin(), next->inputs.end(), input);
+
+				if(it != next->inputs.end()) {
+					next->inputs.erase(it);
+					publishInputs(next);
+				}
+				else {
+					delete next;
+				}
+			}
+			unlockMutex();
+		}
+
+		void
+		Mixer_::setNumWorkers(unsigned int numWorkers, bool pinThreads) {
+			lockMutex();
+			{
+				MixerInputs_* next = new MixerInputs_(inputs_.latest());
+
+				//The old pool is joined when the last state using it is deleted, which always happens on a control thread.
+				if(numWorkers > 0) {
+					next->pool.reset(new WorkerPool(numWorkers, pinThreads));
+				}
+				else {
+					next->pool.reset();
+				}
 
-			if(it != inputs_.end()) {
-				inputs_.erase(it);
+				publishInputs(next);
 			}
+			unlockMutex();
 		}
 	}
 }
\ No newline at end of file
@@ -2,20 +2,62 @@
 
 #include "Synth.h"
 #include "CompressorLimiter.h"
+#include "WorkerPool.h"
+
+#include <memory>
 
 using std::vector;
 
 namespace NAudio {
 	namespace NAudio_DSP {
+		//Part of a Mixer_ that can be replaced while the mixer is running. Swapped as a whole through a SwapSlot.
+		struct MixerInputs_ {
+			std::vector<BufferFiller> inputs;
+
+			//Output of each input for the current block, filled in by the parallel renderer. Always the same size as inputs.
+			std::vector<const NAudioFrames*> views;
+
+			//Workers for parallel rendering, or empty for serial rendering. Shared by every copy of the state, released on a control thread.
+			std::shared_ptr<WorkerPool> pool;
+		};
+
 		//A mixer is like an adder but acts as a source and allows dynamic removal.
 		class Mixer_ : public BufferFiller_ {
 		private:
-			NAudioFrames workSpace_;
-			std::vector<BufferFiller> inputs_;
+			SwapSlot<MixerInputs_> inputs_;
+
+			//Block being rendered, for the worker tasks.
+			MixerInputs_* currentInputs_;
+			const SynthesisContext_* currentContext_;
+
+			//Running averages of how long a block takes in each mode, in seconds. Used to fall back to serial when parallel dispatch doesn't pay off.
+			double serialBlockTime_;
+			double parallelBlockTime_;
+
+			//Blocks between runs of the slower mode, doubled after every run that loses again, and blocks left until the next one.
+			unsigned long probeInterval_;
+			unsigned long blocksUntilProbe_;
 
 			void
 			computeSynthesisBlock(const SynthesisContext_& context);
 
+			void
+			processCommands(const SynthesisContext_&) {
+				inputs_.update();
+			}
+
+			void
+			publishInputs(MixerInputs_* next);
+
+			void
+			mixSerial(MixerInputs_& inputs, const SynthesisContext_& context);
+
+			void
+			mixParallel(MixerInputs_& inputs, const SynthesisContext_& context);
+
+			static void
+			renderInputTask(size_t index, void* userData);
+
 		public:
 			Mixer_();
 
@@ -24,36 +66,69 @@ namespace NAudio {
 
 			void
 			removeInput(BufferFiller input);
+
+			void
+			setNumWorkers(unsigned int numWorkers, bool pinThreads);
 		};
 
 		inline void
-		Mixer_::computeSynthesisBlock(const SynthesisContext_& context) {
-			//Clear buffer.
-			outputFrames_.Clear();
+		Mixer_::mixSerial(MixerInputs_& inputs, const SynthesisContext_& context) {
+			bool silent = true;
 
 			//Tick and add inputs.
-			for(unsigned int i = 0; i < inputs_.size(); ++i) {
+			for(unsigned int i = 0; i < inputs.inputs.size(); ++i) {
 				//Tick each bufferFiller every time, with our context (for now).
-				inputs_[i].tick(workSpace_, context);
-				outputFrames_ += workSpace_;
+				const NAudioFrames& frames = inputs.inputs[i].tickView(context);
+
+				//Silent inputs add nothing.
+				if(!inputs.inputs[i].isSilent()) {
+					outputFrames_ += frames;
+					silent = false;
+				}
+			}
+
+			outputIsSilent_ = silent;
+		}
+
+		inline void
+		Mixer_::mixParallel(MixerInputs_& inputs, const SynthesisContext_& context) {
+			currentInputs_ = &inputs;
+			currentContext_ = &context;
+
+			inputs.pool->run(inputs.inputs.size(), &Mixer_::renderInputTask, this);
+
+			bool silent = true;
+
+			//Sum in input order so the output doesn't depend on which thread rendered what.
+			for(unsigned int i = 0; i < inputs.views.size(); ++i) {
+				if(!inputs.inputs[i].isSilent()) {
+					outputFrames_ += *inputs.views[i];
+					silent = false;
+				}
 			}
+
+			outputIsSilent_ = silent;
 		}
 	}
 
 	class Mixer : public TemplatedBufferFiller<NAudio_DSP::Mixer_> {
 	public:
+		//Does not block the audio thread, the new input list is swapped in at the next block.
 		void
 		addInput(BufferFiller input) {
-			gen()->lockMutex();
 			gen()->addInput(input);
-			gen()->unlockMutex();
 		}
 
 		void
 		removeInput(BufferFiller input) {
-			gen()->lockMutex();
 			gen()->removeInput(input);
-			gen()->unlockMutex();
+		}
+
+		//Render inputs in parallel on numWorkers pinned worker threads plus the audio thread. 0 renders serially (the default).
+		//Inputs must not share generators with each other. The mixer still uses serial rendering for blocks where the parallel path turns out to be slower.
+		void
+		setParallel(unsigned int numWorkers, bool pinThreads = true) {
+			gen()->setNumWorkers(numWorkers, pinThreads);
 		}
 	};
 }
\ No newline at end of file
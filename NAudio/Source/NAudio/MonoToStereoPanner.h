@@ -26,7 +26,7 @@ namespace NAudio {
 			float* synthBlockWriteHead = &outputFrames_[0];
 			float* dryFramesReadHead = &dryFrames_[0];
 
-			unsigned int nSamples = kSynthesisBlockSize;
+			unsigned int nSamples = outputFrames_.Frames();
 
 			float panValue = panControlGen.tick(context).value;
 			float leftVol = 1.0f - Max(0.0f, panValue);
@@ -63,25 +63,45 @@ namespace NAudio {
 	//DSP-level namespace.
 	//Objects under the NAudio_DSP namespace are internal DSP-level objects not intended for public usage.
 	namespace NAudio_DSP {
-		static float sampleRate_ = 44100.f;   
+		//Process-wide default sample rate. A function-local static in an inline function, so every translation unit shares the same value.
+		inline float& defaultSampleRate() {
+			static float sampleRate = 44100.f;
+			return(sampleRate);
+		}
 	}
   
 	//Global constants.
   
-	//Set the operational sample rate.
-	//NOTE: CHANGING WHILE RUNNING WILL RESULT IN UNDEFINED BEHAVIOR. MUST BE SET PRIOR TO OBJECT ALLOCATION.
-	static void setSampleRate(float sampleRate) {
-		NAudio_DSP::sampleRate_ = sampleRate;
+	//Set the default sample rate, used by new synthesis contexts and by code that runs outside of a graph (allocation, file I/O).
+	//Graphs run at the rate of their context, see SynthesisContext_::sampleRate and BufferFiller::setSampleRate.
+	inline static void setSampleRate(float sampleRate) {
+		NAudio_DSP::defaultSampleRate() = sampleRate;
 	}
   
-	//Return sample rate.
-	static float SampleRate() {
-		return(NAudio_DSP::sampleRate_);
+	//Return the default sample rate.
+	inline static float SampleRate() {
+		return(NAudio_DSP::defaultSampleRate());
 	};
 	
-	//"Vector" size for audio processing. ControlGenerators update at this rate.
-	//THIS VALUE SHOULD BE A POWER-OF-TWO WHICH IS LESS THAN THE HARDWARE BUFFER SIZE.
+	//Default "vector" size for audio processing. ControlGenerators update at this rate.
+	//Each graph can run at its own block size (see SynthesisContext_::blockSize and BufferFiller::setBlockSize).
+	//THE BLOCK SIZE SHOULD BE A POWER-OF-TWO WHICH IS LESS THAN THE HARDWARE BUFFER SIZE.
 	static const unsigned int kSynthesisBlockSize = 64;
+
+	//Range of block sizes a graph can run at.
+	static const unsigned int kMinSynthesisBlockSize = 16;
+	static const unsigned int kMaxSynthesisBlockSize = 2048;
+
+	//Highest oversampling factor (see Oversampled). Subgraphs run at up to this many times the block size of their graph.
+	static const unsigned int kMaxOversamplingFactor = 8;
+
+	//Largest block any graph, subgraphs included, runs at.
+	static const unsigned int kMaxNestedBlockSize = kMaxSynthesisBlockSize * kMaxOversamplingFactor;
+
+	//True if blockSize is a power of two in [kMinSynthesisBlockSize, kMaxSynthesisBlockSize].
+	inline static bool isValidSynthesisBlockSize(unsigned int blockSize) {
+		return(blockSize >= kMinSynthesisBlockSize && blockSize <= kMaxSynthesisBlockSize && (blockSize & (blockSize - 1)) == 0);
+	}
   
 	//Global Types.
   
@@ -92,6 +112,8 @@ namespace NAudio {
 	};
   
 	namespace NAudio_DSP {
+		class GraphSchedule_;
+
 		//Context which defines a particular synthesis graph.
 		//Context passed down from root BufferFiller graph object to all sub-generators. Synchronizes signal flow in cases when generator output is shared between multiple inputs.
 		struct SynthesisContext_ {
@@ -101,15 +123,24 @@ namespace NAudio {
 			//If true, generators will be forced to compute fresh output.
 			//TODO: Not fully implmenented yet.
 			bool forceNewOutput;
+
+			//Number of frames computed per block. Generators size their buffers to it the first time they compute a block at that size.
+			unsigned int blockSize;
+
+			//Sample rate of this graph. Generators derive their coefficients, phase increments and delay lengths from it, not from the default SampleRate().
+			float sampleRate;
+
+			//If not NULL, every generator ticked with this context is recorded into this schedule (see GraphSchedule_).
+			GraphSchedule_* recorder;
             
 			SynthesisContext_() :
-				elapsedFrames(0), elapsedTime(0), forceNewOutput(true)
+				elapsedFrames(0), elapsedTime(0), forceNewOutput(true), blockSize(kSynthesisBlockSize), sampleRate(SampleRate()), recorder(NULL)
 			{
 			}
 			
 			void tick() {
-				elapsedFrames += kSynthesisBlockSize;
-				elapsedTime = (double)elapsedFrames / SampleRate();
+				elapsedFrames += blockSize;
+				elapsedTime = (double)elapsedFrames / sampleRate;
 				
 				forceNewOutput = false;
 			}
@@ -139,6 +170,62 @@ namespace NAudio {
 	inline static float DBToLin(float dBFS) {
 		return(powf(10.f, (dBFS / 20.0f)));
 	}
+
+	//Base 2 logarithm from the float's exponent bits and a polynomial in its mantissa. Within 0.00005 (0.0003 dB) for normal numbers, exact at powers of 2, and 0 gives -127 instead of -inf.
+	//The dynamics kernels in NAudioSIMD run the same steps on whole blocks. Meant for levels and gains in dB, not for exact math.
+	inline static float fastLog2(float x) {
+		union {
+			float f;
+			unsigned int i;
+		} bits;
+
+		bits.f = x;
+
+		const float exponent = (float)((int)((bits.i >> 23) & 0xFF) - 127);
+
+		bits.i = (bits.i & 0x007FFFFF) | 0x3F800000;
+
+		const float t = bits.f - 1.0f;
+
+		return(exponent + t * (1.4424186f + t * (-0.7119966f + t * (0.4201112f + t * (-0.1954072f + t * 0.0448740f)))));
+	}
+
+	//2 to the power of x, from the exponent bits and a polynomial for the fraction. Within 6 parts per million and exact at integers, so a gain of 0 dB stays exactly 1. x is clamped to +-126.
+	inline static float fastExp2(float x) {
+		union {
+			float f;
+			unsigned int i;
+		} bits;
+
+		//Offset by the exponent bias, so truncating is flooring and the integer part is the biased exponent.
+		const float biased = Clamp(x, -126.0f, 126.0f) + 127.0f;
+		const int exponent = (int)biased;
+		const float t = biased - (float)exponent;
+
+		bits.i = (unsigned int)exponent << 23;
+
+		return(bits.f * (1.0f + t * (0.6931488f + t * (0.2401729f + t * (0.0558116f + t * (0.0089702f + t * 0.0018965f))))));
+	}
+
+	//One step of xoshiro128+ on the state words s[0], s[stride], s[2 * stride] and s[3 * stride]. The top bits of the output are the most random ones.
+	inline static unsigned int xoshiro128Next(unsigned int* s, size_t stride) {
+		const unsigned int result = s[0] + s[3 * stride];
+		const unsigned int t = s[stride] << 9;
+
+		s[2 * stride] ^= s[0];
+		s[3 * stride] ^= s[stride];
+		s[stride] ^= s[2 * stride];
+		s[0] ^= s[3 * stride];
+		s[2 * stride] ^= t;
+		s[3 * stride] = (s[3 * stride] << 11) | (s[3 * stride] >> 21);
+
+		return(result);
+	}
+
+	//Top 24 bits of a random word as a sample in [-1, 1). Exact, so the noise kernels give the same samples at every level.
+	inline static float randomWordToSample(unsigned int word) {
+		return((float)(word >> 8) * (1.0f / 8388608.0f) - 1.0f);
+	}
 	
 	//May want to implement custom exception behavior here, but for now, this is essentially a typedef.
 	class NAudioException : public std::runtime_error {
@@ -1,135 +1,172 @@
 #include "NAudioFrames.h"
 
 namespace NAudio {
-	NAudioFrames::NAudioFrames(unsigned int nFrames, unsigned int nChannels) :
-		nFrames(nFrames), nChannels(nChannels)
-	{
-		if(nChannels > 2) {
-			LOG(NLOG_ERROR, "Invalid number of channels. NFrames is limited to mono or stereo only (1 or 2 channels).");
-		}
-		
-		size = nFrames * nChannels;
-		bufferSize = size;
-		
-		if(size > 0) {
-			data = (float*)calloc(size, sizeof(float));
+	//Room for nSamples, from the current arena if it has it. Sets owner to the arena, or NULL for the heap.
+	static float*
+	allocateSamples(size_t nSamples, NAudio_DSP::MemoryArena_*& owner) {
+		const size_t bytes = nSamples * sizeof(float);
+		NAudio_DSP::MemoryArena_* current = NAudio_DSP::currentMemoryArena();
+
+		if(current) {
+			float* memory = (float*)current->allocate(bytes);
+
+			if(memory) {
+				current->retain();
+				owner = current;
 
-			if(data == NULL) {
-				LOG(NLOG_ERROR, "Memory allocation error in constructor!");
+				return(memory);
 			}
+
+			//The arena was reserved too small, fall back to the heap and report it.
+			current->addOverflow(bytes);
 		}
-		else {
-			data = 0;
+
+		owner = NULL;
+
+		return((float*)alignedAlloc(bytes));
+	}
+
+	//Let go of samples from allocateSamples(). Heap buffers dropped while an arena is current are handed to it, to be freed off the audio thread.
+	static void
+	releaseSamples(float* data, NAudio_DSP::MemoryArena_* owner) {
+		if(owner) {
+			//Arena memory is only reclaimed with the whole arena.
+			owner->release();
+		}
+		else if(data) {
+			NAudio_DSP::MemoryArena_* current = NAudio_DSP::currentMemoryArena();
+
+			if(current) {
+				current->retire(data);
+			}
+			else {
+				alignedFree(data);
+			}
 		}
+	}
+	
+	NAudioFrames::NAudioFrames(unsigned int nFrames, unsigned int nChannels) :
+		data(0), nFrames(0), nChannels(nChannels), size(0), bufferSize(0), arena(NULL)
+	{
+		Resize(nFrames, nChannels, 0.0f);
 		
 		dataRate = NAudio::SampleRate();
 	}
 	
 	NAudioFrames::NAudioFrames(const float& value, unsigned int nFrames, unsigned int nChannels) :
-		nFrames(nFrames), nChannels(nChannels)
+		data(0), nFrames(0), nChannels(nChannels), size(0), bufferSize(0), arena(NULL)
 	{
-		if(nChannels > 2) {
-			LOG(NLOG_ERROR, "Invalid number of channels. NFrames is limited to mono or stereo only (1 or 2 channels).");
-		}
-  
-		size = nFrames * nChannels;
-		bufferSize = size;
-		
-		if(size > 0) {
-			data = (float*)malloc(size * sizeof(float));
-			
-			if(data == NULL) {
-				LOG(NLOG_ERROR, "Memory allocation error in constructor!");
-			}
-			
-			for(long i = 0; i < (long)size; ++i) {
-				data[i] = value;
-			}
-		}
-		else {
-			data = 0;
-		}
+		Resize(nFrames, nChannels, value);
 		
 		dataRate = NAudio::SampleRate();
 	}
 
-	NAudioFrames::NAudioFrames(NAudioFrames& f) :
-		size(0), bufferSize(0)
+	NAudioFrames::NAudioFrames(const NAudioFrames& f) :
+		data(0), dataRate(f.dataRate), nFrames(0), nChannels(f.nChannels), size(0), bufferSize(0), arena(NULL)
 	{
-		Resize(f.Frames(), f.Channels());
-		dataRate = NAudio::SampleRate();
-
-		for(unsigned int i = 0; i < size; ++i) {
-			data[i] = f[i];
+		if(Resize(f.nFrames, f.nChannels) && size > 0) {
+			memcpy(data, f.data, size * sizeof(float));
 		}
 	}
 
 	NAudioFrames::~NAudioFrames() {
-		if(data) {
-			free(data);
-		}
+		releaseSamples(data, arena);
 	}
 	
 	NAudioFrames&
-	NAudioFrames::operator=(NAudioFrames& f) {
-		size = 0;
-		bufferSize = 0;
-		
-		Resize(f.Frames(), f.Channels());
-		dataRate = NAudio::SampleRate();
-		
-		for(unsigned int i = 0; i < size; ++i) {
-			data[i] = f[i];
+	NAudioFrames::operator=(const NAudioFrames& f) {
+		if(this != &f && Resize(f.nFrames, f.nChannels)) {
+			if(size > 0) {
+				memcpy(data, f.data, size * sizeof(float));
+			}
+
+			dataRate = f.dataRate;
 		}
 		
 		return(*this);
 	}
-	
-	void
+
+#if NAUDIO_HAS_CPP_11
+	NAudioFrames::NAudioFrames(NAudioFrames&& f) :
+		data(f.data), dataRate(f.dataRate), nFrames(f.nFrames), nChannels(f.nChannels), size(f.size), bufferSize(f.bufferSize), arena(f.arena)
+	{
+		f.data = 0;
+		f.arena = NULL;
+		f.nFrames = 0;
+		f.size = 0;
+		f.bufferSize = 0;
+	}
+
+	NAudioFrames&
+	NAudioFrames::operator=(NAudioFrames&& f) {
+		if(this != &f) {
+			releaseSamples(data, arena);
+
+			data = f.data;
+			arena = f.arena;
+			dataRate = f.dataRate;
+			nFrames = f.nFrames;
+			nChannels = f.nChannels;
+			size = f.size;
+			bufferSize = f.bufferSize;
+
+			f.data = 0;
+			f.arena = NULL;
+			f.nFrames = 0;
+			f.size = 0;
+			f.bufferSize = 0;
+		}
+
+		return(*this);
+	}
+#endif
+
+	bool
 	NAudioFrames::Resize(size_t nFrames, unsigned int nChannels) {
 		if(nChannels > 2) {
 			LOG(NLOG_ERROR, "Invalid number of channels. NFrames is limited to mono or stereo only (1 or 2 channels).");
 		}
 
 		if(this->nFrames != nFrames || this->nChannels != nChannels) {
-			this->nFrames = nFrames;
-			this->nChannels = nChannels;
-			
-			//Preserve as much of old data as we can.
-			float* oldData = data;
-			unsigned long oldSize = (unsigned long)size;
-
-			size = nFrames * nChannels;
+			const size_t newSize = nFrames * nChannels;
 
-			if(size > bufferSize) {
-				data = (float*)malloc(size * sizeof(float));
+			if(newSize > bufferSize) {
+				NAudio_DSP::MemoryArena_* newArena = NULL;
+				float* newData = allocateSamples(newSize, newArena);
 
-				if(oldData) {
-					for(unsigned int i = 0; i < oldSize; ++i) {
-						data[i] = oldData[i];
-					}
+				if(newData == NULL) {
+					return(false);
 				}
-				
-				if(data == NULL) {
-					LOG(NLOG_ERROR, "Memory allocation error!");
-				}
-				
-				bufferSize = size;
-				
-				if(oldData) {
-					free(oldData);
+
+				//Preserve as much of old data as we can.
+				if(data) {
+					memcpy(newData, data, size * sizeof(float));
 				}
+
+				releaseSamples(data, arena);
+
+				data = newData;
+				arena = newArena;
+				bufferSize = newSize;
 			}
+
+			this->nFrames = nFrames;
+			this->nChannels = nChannels;
+			size = newSize;
 		}
+
+		return(true);
 	}
 	
-	void
+	bool
 	NAudioFrames::Resize(size_t nFrames, unsigned int nChannels, float value) {
-		this->Resize(nFrames, nChannels);
-
-		for(size_t i = 0; i < size; ++i) {
-			data[i] = value;
+		if(!this->Resize(nFrames, nChannels)) {
+			return(false);
 		}
+
+		NAudio_DSP::SIMD().fill(data, value, size);
+
+		return(true);
 	}
   
 	void
@@ -138,25 +175,29 @@ namespace NAudio {
 			LOG(NLOG_ERROR, "Invalid number of channels. NFrames is limited to mono or stereo only (1 or 2 channels).");
 		}
     
-		if(nFrames != nFrames || nChannels != nChannels) {
+		if(this->nFrames != nFrames || this->nChannels != nChannels) {
+			NAudio_DSP::MemoryArena_* newArena = NULL;
+			float* newData = allocateSamples(nFrames * nChannels, newArena);
+
+			if(newData == NULL) {
+				return;
+			}
+
 			//Preserve as much of old data as we can.
 			float* oldData = data;
-			unsigned long oldFrames = (unsigned long)nFrames;
-			unsigned int oldchannels = nChannels;
+			NAudio_DSP::MemoryArena_* oldArena = arena;
+			unsigned long oldFrames = (unsigned long)this->nFrames;
+			unsigned int oldchannels = this->nChannels;
       
-			nFrames = nFrames;
-			nChannels = nChannels;
+			this->nFrames = nFrames;
+			this->nChannels = nChannels;
       
 			size = nFrames * nChannels;
-        
-			data = (float*)malloc(size * sizeof(float));
-      
-			if(data == NULL) {
-				LOG(NLOG_ERROR, "Memory allocation error!");
-			}
+			data = newData;
+			arena = newArena;
 			
 			//Resample the content (brute-force, no AA applied).
-			if(oldData) {
+			if(oldData && oldFrames > 0) {
 				float inc = (float)oldFrames / nFrames;
 				
 				for(unsigned int c = 0; c < nChannels; ++c) {
@@ -168,24 +209,22 @@ namespace NAudio {
 						float y2;
 						
 						float frac = modff(fIdx, &fi);
-						unsigned int idx = (unsigned int)fi;
+						unsigned int idx = Min((unsigned int)fi, (unsigned int)oldFrames - 1);
+
+						//The last frame has nothing after it to interpolate towards.
+						unsigned int nextIdx = Min(idx + 1, (unsigned int)oldFrames - 1);
             
 						unsigned int ocIdx = (oldchannels > 1) ? c : 0;
             
-						if(idx == oldFrames - 1) {
-							data[i * nChannels + c] = oldData[idx * oldchannels + ocIdx];
-						}
-						else {
-							y1 = oldData[idx * oldchannels + ocIdx];
-							y2 = oldData[(idx + 1) * oldchannels + ocIdx];
-							data[i * nChannels + c] = y1 + frac * (y2 - y1);
-						}
+						y1 = oldData[idx * oldchannels + ocIdx];
+						y2 = oldData[nextIdx * oldchannels + ocIdx];
+						data[i * nChannels + c] = y1 + frac * (y2 - y1);
 						
 						//Handle different channel mapping.
 						if(oldchannels > nChannels) {
 							//Add and average.
 							y1 = oldData[idx * oldchannels + ocIdx + 1];
-							y2 = oldData[(idx+1) * oldchannels + ocIdx + 1];
+							y2 = oldData[nextIdx * oldchannels + ocIdx + 1];
 							data[i * nChannels + c] += (y1 + frac * (y2 - y1));
 							data[i * nChannels + c] *= 0.5f;
 						}
@@ -196,10 +235,8 @@ namespace NAudio {
 			}
 
 			bufferSize = size;
-			
-			if(oldData) {
-				free(oldData);
-			}
+
+			releaseSamples(oldData, oldArena);
 		}
 	}
 	
@@ -1,9 +1,13 @@
 #pragma once
 
 #include "NAudioCore.h"
+#include "NAudioSIMD.h"
+#include "MemoryArena.h"
 
 //This is heavily inspired in STKFrames, of the STK++ Toolkit. See: https://ccrma.stanford.edu/software/stk/
 namespace NAudio {
+	//Samples are aligned to kMemoryAlignment. Buffers grown while a BufferFiller ticks come from its memory arena when it has room (see BufferFiller::reserveMemory()).
+	//If memory runs out, the constructors leave the frames empty and Resize() returns false, keeping the old size and data.
 	class NAudioFrames {
 	protected:
 		float* data;
@@ -15,13 +19,23 @@ namespace NAudio {
 		size_t size;
 		size_t bufferSize;
 
+		//Arena data was taken from, or NULL if it came from the heap. Holds a reference to it.
+		NAudio_DSP::MemoryArena_* arena;
+
 	public:
 		NAudioFrames(unsigned int nFrames = 0, unsigned int nChannels = 0);
 		NAudioFrames(const float& value, unsigned int nFrames, unsigned int nChannels);
-		NAudioFrames(NAudioFrames& f);
+		NAudioFrames(const NAudioFrames& f);
 		virtual ~NAudioFrames();
 		
-		NAudioFrames& operator=(NAudioFrames& f);
+		//Reuses the existing buffer when it is large enough. Leaves self unchanged if memory runs out.
+		NAudioFrames& operator=(const NAudioFrames& f);
+
+#if NAUDIO_HAS_CPP_11
+		//Take the buffer of f without copying, leaving f empty.
+		NAudioFrames(NAudioFrames&& f);
+		NAudioFrames& operator=(NAudioFrames&& f);
+#endif
 		
 		//The result can be used as an lvalue. This reference is valid until the resize function is called or the array is destroyed.
 		//The index n must be between 0 and size less one. No range checking is performed unless DEBUG is defined.
@@ -29,10 +43,15 @@ namespace NAudio {
 		float operator[](size_t n) const;		//TODO: See if it can be removed.
 
 		//The dimensions of the argument are expected to be the same as self. No range checking is performed unless DEBUG is defined.
-		void operator+=(NAudioFrames& f);
-		void operator-=(NAudioFrames& f);
-		void operator*=(NAudioFrames& f);
-		void operator/=(NAudioFrames& f);
+		void operator+=(const NAudioFrames& f);
+		void operator-=(const NAudioFrames& f);
+		void operator*=(const NAudioFrames& f);
+		void operator/=(const NAudioFrames& f);
+
+		//Apply a single value to every sample, for inputs known to be constant over the block.
+		void operator+=(float value);
+		void operator-=(float value);
+		void operator*=(float value);
 		
 		//The result can be used as an lvalue. This reference is valid until the resize function is called or the array is destroyed.
 		//The frame index must be between 0 and frames() - 1.
@@ -51,12 +70,16 @@ namespace NAudio {
 		//Clear the frames data.
 		void
 		Clear();
+
+		//Set every sample to value.
+		void
+		Fill(float value);
     
 		//Fill frames from other source. Copies channels from one object to another. Frame count must match.
 		//If source has more channels than destination, they will be averaged.
 		//If destination has more channels than source, they will be copied to all channels.
 		void
-		Copy(NAudioFrames& f);
+		Copy(const NAudioFrames& f);
         
 		//Return an interpolated value at the fractional frame index and channel. This function performs linear interpolation. 
 		//The frame index must be between 0.0 and frames() - 1. The \c channel index must be between 0 and channels() - 1. No range checking is performed unless DEBUG is defined.
@@ -65,10 +88,16 @@ namespace NAudio {
 		
 		//Returns the total number of audio samples represented by the object.
 		size_t
-		Size() {
+		Size() const {
 			return(size);
 		}; 
 		
+		//Read-only pointer to the first sample. Valid until the frames are resized or destroyed.
+		const float*
+		Data() const {
+			return(data);
+		}
+
 		//Returns true if the object size is zero and false otherwise.
 		bool
 		Empty();
@@ -76,14 +105,16 @@ namespace NAudio {
 		//Resize self to represent the specified number of channels and frames. Changes the size of self based on the number of frames and channels.
 		//No element assignment is performed. No memory deallocation occurs if the new size is smaller than the previous size.
 		//Further, no new memory is allocated when the new size is smaller or equal to a previously allocated size.
-		void
+		//Returns false if memory ran out, in which case self is left as it was.
+		bool
 		Resize(size_t nFrames, unsigned int nChannels = 1);
 		
 		//Resize self to represent the specified number of channels and frames and perform element initialization.
 		//Changes the size of self based on the number of frames and channels, and assigns value to every element.
 		//No memory deallocation occurs if the new size is smaller than the previous size.
 		//Further, no new memory is allocated when the new size is smaller or equal to a previously allocated size.
-		void
+		//Returns false if memory ran out, in which case self is left as it was.
+		bool
 		Resize(size_t nFrames, unsigned int nChannels, float value);
     
 		//Resize and stretch/shrink existing data to fit new size.
@@ -92,13 +123,13 @@ namespace NAudio {
 		
 		//Return the number of channels represented by the data.
 		inline unsigned int
-		Channels() {
+		Channels() const {
 			return(nChannels);
 		}
 		
 		//Return the number of sample frames represented by the data.
 		inline unsigned long
-		Frames() {
+		Frames() const {
 			return((unsigned long)nFrames);
 		}
 		
@@ -178,174 +209,127 @@ namespace NAudio {
 	}
   
 	inline void
-	NAudioFrames::Copy(NAudioFrames& f) {
+	NAudioFrames::Fill(float value) {
+		NAudio_DSP::SIMD().fill(data, value, size);
+	}
+
+	inline void
+	NAudioFrames::Copy(const NAudioFrames& f) {
 		if(f.Frames() != nFrames) {
 			LOG(NLOG_ERROR, "Frames argument must be of equal dimensions!");
 		}
     
 		unsigned int fChannels = f.Channels();
-		
-		float* dptr = data;
-		float* fptr = &f[0];
     
 		if(nChannels == fChannels) {
-			memcpy(dptr, fptr, size * sizeof(float));
+			memcpy(data, f.data, size * sizeof(float));
 		}
 		else if(nChannels < fChannels) {
-			//Sum channels.
-			memset(dptr, 0, size * sizeof(float));
-			
-			for(unsigned int c = 0; c < fChannels; ++c) {
-				dptr = data;
-				fptr = &f(0, c);
-				
-				for(unsigned int i = 0; i < nFrames; ++i, dptr += nChannels, fptr += fChannels) {
-					*dptr += *fptr;
-				}
-			}
-      
-			//Apply scaling (average of channels).
-			float s = 1.0f / fChannels;
-			dptr = data;
-			
-			for(unsigned int i = 0; i < nFrames; ++i, dptr += nChannels) {
-				*dptr *= s;
-			}
+			//Average of channels.
+			NAudio_DSP::SIMD().downmix(data, f.data, nFrames);
 		}
 		else {
-			//Just copy one channel, then fill.
-			VectorCpy(dptr, nChannels, fptr, fChannels, (unsigned int)nFrames);
-      
-			//Fill all channels if necessary.
-			FillChannels();
+			//Copy the single channel to both channels.
+			NAudio_DSP::SIMD().upmix(data, f.data, nFrames);
 		}
 	}
 	
 	inline void
-	NAudioFrames::operator+=(NAudioFrames& f) {
+	NAudioFrames::operator+=(const NAudioFrames& f) {
 		if(f.Frames() != nFrames) {
 			LOG(NLOG_ERROR, "Frames argument must be of equal dimensions!");
 		}
     
-		float* fptr = &f[0];
-		float* dptr = data;
-    
 		unsigned int fChannels = f.Channels();
     
 		if(nChannels == fChannels) {
-			for(unsigned int i = 0; i < size; ++i) {
-				*dptr++ += *fptr++;
-			}
+			NAudio_DSP::SIMD().add(data, f.data, size);
 		}
 		else if(nChannels < fChannels) {
 			//Just add first channel of rhs.
-			for(unsigned int i = 0; i < nFrames; ++i) {
-				*dptr++ -= *fptr++;
-				fptr++;
-			}
+			NAudio_DSP::SIMD().addLeft(data, f.data, nFrames);
 		}
 		else {
 			//Add rhs to both channels.
-			for(unsigned int i = 0; i < nFrames; ++i) {
-				*dptr++ += *fptr;
-				*dptr++ += *fptr++;
-			}
+			NAudio_DSP::SIMD().addMono(data, f.data, nFrames);
 		}
 	}
 	
 	inline void
-	NAudioFrames::operator-=(NAudioFrames& f) {
+	NAudioFrames::operator-=(const NAudioFrames& f) {
 		if(f.Frames() != nFrames) {
 			LOG(NLOG_ERROR, "Frames argument must be of equal dimensions!");
 		}
 		
-		float* fptr = &f[0];
-		float* dptr = data;
-		
 		unsigned int fChannels = f.Channels();
     
 		if(nChannels == fChannels) {
-			for(unsigned int i = 0; i < size; ++i) {
-				*dptr++ -= *fptr++;
-			}
+			NAudio_DSP::SIMD().sub(data, f.data, size);
 		}
 		else if(nChannels < fChannels) {
 			//Just subtract first channel of rhs.
-			for(unsigned int i = 0; i < nFrames; ++i) {
-				*dptr++ -= *fptr++;
-				fptr++;
-			}
+			NAudio_DSP::SIMD().subLeft(data, f.data, nFrames);
 		}
 		else {
 			//Subtract both channels by rhs.
-			for(unsigned int i = 0; i < nFrames; ++i) {
-				*dptr++ -= *fptr;
-				*dptr++ -= *fptr++;
-			}
+			NAudio_DSP::SIMD().subMono(data, f.data, nFrames);
 		}
 	}
   
 	inline void
-	NAudioFrames::operator*=(NAudioFrames& f) {
+	NAudioFrames::operator*=(const NAudioFrames& f) {
 		if(f.Frames() != nFrames) {
 			LOG(NLOG_ERROR, "Frames argument must be of equal dimensions!");
 		}
-    
-		float* fptr = &f[0];
-		float* dptr = data;
 		
 		unsigned int fChannels = f.Channels();
     
 		if(nChannels == fChannels) {
-			for(unsigned int i = 0; i < size; ++i) {
-				*dptr++ *= *fptr++;
-			}
+			NAudio_DSP::SIMD().mul(data, f.data, size);
 		}
 		else if(nChannels < fChannels) {
 			//Just multiply by first channel of rhs.
-			for(unsigned int i = 0; i < nFrames; ++i) {
-				*dptr++ *= *fptr++;
-				fptr++;
-			}
+			NAudio_DSP::SIMD().mulLeft(data, f.data, nFrames);
 		}
 		else {
 			//Multiply both channels by rhs.
-			for(unsigned int i = 0; i < nFrames; ++i) {
-				*dptr++ *= *fptr;
-				*dptr++ *= *fptr++;
-			}
+			NAudio_DSP::SIMD().mulMono(data, f.data, nFrames);
 		}
 	}
 	
 	inline void
-	NAudioFrames::operator/=(NAudioFrames& f) {
+	NAudioFrames::operator/=(const NAudioFrames& f) {
 		if(f.Frames() != nFrames) {
 			LOG(NLOG_ERROR, "Frames argument must be of equal dimensions!");
 		}
     
-		float* fptr = &f[0];
-		float* dptr = data;
-    
 		unsigned int fChannels = f.Channels();
     
 		if(nChannels == fChannels) {
-			for(unsigned int i = 0; i < size; ++i) {
-				*dptr++ /= *fptr++;
-			}
+			NAudio_DSP::SIMD().div(data, f.data, size);
 		}
 		else if(nChannels < fChannels) {
-			//Just multiply by first channel of rhs.
-			for(unsigned int i = 0; i < nFrames; ++i) {
-				*dptr++ /= *fptr++;
-				fptr++;
-			}
+			//Just divide by first channel of rhs.
+			NAudio_DSP::SIMD().divLeft(data, f.data, nFrames);
 		}
 		else {
-			//Multiply both channels by rhs.
-			for(unsigned int i = 0; i < nFrames; ++i) {
-				*dptr++ /= *fptr;
-				*dptr++ /= *fptr++;
-			}
+			//Divide both channels by rhs.
+			NAudio_DSP::SIMD().divMono(data, f.data, nFrames);
 		}
 	}
+
+	inline void
+	NAudioFrames::operator+=(float value) {
+		NAudio_DSP::SIMD().offset(data, value, size);
+	}
+
+	inline void
+	NAudioFrames::operator-=(float value) {
+		NAudio_DSP::SIMD().offset(data, -value, size);
+	}
+
+	inline void
+	NAudioFrames::operator*=(float value) {
+		NAudio_DSP::SIMD().scale(data, value, size);
+	}
 }
\ No newline at end of file
@@ -0,0 +1,2041 @@
+#include "NAudioSIMD.h"
+
+#if !defined(NAUDIO_DISABLE_SIMD)
+	//SSE2 is part of the x86-64 baseline (and of 32-bit builds compiled with SSE2 enabled).
+	#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+		#define NAUDIO_SIMD_SSE2 1
+		#include <emmintrin.h>
+
+		//AVX2 kernels are compiled with a per-function target and only selected if the CPU and OS support them.
+		#define NAUDIO_SIMD_AVX2 1
+		#include <immintrin.h>
+
+		#if defined(_MSC_VER) && !defined(__clang__)
+			#include <intrin.h>
+			#define NAUDIO_TARGET_AVX2
+		#else
+			#define NAUDIO_TARGET_AVX2 __attribute__((target("avx2")))
+		#endif
+	#endif
+
+	#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+		#define NAUDIO_SIMD_NEON 1
+		#include <arm_neon.h>
+	#endif
+#endif
+
+namespace NAudio {
+	namespace NAudio_DSP {
+		std::atomic<const SIMDKernels_*> s_simdKernels(NULL);
+
+		//Scalar kernels. Also used by the vector kernels to process the remainder of a block.
+		#define NAUDIO_SCALAR_BINARY(name, op)																\
+			static void																						\
+			name##Scalar(float* dst, const float* src, size_t n) {											\
+				for(size_t i = 0; i < n; ++i) {																\
+					dst[i] op src[i];																		\
+				}																							\
+			}																								\
+																											\
+			static void																						\
+			name##MonoScalar(float* dst, const float* src, size_t nFrames) {								\
+				for(size_t i = 0; i < nFrames; ++i) {														\
+					dst[2 * i] op src[i];																	\
+					dst[2 * i + 1] op src[i];																\
+				}																							\
+			}																								\
+																											\
+			static void																						\
+			name##LeftScalar(float* dst, const float* src, size_t nFrames) {								\
+				for(size_t i = 0; i < nFrames; ++i) {														\
+					dst[i] op src[2 * i];																	\
+				}																							\
+			}
+
+		NAUDIO_SCALAR_BINARY(add, +=)
+		NAUDIO_SCALAR_BINARY(sub, -=)
+		NAUDIO_SCALAR_BINARY(mul, *=)
+		NAUDIO_SCALAR_BINARY(div, /=)
+
+		static void
+		scaleScalar(float* dst, float s, size_t n) {
+			for(size_t i = 0; i < n; ++i) {
+				dst[i] *= s;
+			}
+		}
+
+		static void
+		offsetScalar(float* dst, float s, size_t n) {
+			for(size_t i = 0; i < n; ++i) {
+				dst[i] += s;
+			}
+		}
+
+		static void
+		fillScalar(float* dst, float value, size_t n) {
+			for(size_t i = 0; i < n; ++i) {
+				dst[i] = value;
+			}
+		}
+
+		static void
+		upmixScalar(float* dst, const float* src, size_t nFrames) {
+			for(size_t i = 0; i < nFrames; ++i) {
+				dst[2 * i] = src[i];
+				dst[2 * i + 1] = src[i];
+			}
+		}
+
+		static void
+		downmixScalar(float* dst, const float* src, size_t nFrames) {
+			for(size_t i = 0; i < nFrames; ++i) {
+				dst[i] = (src[2 * i] + src[2 * i + 1]) * 0.5f;
+			}
+		}
+
+		static void
+		firSymmetricScalar(float* dst, const float* src, const float* coef, size_t nPairs, size_t n) {
+			const size_t last = 2 * nPairs - 1;
+
+			for(size_t i = 0; i < n; ++i) {
+				float acc = 0.0f;
+
+				for(size_t t = 0; t < nPairs; ++t) {
+					acc += coef[t] * (src[i + t] + src[i + last - t]);
+				}
+
+				dst[i] = acc;
+			}
+		}
+
+		static void
+		firScalar(float* dst, const float* src, const float* coef, size_t nTaps, size_t n) {
+			for(size_t i = 0; i < n; ++i) {
+				float acc = 0.0f;
+
+				for(size_t t = 0; t < nTaps; ++t) {
+					acc += coef[t] * src[i + t];
+				}
+
+				dst[i] = acc;
+			}
+		}
+
+		static void
+		complexMultiplyAddScalar(float* dstRe, float* dstIm, const float* aRe, const float* aIm, const float* bRe, const float* bIm, size_t n) {
+			for(size_t i = 0; i < n; ++i) {
+				dstRe[i] += aRe[i] * bRe[i] - aIm[i] * bIm[i];
+				dstIm[i] += aRe[i] * bIm[i] + aIm[i] * bRe[i];
+			}
+		}
+
+		static void
+		fftButterflyScalar(float* re0, float* im0, float* re1, float* im1, const float* wr, const float* wi, size_t n) {
+			for(size_t i = 0; i < n; ++i) {
+				const float tr = re1[i] * wr[i] - im1[i] * wi[i];
+				const float ti = re1[i] * wi[i] + im1[i] * wr[i];
+
+				re1[i] = re0[i] - tr;
+				im1[i] = im0[i] - ti;
+				re0[i] += tr;
+				im0[i] += ti;
+			}
+		}
+
+		static void
+		addScaledScalar(float* dst, const float* src, float s, size_t n) {
+			for(size_t i = 0; i < n; ++i) {
+				dst[i] += s * src[i];
+			}
+		}
+
+		//Lanes are independent, so the vector kernels also hand their leftover lanes to this one.
+		static void
+		combBankScalar(float* line, size_t lineStride, const size_t* readFrames, size_t writeFrame, float* low, float* high, const float* scale, float lowCoef, float highCoef, const float* in, size_t nFrames, size_t nLanes) {
+			const float lowGain = 1.0f - lowCoef;
+			const float highGain = 1.0f - highCoef;
+
+			for(size_t l = 0; l < nLanes; ++l) {
+				const float* src = line + l * lineStride + readFrames[l];
+				float* dst = line + l * lineStride + writeFrame;
+
+				float lo = low[l];
+				float hi = high[l];
+
+				for(size_t i = 0; i < nFrames; ++i) {
+					lo = (lowGain * src[i]) + (lowCoef * lo);
+					hi = (highGain * lo) - (highCoef * hi);
+					dst[i] = (hi * scale[l]) + in[i];
+				}
+
+				low[l] = lo;
+				high[l] = hi;
+			}
+		}
+
+		static void
+		allpassScalar(float* io, float* dst, const float* src, float coef, size_t n) {
+			const float gain = 1.0f + coef;
+
+			for(size_t i = 0; i < n; ++i) {
+				const float p = src[i];
+				const float y = io[i] + p * coef;
+
+				dst[i] = y;
+				io[i] = gain * p - y;
+			}
+		}
+
+		static void
+		fdnScalar(float* dst, const float* src, float* low, const float* feedGain, const float* dampCoef, const float* inGain, const float* in, float* outLeft, float* outRight, size_t nLanes, size_t nFrames) {
+			const float norm = 1.0f / sqrtf((float)nLanes);
+			float y[16] = { 0.0f };
+
+			for(size_t i = 0; i < nFrames; ++i) {
+				const float* x = src + i * nLanes;
+				float* out = dst + i * nLanes;
+
+				for(size_t l = 0; l < nLanes; ++l) {
+					low[l] = feedGain[l] * x[l] + dampCoef[l] * low[l];
+					y[l] = low[l];
+				}
+
+				//Fast Walsh-Hadamard transform, from the closest pairs out.
+				for(size_t h = 1; h < nLanes; h *= 2) {
+					for(size_t j = 0; j < nLanes; j += 2 * h) {
+						for(size_t k = j; k < j + h; ++k) {
+							const float a = y[k];
+							const float b = y[k + h];
+
+							y[k] = a + b;
+							y[k + h] = a - b;
+						}
+					}
+				}
+
+				outLeft[i] = y[0] * norm;
+				outRight[i] = y[1] * norm;
+
+				for(size_t l = 0; l < nLanes; ++l) {
+					out[l] = y[l] * norm + inGain[l] * in[i];
+				}
+			}
+		}
+
+		static void
+		biquadCascadeScalar(float* out, const float* in, float* state, float* coef, const float* coefStep, size_t nChannels, size_t nStages, size_t nFrames) {
+			const size_t nLanes = nChannels * nStages;
+			const size_t lastLane = nLanes - nChannels;
+
+			float* s1 = state;
+			float* s2 = state + 4;
+			float x[4];
+			float y[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+			for(size_t i = 0; i < nFrames + nStages - 1; ++i) {
+				//The first stage takes the input, every other one the output of the stage before it, one frame behind.
+				for(size_t l = 0; l < nLanes; ++l) {
+					x[l] = (l >= nChannels) ? y[l - nChannels] : ((i < nFrames) ? in[i * nChannels + l] : 0.0f);
+				}
+
+				for(size_t l = 0; l < nLanes; ++l) {
+					const size_t stage = l / nChannels;
+
+					//Stages idle while the wavefront fills and drains.
+					if(i < stage || i - stage >= nFrames) {
+						continue;
+					}
+
+					if(coefStep != NULL) {
+						for(size_t k = 0; k < 5; ++k) {
+							coef[4 * k + l] += coefStep[4 * k + l];
+						}
+					}
+
+					y[l] = coef[l] * x[l] + s1[l];
+					s1[l] = coef[4 + l] * x[l] - coef[12 + l] * y[l] + s2[l];
+					s2[l] = coef[8 + l] * x[l] - coef[16 + l] * y[l];
+				}
+
+				if(i + 1 >= nStages) {
+					for(size_t ch = 0; ch < nChannels; ++ch) {
+						out[(i + 1 - nStages) * nChannels + ch] = y[lastLane + ch];
+					}
+				}
+			}
+		}
+
+		static float
+		levelDetectScalar(float* dst, const float* src, size_t nChannels, bool squared, size_t nFrames) {
+			float peak = 0.0f;
+
+			for(size_t i = 0; i < nFrames; ++i) {
+				float level = 0.0f;
+
+				for(size_t ch = 0; ch < nChannels; ++ch) {
+					const float x = src[i * nChannels + ch];
+
+					level = Max(level, squared ? x * x : fabsf(x));
+				}
+
+				dst[i] = level;
+				peak = Max(peak, level);
+			}
+
+			return(peak);
+		}
+
+		static void
+		gainComputerScalar(float* io, float levelDbScale, float thresholdDb, float knee, float slope, size_t n) {
+			const float halfKnee = 0.5f * knee;
+			const float invTwoKnee = (knee > 0.0f) ? 0.5f / knee : 0.0f;
+
+			for(size_t i = 0; i < n; ++i) {
+				const float over = levelDbScale * fastLog2(io[i]) - thresholdDb;
+				const float x = Min(Max(over + halfKnee, 0.0f), knee);
+
+				io[i] = slope * (x * x * invTwoKnee + Max(over - halfKnee, 0.0f));
+			}
+		}
+
+		static void
+		exp2ScaledScalar(float* io, float scale, float gain, size_t n) {
+			for(size_t i = 0; i < n; ++i) {
+				io[i] = gain * fastExp2(scale * io[i]);
+			}
+		}
+
+		static void
+		noiseFillScalar(float* dst, unsigned int* state, size_t n) {
+			for(size_t i = 0; i < n; ++i) {
+				dst[i] = randomWordToSample(xoshiro128Next(state + (i & 3), 4));
+			}
+		}
+
+		static const SIMDKernels_ s_scalarKernels = {
+			SIMDLevelScalar,
+			addScalar, subScalar, mulScalar, divScalar,
+			addMonoScalar, subMonoScalar, mulMonoScalar, divMonoScalar,
+			addLeftScalar, subLeftScalar, mulLeftScalar, divLeftScalar,
+			scaleScalar, offsetScalar, fillScalar, upmixScalar, downmixScalar,
+			firSymmetricScalar, firScalar, complexMultiplyAddScalar, fftButterflyScalar,
+			addScaledScalar, combBankScalar, allpassScalar, fdnScalar, biquadCascadeScalar,
+			levelDetectScalar, gainComputerScalar, exp2ScaledScalar, noiseFillScalar
+		};
+
+#if defined(NAUDIO_SIMD_SSE2)
+		//SSE2 kernels, 4 samples per iteration.
+		#define NAUDIO_SSE2_BINARY(name, vop)																\
+			static void																						\
+			name##SSE2(float* dst, const float* src, size_t n) {											\
+				size_t i = 0;																				\
+																											\
+				for(; i + 4 <= n; i += 4) {																	\
+					_mm_storeu_ps(dst + i, vop(_mm_loadu_ps(dst + i), _mm_loadu_ps(src + i)));				\
+				}																							\
+																											\
+				name##Scalar(dst + i, src + i, n - i);														\
+			}																								\
+																											\
+			static void																						\
+			name##MonoSSE2(float* dst, const float* src, size_t nFrames) {									\
+				size_t i = 0;																				\
+																											\
+				for(; i + 4 <= nFrames; i += 4) {															\
+					__m128 m = _mm_loadu_ps(src + i);														\
+					float* d = dst + 2 * i;																	\
+																											\
+					_mm_storeu_ps(d, vop(_mm_loadu_ps(d), _mm_unpacklo_ps(m, m)));							\
+					_mm_storeu_ps(d + 4, vop(_mm_loadu_ps(d + 4), _mm_unpackhi_ps(m, m)));					\
+				}																							\
+																											\
+				name##MonoScalar(dst + 2 * i, src + i, nFrames - i);										\
+			}																								\
+																											\
+			static void																						\
+			name##LeftSSE2(float* dst, const float* src, size_t nFrames) {									\
+				size_t i = 0;																				\
+																											\
+				for(; i + 4 <= nFrames; i += 4) {															\
+					const float* s = src + 2 * i;															\
+					__m128 l = _mm_shuffle_ps(_mm_loadu_ps(s), _mm_loadu_ps(s + 4), _MM_SHUFFLE(2, 0, 2, 0));	\
+																											\
+					_mm_storeu_ps(dst + i, vop(_mm_loadu_ps(dst + i), l));									\
+				}																							\
+																											\
+				name##LeftScalar(dst + i, src + 2 * i, nFrames - i);										\
+			}
+
+		NAUDIO_SSE2_BINARY(add, _mm_add_ps)
+		NAUDIO_SSE2_BINARY(sub, _mm_sub_ps)
+		NAUDIO_SSE2_BINARY(mul, _mm_mul_ps)
+		NAUDIO_SSE2_BINARY(div, _mm_div_ps)
+
+		static void
+		scaleSSE2(float* dst, float s, size_t n) {
+			__m128 vs = _mm_set1_ps(s);
+			size_t i = 0;
+
+			for(; i + 4 <= n; i += 4) {
+				_mm_storeu_ps(dst + i, _mm_mul_ps(_mm_loadu_ps(dst + i), vs));
+			}
+
+			scaleScalar(dst + i, s, n - i);
+		}
+
+		static void
+		offsetSSE2(float* dst, float s, size_t n) {
+			__m128 vs = _mm_set1_ps(s);
+			size_t i = 0;
+
+			for(; i + 4 <= n; i += 4) {
+				_mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), vs));
+			}
+
+			offsetScalar(dst + i, s, n - i);
+		}
+
+		static void
+		fillSSE2(float* dst, float value, size_t n) {
+			__m128 v = _mm_set1_ps(value);
+			size_t i = 0;
+
+			for(; i + 4 <= n; i += 4) {
+				_mm_storeu_ps(dst + i, v);
+			}
+
+			fillScalar(dst + i, value, n - i);
+		}
+
+		static void
+		upmixSSE2(float* dst, const float* src, size_t nFrames) {
+			size_t i = 0;
+
+			for(; i + 4 <= nFrames; i += 4) {
+				__m128 m = _mm_loadu_ps(src + i);
+
+				_mm_storeu_ps(dst + 2 * i, _mm_unpacklo_ps(m, m));
+				_mm_storeu_ps(dst + 2 * i + 4, _mm_unpackhi_ps(m, m));
+			}
+
+			upmixScalar(dst + 2 * i, src + i, nFrames - i);
+		}
+
+		static void
+		downmixSSE2(float* dst, const float* src, size_t nFrames) {
+			__m128 half = _mm_set1_ps(0.5f);
+			size_t i = 0;
+
+			for(; i + 4 <= nFrames; i += 4) {
+				__m128 a = _mm_loadu_ps(src + 2 * i);
+				__m128 b = _mm_loadu_ps(src + 2 * i + 4);
+				__m128 l = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+				__m128 r = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+
+				_mm_storeu_ps(dst + i, _mm_mul_ps(_mm_add_ps(l, r), half));
+			}
+
+			downmixScalar(dst + i, src + 2 * i, nFrames - i);
+		}
+
+		static void
+		firSymmetricSSE2(float* dst, const float* src, const float* coef, size_t nPairs, size_t n) {
+			const size_t last = 2 * nPairs - 1;
+			size_t i = 0;
+
+			//4 outputs at a time, each tap pair is one broadcast coefficient over 4 neighbouring windows.
+			for(; i + 4 <= n; i += 4) {
+				__m128 acc = _mm_setzero_ps();
+
+				for(size_t t = 0; t < nPairs; ++t) {
+					__m128 pair = _mm_add_ps(_mm_loadu_ps(src + i + t), _mm_loadu_ps(src + i + last - t));
+					acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(coef[t]), pair));
+				}
+
+				_mm_storeu_ps(dst + i, acc);
+			}
+
+			firSymmetricScalar(dst + i, src + i, coef, nPairs, n - i);
+		}
+
+		static void
+		firSSE2(float* dst, const float* src, const float* coef, size_t nTaps, size_t n) {
+			size_t i = 0;
+
+			for(; i + 4 <= n; i += 4) {
+				__m128 acc = _mm_setzero_ps();
+
+				for(size_t t = 0; t < nTaps; ++t) {
+					acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(coef[t]), _mm_loadu_ps(src + i + t)));
+				}
+
+				_mm_storeu_ps(dst + i, acc);
+			}
+
+			firScalar(dst + i, src + i, coef, nTaps, n - i);
+		}
+
+		static void
+		complexMultiplyAddSSE2(float* dstRe, float* dstIm, const float* aRe, const float* aIm, const float* bRe, const float* bIm, size_t n) {
+			size_t i = 0;
+
+			for(; i + 4 <= n; i += 4) {
+				__m128 ar = _mm_loadu_ps(aRe + i);
+				__m128 ai = _mm_loadu_ps(aIm + i);
+				__m128 br = _mm_loadu_ps(bRe + i);
+				__m128 bi = _mm_loadu_ps(bIm + i);
+
+				_mm_storeu_ps(dstRe + i, _mm_add_ps(_mm_loadu_ps(dstRe + i), _mm_sub_ps(_mm_mul_ps(ar, br), _mm_mul_ps(ai, bi))));
+				_mm_storeu_ps(dstIm + i, _mm_add_ps(_mm_loadu_ps(dstIm + i), _mm_add_ps(_mm_mul_ps(ar, bi), _mm_mul_ps(ai, br))));
+			}
+
+			complexMultiplyAddScalar(dstRe + i, dstIm + i, aRe + i, aIm + i, bRe + i, bIm + i, n - i);
+		}
+
+		static void
+		fftButterflySSE2(float* re0, float* im0, float* re1, float* im1, const float* wr, const float* wi, size_t n) {
+			size_t i = 0;
+
+			for(; i + 4 <= n; i += 4) {
+				__m128 r1 = _mm_loadu_ps(re1 + i);
+				__m128 i1 = _mm_loadu_ps(im1 + i);
+				__m128 c = _mm_loadu_ps(wr + i);
+				__m128 d = _mm_loadu_ps(wi + i);
+				__m128 r0 = _mm_loadu_ps(re0 + i);
+				__m128 i0 = _mm_loadu_ps(im0 + i);
+
+				__m128 tr = _mm_sub_ps(_mm_mul_ps(r1, c), _mm_mul_ps(i1, d));
+				__m128 ti = _mm_add_ps(_mm_mul_ps(r1, d), _mm_mul_ps(i1, c));
+
+				_mm_storeu_ps(re1 + i, _mm_sub_ps(r0, tr));
+				_mm_storeu_ps(im1 + i, _mm_sub_ps(i0, ti));
+				_mm_storeu_ps(re0 + i, _mm_add_ps(r0, tr));
+				_mm_storeu_ps(im0 + i, _mm_add_ps(i0, ti));
+			}
+
+			fftButterflyScalar(re0 + i, im0 + i, re1 + i, im1 + i, wr + i, wi + i, n - i);
+		}
+
+		static void
+		addScaledSSE2(float* dst, const float* src, float s, size_t n) {
+			const __m128 vs = _mm_set1_ps(s);
+			size_t i = 0;
+
+			for(; i + 4 <= n; i += 4) {
+				_mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(vs, _mm_loadu_ps(src + i))));
+			}
+
+			addScaledScalar(dst + i, src + i, s, n - i);
+		}
+
+		//Four lanes per vector. The lines of a group are read and written one sample each per frame.
+		static void
+		combBankSSE2(float* line, size_t lineStride, const size_t* readFrames, size_t writeFrame, float* low, float* high, const float* scale, float lowCoef, float highCoef, const float* in, size_t nFrames, size_t nLanes) {
+			const __m128 lowGain = _mm_set1_ps(1.0f - lowCoef);
+			const __m128 highGain = _mm_set1_ps(1.0f - highCoef);
+			const __m128 lc = _mm_set1_ps(lowCoef);
+			const __m128 hc = _mm_set1_ps(highCoef);
+			size_t l = 0;
+
+			for(; l + 4 <= nLanes; l += 4) {
+				const float* src0 = line + l * lineStride + readFrames[l];
+				const float* src1 = line + (l + 1) * lineStride + readFrames[l + 1];
+				const float* src2 = line + (l + 2) * lineStride + readFrames[l + 2];
+				const float* src3 = line + (l + 3) * lineStride + readFrames[l + 3];
+				float* dst = line + l * lineStride + writeFrame;
+
+				__m128 lo = _mm_loadu_ps(low + l);
+				__m128 hi = _mm_loadu_ps(high + l);
+				const __m128 sf = _mm_loadu_ps(scale + l);
+				float y[4];
+
+				for(size_t i = 0; i < nFrames; ++i) {
+					const __m128 x = _mm_set_ps(src3[i], src2[i], src1[i], src0[i]);
+
+					lo = _mm_add_ps(_mm_mul_ps(lowGain, x), _mm_mul_ps(lc, lo));
+					hi = _mm_sub_ps(_mm_mul_ps(highGain, lo), _mm_mul_ps(hc, hi));
+
+					_mm_storeu_ps(y, _mm_add_ps(_mm_mul_ps(hi, sf), _mm_set1_ps(in[i])));
+
+					dst[i] = y[0];
+					dst[i + lineStride] = y[1];
+					dst[i + 2 * lineStride] = y[2];
+					dst[i + 3 * lineStride] = y[3];
+				}
+
+				_mm_storeu_ps(low + l, lo);
+				_mm_storeu_ps(high + l, hi);
+			}
+
+			combBankScalar(line + l * lineStride, lineStride, readFrames + l, writeFrame, low + l, high + l, scale + l, lowCoef, highCoef, in, nFrames, nLanes - l);
+		}
+
+		static void
+		allpassSSE2(float* io, float* dst, const float* src, float coef, size_t n) {
+			const __m128 c = _mm_set1_ps(coef);
+			const __m128 gain = _mm_set1_ps(1.0f + coef);
+			size_t i = 0;
+
+			for(; i + 4 <= n; i += 4) {
+				const __m128 p = _mm_loadu_ps(src + i);
+				const __m128 y = _mm_add_ps(_mm_loadu_ps(io + i), _mm_mul_ps(p, c));
+
+				_mm_storeu_ps(dst + i, y);
+				_mm_storeu_ps(io + i, _mm_sub_ps(_mm_mul_ps(gain, p), y));
+			}
+
+			allpassScalar(io + i, dst + i, src + i, coef, n - i);
+		}
+
+		//Four lanes per vector. Butterflies within a vector are a shuffle and a sign flip, the ones between vectors plain adds.
+		static void
+		fdnSSE2(float* dst, const float* src, float* low, const float* feedGain, const float* dampCoef, const float* inGain, const float* in, float* outLeft, float* outRight, size_t nLanes, size_t nFrames) {
+			const size_t nVectors = nLanes / 4;
+			const __m128 norm = _mm_set1_ps(1.0f / sqrtf((float)nLanes));
+			const __m128 flipOdd = _mm_castsi128_ps(_mm_setr_epi32(0, (int)0x80000000, 0, (int)0x80000000));
+			const __m128 flipHigh = _mm_castsi128_ps(_mm_setr_epi32(0, 0, (int)0x80000000, (int)0x80000000));
+
+			__m128 lo[4];
+			__m128 fg[4];
+			__m128 dc[4];
+			__m128 ig[4];
+			__m128 y[4];
+
+			for(size_t v = 0; v < nVectors; ++v) {
+				lo[v] = _mm_loadu_ps(low + 4 * v);
+				fg[v] = _mm_loadu_ps(feedGain + 4 * v);
+				dc[v] = _mm_loadu_ps(dampCoef + 4 * v);
+				ig[v] = _mm_loadu_ps(inGain + 4 * v);
+			}
+
+			for(size_t i = 0; i < nFrames; ++i) {
+				const float* x = src + i * nLanes;
+				float* out = dst + i * nLanes;
+
+				for(size_t v = 0; v < nVectors; ++v) {
+					lo[v] = _mm_add_ps(_mm_mul_ps(fg[v], _mm_loadu_ps(x + 4 * v)), _mm_mul_ps(dc[v], lo[v]));
+
+					//Pairs 1 apart, then 2 apart.
+					__m128 t = lo[v];
+
+					t = _mm_add_ps(_mm_xor_ps(t, flipOdd), _mm_shuffle_ps(t, t, _MM_SHUFFLE(2, 3, 0, 1)));
+					t = _mm_add_ps(_mm_xor_ps(t, flipHigh), _mm_shuffle_ps(t, t, _MM_SHUFFLE(1, 0, 3, 2)));
+
+					y[v] = t;
+				}
+
+				for(size_t h = 1; h < nVectors; h *= 2) {
+					for(size_t j = 0; j < nVectors; j += 2 * h) {
+						for(size_t k = j; k < j + h; ++k) {
+							const __m128 a = y[k];
+							const __m128 b = y[k + h];
+
+							y[k] = _mm_add_ps(a, b);
+							y[k + h] = _mm_sub_ps(a, b);
+						}
+					}
+				}
+
+				const __m128 vin = _mm_set1_ps(in[i]);
+
+				for(size_t v = 0; v < nVectors; ++v) {
+					y[v] = _mm_mul_ps(y[v], norm);
+
+					_mm_storeu_ps(out + 4 * v, _mm_add_ps(y[v], _mm_mul_ps(ig[v], vin)));
+				}
+
+				outLeft[i] = _mm_cvtss_f32(y[0]);
+				outRight[i] = _mm_cvtss_f32(_mm_shuffle_ps(y[0], y[0], _MM_SHUFFLE(1, 1, 1, 1)));
+			}
+
+			for(size_t v = 0; v < nVectors; ++v) {
+				_mm_storeu_ps(low + 4 * v, lo[v]);
+			}
+		}
+
+		//The whole cascade fits one vector. While the wavefront fills and drains, idle lanes keep their state and coefficients through a mask.
+		static void
+		biquadCascadeSSE2(float* out, const float* in, float* state, float* coef, const float* coefStep, size_t nChannels, size_t nStages, size_t nFrames) {
+			const size_t nLanes = nChannels * nStages;
+			const size_t lastLane = nLanes - nChannels;
+			const __m128 zero = _mm_setzero_ps();
+
+			__m128 s1 = _mm_loadu_ps(state);
+			__m128 s2 = _mm_loadu_ps(state + 4);
+
+			__m128 b0 = _mm_loadu_ps(coef);
+			__m128 b1 = _mm_loadu_ps(coef + 4);
+			__m128 b2 = _mm_loadu_ps(coef + 8);
+			__m128 a1 = _mm_loadu_ps(coef + 12);
+			__m128 a2 = _mm_loadu_ps(coef + 16);
+
+			const bool steps = (coefStep != NULL);
+			const __m128 db0 = steps ? _mm_loadu_ps(coefStep) : zero;
+			const __m128 db1 = steps ? _mm_loadu_ps(coefStep + 4) : zero;
+			const __m128 db2 = steps ? _mm_loadu_ps(coefStep + 8) : zero;
+			const __m128 da1 = steps ? _mm_loadu_ps(coefStep + 12) : zero;
+			const __m128 da2 = steps ? _mm_loadu_ps(coefStep + 16) : zero;
+
+			//Stage of every lane. Lanes past the cascade are never active.
+			const __m128i stages = _mm_setr_epi32(0, (int)(1 / nChannels), (nLanes > 2) ? (int)(2 / nChannels) : 0x3fffffff, (nLanes > 3) ? (int)(3 / nChannels) : 0x3fffffff);
+			const __m128i frameCount = _mm_set1_epi32((int)nFrames);
+
+			__m128 y = zero;
+			float lanes[4];
+
+			for(size_t i = 0; i < nFrames + nStages - 1; ++i) {
+				__m128 x = zero;
+
+				if(i < nFrames) {
+					x = (nChannels == 1) ? _mm_set_ss(in[i]) : _mm_castpd_ps(_mm_load_sd((const double*)(in + 2 * i)));
+				}
+
+				//The first stage takes the input, every other one the output of the stage before it, one frame behind.
+				if(nChannels == 1) {
+					x = _mm_or_ps(x, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(y), 4)));
+				}
+				else {
+					x = _mm_or_ps(x, _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(y), 8)));
+				}
+
+				if(i + 1 >= nStages && i < nFrames) {
+					if(steps) {
+						b0 = _mm_add_ps(b0, db0);
+						b1 = _mm_add_ps(b1, db1);
+						b2 = _mm_add_ps(b2, db2);
+						a1 = _mm_add_ps(a1, da1);
+						a2 = _mm_add_ps(a2, da2);
+					}
+
+					y = _mm_add_ps(_mm_mul_ps(b0, x), s1);
+					s1 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(b1, x), _mm_mul_ps(a1, y)), s2);
+					s2 = _mm_sub_ps(_mm_mul_ps(b2, x), _mm_mul_ps(a2, y));
+				}
+				else {
+					const __m128i frame = _mm_sub_epi32(_mm_set1_epi32((int)i), stages);
+					const __m128 active = _mm_castsi128_ps(_mm_andnot_si128(_mm_cmplt_epi32(frame, _mm_setzero_si128()), _mm_cmplt_epi32(frame, frameCount)));
+
+					if(steps) {
+						b0 = _mm_add_ps(b0, _mm_and_ps(db0, active));
+						b1 = _mm_add_ps(b1, _mm_and_ps(db1, active));
+						b2 = _mm_add_ps(b2, _mm_and_ps(db2, active));
+						a1 = _mm_add_ps(a1, _mm_and_ps(da1, active));
+						a2 = _mm_add_ps(a2, _mm_and_ps(da2, active));
+					}
+
+					y = _mm_add_ps(_mm_mul_ps(b0, x), s1);
+
+					const __m128 n1 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(b1, x), _mm_mul_ps(a1, y)), s2);
+					const __m128 n2 = _mm_sub_ps(_mm_mul_ps(b2, x), _mm_mul_ps(a2, y));
+
+					s1 = _mm_or_ps(_mm_and_ps(active, n1), _mm_andnot_ps(active, s1));
+					s2 = _mm_or_ps(_mm_and_ps(active, n2), _mm_andnot_ps(active, s2));
+				}
+
+				if(i + 1 >= nStages) {
+					_mm_storeu_ps(lanes, y);
+
+					for(size_t ch = 0; ch < nChannels; ++ch) {
+						out[(i + 1 - nStages) * nChannels + ch] = lanes[lastLane + ch];
+					}
+				}
+			}
+
+			_mm_storeu_ps(state, s1);
+			_mm_storeu_ps(state + 4, s2);
+
+			if(steps) {
+				_mm_storeu_ps(coef, b0);
+				_mm_storeu_ps(coef + 4, b1);
+				_mm_storeu_ps(coef + 8, b2);
+				_mm_storeu_ps(coef + 12, a1);
+				_mm_storeu_ps(coef + 16, a2);
+			}
+		}
+
+		//Same steps as fastLog2() and fastExp2(), 4 samples at a time.
+		static inline __m128
+		fastLog2SSE2(__m128 x) {
+			const __m128i bits = _mm_castps_si128(x);
+			const __m128 exponent = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_and_si128(_mm_srli_epi32(bits, 23), _mm_set1_epi32(0xFF)), _mm_set1_epi32(127)));
+			const __m128 t = _mm_sub_ps(_mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007FFFFF)), _mm_set1_epi32(0x3F800000))), _mm_set1_ps(1.0f));
+
+			__m128 p = _mm_set1_ps(0.0448740f);
+
+			p = _mm_add_ps(_mm_set1_ps(-0.1954072f), _mm_mul_ps(t, p));
+			p = _mm_add_ps(_mm_set1_ps(0.4201112f), _mm_mul_ps(t, p));
+			p = _mm_add_ps(_mm_set1_ps(-0.7119966f), _mm_mul_ps(t, p));
+			p = _mm_add_ps(_mm_set1_ps(1.4424186f), _mm_mul_ps(t, p));
+
+			return(_mm_add_ps(exponent, _mm_mul_ps(t, p)));
+		}
+
+		static inline __m128
+		fastExp2SSE2(__m128 x) {
+			const __m128 biased = _mm_add_ps(_mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-126.0f)), _mm_set1_ps(126.0f)), _mm_set1_ps(127.0f));
+			const __m128i exponent = _mm_cvttps_epi32(biased);
+			const __m128 t = _mm_sub_ps(biased, _mm_cvtepi32_ps(exponent));
+
+			__m128 p = _mm_set1_ps(0.0018965f);
+
+			p = _mm_add_ps(_mm_set1_ps(0.0089702f), _mm_mul_ps(t, p));
+			p = _mm_add_ps(_mm_set1_ps(0.0558116f), _mm_mul_ps(t, p));
+			p = _mm_add_ps(_mm_set1_ps(0.2401729f), _mm_mul_ps(t, p));
+			p = _mm_add_ps(_mm_set1_ps(0.6931488f), _mm_mul_ps(t, p));
+			p = _mm_add_ps(_mm_set1_ps(1.0f), _mm_mul_ps(t, p));
+
+			return(_mm_mul_ps(_mm_castsi128_ps(_mm_slli_epi32(exponent, 23)), p));
+		}
+
+		//Largest of the 4 lanes.
+		static inline float
+		horizontalMaxSSE2(__m128 v) {
+			v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+			v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+
+			return(_mm_cvtss_f32(v));
+		}
+
+		static float
+		levelDetectSSE2(float* dst, const float* src, size_t nChannels, bool squared, size_t nFrames) {
+			const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+			__m128 peak = _mm_setzero_ps();
+			size_t i = 0;
+
+			for(; i + 4 <= nFrames; i += 4) {
+				__m128 level;
+
+				if(nChannels == 2) {
+					__m128 a = _mm_loadu_ps(src + 2 * i);
+					__m128 b = _mm_loadu_ps(src + 2 * i + 4);
+
+					a = squared ? _mm_mul_ps(a, a) : _mm_and_ps(a, absMask);
+					b = squared ? _mm_mul_ps(b, b) : _mm_and_ps(b, absMask);
+					level = _mm_max_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+				}
+				else {
+					const __m128 x = _mm_loadu_ps(src + i);
+
+					level = squared ? _mm_mul_ps(x, x) : _mm_and_ps(x, absMask);
+				}
+
+				_mm_storeu_ps(dst + i, level);
+				peak = _mm_max_ps(peak, level);
+			}
+
+			return(Max(horizontalMaxSSE2(peak), levelDetectScalar(dst + i, src + i * nChannels, nChannels, squared, nFrames - i)));
+		}
+
+		static void
+		gainComputerSSE2(float* io, float levelDbScale, float thresholdDb, float knee, float slope, size_t n) {
+			const __m128 vScale = _mm_set1_ps(levelDbScale);
+			const __m128 vThreshold = _mm_set1_ps(thresholdDb);
+			const __m128 vHalfKnee = _mm_set1_ps(0.5f * knee);
+			const __m128 vKnee = _mm_set1_ps(knee);
+			const __m128 vInvTwoKnee = _mm_set1_ps((knee > 0.0f) ? 0.5f / knee : 0.0f);
+			const __m128 vSlope = _mm_set1_ps(slope);
+			const __m128 zero = _mm_setzero_ps();
+			size_t i = 0;
+
+			for(; i + 4 <= n; i += 4) {
+				const __m128 over = _mm_sub_ps(_mm_mul_ps(vScale, fastLog2SSE2(_mm_loadu_ps(io + i))), vThreshold);
+				const __m128 x = _mm_min_ps(_mm_max_ps(_mm_add_ps(over, vHalfKnee), zero), vKnee);
+
+				_mm_storeu_ps(io + i, _mm_mul_ps(vSlope, _mm_add_ps(_mm_mul_ps(_mm_mul_ps(x, x), vInvTwoKnee), _mm_max_ps(_mm_sub_ps(over, vHalfKnee), zero))));
+			}
+
+			gainComputerScalar(io + i, levelDbScale, thresholdDb, knee, slope, n - i);
+		}
+
+		static void
+		exp2ScaledSSE2(float* io, float scale, float gain, size_t n) {
+			const __m128 vScale = _mm_set1_ps(scale);
+			const __m128 vGain = _mm_set1_ps(gain);
+			size_t i = 0;
+
+			for(; i + 4 <= n; i += 4) {
+				_mm_storeu_ps(io + i, _mm_mul_ps(vGain, fastExp2SSE2(_mm_mul_ps(vScale, _mm_loadu_ps(io + i)))));
+			}
+
+			exp2ScaledScalar(io + i, scale, gain, n - i);
+		}
+
+		//The 4 lanes are one vector per state word.
+		static void
+		noiseFillSSE2(float* dst, unsigned int* state, size_t n) {
+			__m128i s0 = _mm_loadu_si128((const __m128i*)state);
+			__m128i s1 = _mm_loadu_si128((const __m128i*)(state + 4));
+			__m128i s2 = _mm_loadu_si128((const __m128i*)(state + 8));
+			__m128i s3 = _mm_loadu_si128((const __m128i*)(state + 12));
+
+			const __m128 scale = _mm_set1_ps(1.0f / 8388608.0f);
+			const __m128 one = _mm_set1_ps(1.0f);
+			size_t i = 0;
+
+			for(; i + 4 <= n; i += 4) {
+				const __m128i result = _mm_add_epi32(s0, s3);
+				const __m128i t = _mm_slli_epi32(s1, 9);
+
+				s2 = _mm_xor_si128(s2, s0);
+				s3 = _mm_xor_si128(s3, s1);
+				s1 = _mm_xor_si128(s1, s2);
+				s0 = _mm_xor_si128(s0, s3);
+				s2 = _mm_xor_si128(s2, t);
+				s3 = _mm_or_si128(_mm_slli_epi32(s3, 11), _mm_srli_epi32(s3, 21));
+
+				_mm_storeu_ps(dst + i, _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(result, 8)), scale), one));
+			}
+
+			_mm_storeu_si128((__m128i*)state, s0);
+			_mm_storeu_si128((__m128i*)(state + 4), s1);
+			_mm_storeu_si128((__m128i*)(state + 8), s2);
+			_mm_storeu_si128((__m128i*)(state + 12), s3);
+
+			noiseFillScalar(dst + i, state, n - i);
+		}
+
+		static const SIMDKernels_ s_sse2Kernels = {
+			SIMDLevelSSE2,
+			addSSE2, subSSE2, mulSSE2, divSSE2,
+			addMonoSSE2, subMonoSSE2, mulMonoSSE2, divMonoSSE2,
+			addLeftSSE2, subLeftSSE2, mulLeftSSE2, divLeftSSE2,
+			scaleSSE2, offsetSSE2, fillSSE2, upmixSSE2, downmixSSE2,
+			firSymmetricSSE2, firSSE2, complexMultiplyAddSSE2, fftButterflySSE2,
+			addScaledSSE2, combBankSSE2, allpassSSE2, fdnSSE2, biquadCascadeSSE2,
+			levelDetectSSE2, gainComputerSSE2, exp2ScaledSSE2, noiseFillSSE2
+		};
+#endif
+
+#if defined(NAUDIO_SIMD_AVX2)
+		//AVX2 kernels, 8 samples per iteration. Interleaving works per 128-bit lane, so results are put back in order with a cross-lane permute.
+		//Remainders go to the scalar kernels after _mm256_zeroupper(). Compilers don't always clear the upper halves before a call out of a target("avx2") function, and SSE code after dirty upper halves runs several times slower.
+		#define NAUDIO_AVX2_BINARY(name, vop)																\
+			NAUDIO_TARGET_AVX2 static void																	\
+			name##AVX2(float* dst, const float* src, size_t n) {											\
+				size_t i = 0;																				\
+																											\
+				for(; i + 8 <= n; i += 8) {																	\
+					_mm256_storeu_ps(dst + i, vop(_mm256_loadu_ps(dst + i), _mm256_loadu_ps(src + i)));	\
+				}																							\
+																											\
+				_mm256_zeroupper();																			\
+				name##Scalar(dst + i, src + i, n - i);														\
+			}																								\
+																											\
+			NAUDIO_TARGET_AVX2 static void																	\
+			name##MonoAVX2(float* dst, const float* src, size_t nFrames) {									\
+				size_t i = 0;																				\
+																											\
+				for(; i + 8 <= nFrames; i += 8) {															\
+					__m256 m = _mm256_loadu_ps(src + i);													\
+					__m256 lo = _mm256_unpacklo_ps(m, m);													\
+					__m256 hi = _mm256_unpackhi_ps(m, m);													\
+					float* d = dst + 2 * i;																	\
+																											\
+					_mm256_storeu_ps(d, vop(_mm256_loadu_ps(d), _mm256_permute2f128_ps(lo, hi, 0x20)));		\
+					_mm256_storeu_ps(d + 8, vop(_mm256_loadu_ps(d + 8), _mm256_permute2f128_ps(lo, hi, 0x31)));	\
+				}																							\
+																											\
+				_mm256_zeroupper();																			\
+				name##MonoScalar(dst + 2 * i, src + i, nFrames - i);										\
+			}																								\
+																											\
+			NAUDIO_TARGET_AVX2 static void																	\
+			name##LeftAVX2(float* dst, const float* src, size_t nFrames) {									\
+				size_t i = 0;																				\
+																											\
+				for(; i + 8 <= nFrames; i += 8) {															\
+					const float* s = src + 2 * i;															\
+					__m256 l = _mm256_shuffle_ps(_mm256_loadu_ps(s), _mm256_loadu_ps(s + 8), _MM_SHUFFLE(2, 0, 2, 0));	\
+					l = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(l), _MM_SHUFFLE(3, 1, 2, 0)));	\
+																											\
+					_mm256_storeu_ps(dst + i, vop(_mm256_loadu_ps(dst + i), l));							\
+				}																							\
+																											\
+				_mm256_zeroupper();																			\
+				name##LeftScalar(dst + i, src + 2 * i, nFrames - i);										\
+			}
+
+		NAUDIO_AVX2_BINARY(add, _mm256_add_ps)
+		NAUDIO_AVX2_BINARY(sub, _mm256_sub_ps)
+		NAUDIO_AVX2_BINARY(mul, _mm256_mul_ps)
+		NAUDIO_AVX2_BINARY(div, _mm256_div_ps)
+
+		NAUDIO_TARGET_AVX2 static void
+		scaleAVX2(float* dst, float s, size_t n) {
+			__m256 vs = _mm256_set1_ps(s);
+			size_t i = 0;
+
+			for(; i + 8 <= n; i += 8) {
+				_mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_loadu_ps(dst + i), vs));
+			}
+
+			_mm256_zeroupper();
+			scaleScalar(dst + i, s, n - i);
+		}
+
+		NAUDIO_TARGET_AVX2 static void
+		offsetAVX2(float* dst, float s, size_t n) {
+			__m256 vs = _mm256_set1_ps(s);
+			size_t i = 0;
+
+			for(; i + 8 <= n; i += 8) {
+				_mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_loadu_ps(dst + i), vs));
+			}
+
+			_mm256_zeroupper();
+			offsetScalar(dst + i, s, n - i);
+		}
+
+		NAUDIO_TARGET_AVX2 static void
+		fillAVX2(float* dst, float value, size_t n) {
+			__m256 v = _mm256_set1_ps(value);
+			size_t i = 0;
+
+			for(; i + 8 <= n; i += 8) {
+				_mm256_storeu_ps(dst + i, v);
+			}
+
+			_mm256_zeroupper();
+			fillScalar(dst + i, value, n - i);
+		}
+
+		NAUDIO_TARGET_AVX2 static void
+		upmixAVX2(float* dst, const float* src, size_t nFrames) {
+			size_t i = 0;
+
+			for(; i + 8 <= nFrames; i += 8) {
+				__m256 m = _mm256_loadu_ps(src + i);
+				__m256 lo = _mm256_unpacklo_ps(m, m);
+				__m256 hi = _mm256_unpackhi_ps(m, m);
+
+				_mm256_storeu_ps(dst + 2 * i, _mm256_permute2f128_ps(lo, hi, 0x20));
+				_mm256_storeu_ps(dst + 2 * i + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+			}
+
+			_mm256_zeroupper();
+			upmixScalar(dst + 2 * i, src + i, nFrames - i);
+		}
+
+		NAUDIO_TARGET_AVX2 static void
+		downmixAVX2(float* dst, const float* src, size_t nFrames) {
+			__m256 half = _mm256_set1_ps(0.5f);
+			size_t i = 0;
+
+			for(; i + 8 <= nFrames; i += 8) {
+				__m256 a = _mm256_loadu_ps(src + 2 * i);
+				__m256 b = _mm256_loadu_ps(src + 2 * i + 8);
+				__m256 sum = _mm256_add_ps(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)), _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+
+				sum = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(sum), _MM_SHUFFLE(3, 1, 2, 0)));
+				_mm256_storeu_ps(dst + i, _mm256_mul_ps(sum, half));
+			}
+
+			_mm256_zeroupper();
+			downmixScalar(dst + i, src + 2 * i, nFrames - i);
+		}
+
+		NAUDIO_TARGET_AVX2 static void
+		firSymmetricAVX2(float* dst, const float* src, const float* coef, size_t nPairs, size_t n) {
+			const size_t last = 2 * nPairs - 1;
+			size_t i = 0;
+
+			for(; i + 8 <= n; i += 8) {
+				__m256 acc = _mm256_setzero_ps();
+
+				for(size_t t = 0; t < nPairs; ++t) {
+					__m256 pair = _mm256_add_ps(_mm256_loadu_ps(src + i + t), _mm256_loadu_ps(src + i + last - t));
+					acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_set1_ps(coef[t]), pair));
+				}
+
+				_mm256_storeu_ps(dst + i, acc);
+			}
+
+			_mm256_zeroupper();
+			firSymmetricScalar(dst + i, src + i, coef, nPairs, n - i);
+		}
+
+		NAUDIO_TARGET_AVX2 static void
+		firAVX2(float* dst, const float* src, const float* coef, size_t nTaps, size_t n) {
+			size_t i = 0;
+
+			for(; i + 8 <= n; i += 8) {
+				__m256 acc = _mm256_setzero_ps();
+
+				for(size_t t = 0; t < nTaps; ++t) {
+					acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_set1_ps(coef[t]), _mm256_loadu_ps(src + i + t)));
+				}
+
+				_mm256_storeu_ps(dst + i, acc);
+			}
+
+			_mm256_zeroupper();
+			firScalar(dst + i, src + i, coef, nTaps, n - i);
+		}
+
+		NAUDIO_TARGET_AVX2 static void
+		complexMultiplyAddAVX2(float* dstRe, float* dstIm, const float* aRe, const float* aIm, const float* bRe, const float* bIm, size_t n) {
+			size_t i = 0;
+
+			for(; i + 8 <= n; i += 8) {
+				__m256 ar = _mm256_loadu_ps(aRe + i);
+				__m256 ai = _mm256_loadu_ps(aIm + i);
+				__m256 br = _mm256_loadu_ps(bRe + i);
+				__m256 bi = _mm256_loadu_ps(bIm + i);
+
+				_mm256_storeu_ps(dstRe + i, _mm256_add_ps(_mm256_loadu_ps(dstRe + i), _mm256_sub_ps(_mm256_mul_ps(ar, br), _mm256_mul_ps(ai, bi))));
+				_mm256_storeu_ps(dstIm + i, _mm256_add_ps(_mm256_loadu_ps(dstIm + i), _mm256_add_ps(_mm256_mul_ps(ar, bi), _mm256_mul_ps(ai, br))));
+			}
+
+			_mm256_zeroupper();
+			complexMultiplyAddScalar(dstRe + i, dstIm + i, aRe + i, aIm + i, bRe + i, bIm + i, n - i);
+		}
+
+		NAUDIO_TARGET_AVX2 static void
+		fftButterflyAVX2(float* re0, float* im0, float* re1, float* im1, const float* wr, const float* wi, size_t n) {
+			size_t i = 0;
+
+			for(; i + 8 <= n; i += 8) {
+				__m256 r1 = _mm256_loadu_ps(re1 + i);
+				__m256 i1 = _mm256_loadu_ps(im1 + i);
+				__m256 c = _mm256_loadu_ps(wr + i);
+				__m256 d = _mm256_loadu_ps(wi + i);
+				__m256 r0 = _mm256_loadu_ps(re0 + i);
+				__m256 i0 = _mm256_loadu_ps(im0 + i);
+
+				__m256 tr = _mm256_sub_ps(_mm256_mul_ps(r1, c), _mm256_mul_ps(i1, d));
+				__m256 ti = _mm256_add_ps(_mm256_mul_ps(r1, d), _mm256_mul_ps(i1, c));
+
+				_mm256_storeu_ps(re1 + i, _mm256_sub_ps(r0, tr));
+				_mm256_storeu_ps(im1 + i, _mm256_sub_ps(i0, ti));
+				_mm256_storeu_ps(re0 + i, _mm256_add_ps(r0, tr));
+				_mm256_storeu_ps(im0 + i, _mm256_add_ps(i0, ti));
+			}
+
+			_mm256_zeroupper();
+			fftButterflyScalar(re0 + i, im0 + i, re1 + i, im1 + i, wr + i, wi + i, n - i);
+		}
+
+		NAUDIO_TARGET_AVX2 static void
+		addScaledAVX2(float* dst, const float* src, float s, size_t n) {
+			const __m256 vs = _mm256_set1_ps(s);
+			size_t i = 0;
+
+			for(; i + 8 <= n; i += 8) {
+				_mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_loadu_ps(dst + i), _mm256_mul_ps(vs, _mm256_loadu_ps(src + i))));
+			}
+
+			_mm256_zeroupper();
+			addScaledScalar(dst + i, src + i, s, n - i);
+		}
+
+		//Eight lanes per vector. The reads are one gather per frame, the writes are scattered by hand.
+		NAUDIO_TARGET_AVX2 static void
+		combBankAVX2(float* line, size_t lineStride, const size_t* readFrames, size_t writeFrame, float* low, float* high, const float* scale, float lowCoef, float highCoef, const float* in, size_t nFrames, size_t nLanes) {
+			const __m256 lowGain = _mm256_set1_ps(1.0f - lowCoef);
+			const __m256 highGain = _mm256_set1_ps(1.0f - highCoef);
+			const __m256 lc = _mm256_set1_ps(lowCoef);
+			const __m256 hc = _mm256_set1_ps(highCoef);
+			const __m256i one = _mm256_set1_epi32(1);
+			size_t l = 0;
+
+			for(; l + 8 <= nLanes; l += 8) {
+				float* base = line + l * lineStride;
+				float* dst = base + writeFrame;
+				const int stride = (int)lineStride;
+
+				__m256i index = _mm256_setr_epi32((int)readFrames[l], stride + (int)readFrames[l + 1], 2 * stride + (int)readFrames[l + 2], 3 * stride + (int)readFrames[l + 3],
+					4 * stride + (int)readFrames[l + 4], 5 * stride + (int)readFrames[l + 5], 6 * stride + (int)readFrames[l + 6], 7 * stride + (int)readFrames[l + 7]);
+
+				__m256 lo = _mm256_loadu_ps(low + l);
+				__m256 hi = _mm256_loadu_ps(high + l);
+				const __m256 sf = _mm256_loadu_ps(scale + l);
+				float y[8];
+
+				for(size_t i = 0; i < nFrames; ++i) {
+					const __m256 x = _mm256_i32gather_ps(base, index, 4);
+
+					lo = _mm256_add_ps(_mm256_mul_ps(lowGain, x), _mm256_mul_ps(lc, lo));
+					hi = _mm256_sub_ps(_mm256_mul_ps(highGain, lo), _mm256_mul_ps(hc, hi));
+
+					_mm256_storeu_ps(y, _mm256_add_ps(_mm256_mul_ps(hi, sf), _mm256_set1_ps(in[i])));
+
+					for(size_t k = 0; k < 8; ++k) {
+						dst[i + k * lineStride] = y[k];
+					}
+
+					index = _mm256_add_epi32(index, one);
+				}
+
+				_mm256_storeu_ps(low + l, lo);
+				_mm256_storeu_ps(high + l, hi);
+			}
+
+			_mm256_zeroupper();
+			combBankScalar(line + l * lineStride, lineStride, readFrames + l, writeFrame, low + l, high + l, scale + l, lowCoef, highCoef, in, nFrames, nLanes - l);
+		}
+
+		NAUDIO_TARGET_AVX2 static void
+		allpassAVX2(float* io, float* dst, const float* src, float coef, size_t n) {
+			const __m256 c = _mm256_set1_ps(coef);
+			const __m256 gain = _mm256_set1_ps(1.0f + coef);
+			size_t i = 0;
+
+			for(; i + 8 <= n; i += 8) {
+				const __m256 p = _mm256_loadu_ps(src + i);
+				const __m256 y = _mm256_add_ps(_mm256_loadu_ps(io + i), _mm256_mul_ps(p, c));
+
+				_mm256_storeu_ps(dst + i, y);
+				_mm256_storeu_ps(io + i, _mm256_sub_ps(_mm256_mul_ps(gain, p), y));
+			}
+
+			_mm256_zeroupper();
+			allpassScalar(io + i, dst + i, src + i, coef, n - i);
+		}
+
+		//Eight lanes per vector. Pairs 4 apart swap the 128-bit halves.
+		NAUDIO_TARGET_AVX2 static void
+		fdnAVX2(float* dst, const float* src, float* low, const float* feedGain, const float* dampCoef, const float* inGain, const float* in, float* outLeft, float* outRight, size_t nLanes, size_t nFrames) {
+			const size_t nVectors = nLanes / 8;
+			const __m256 norm = _mm256_set1_ps(1.0f / sqrtf((float)nLanes));
+			const int sign = (int)0x80000000;
+			const __m256 flipOdd = _mm256_castsi256_ps(_mm256_setr_epi32(0, sign, 0, sign, 0, sign, 0, sign));
+			const __m256 flipPairs = _mm256_castsi256_ps(_mm256_setr_epi32(0, 0, sign, sign, 0, 0, sign, sign));
+			const __m256 flipHigh = _mm256_castsi256_ps(_mm256_setr_epi32(0, 0, 0, 0, sign, sign, sign, sign));
+
+			__m256 lo[2];
+			__m256 fg[2];
+			__m256 dc[2];
+			__m256 ig[2];
+			__m256 y[2];
+
+			for(size_t v = 0; v < nVectors; ++v) {
+				lo[v] = _mm256_loadu_ps(low + 8 * v);
+				fg[v] = _mm256_loadu_ps(feedGain + 8 * v);
+				dc[v] = _mm256_loadu_ps(dampCoef + 8 * v);
+				ig[v] = _mm256_loadu_ps(inGain + 8 * v);
+			}
+
+			for(size_t i = 0; i < nFrames; ++i) {
+				const float* x = src + i * nLanes;
+				float* out = dst + i * nLanes;
+
+				for(size_t v = 0; v < nVectors; ++v) {
+					lo[v] = _mm256_add_ps(_mm256_mul_ps(fg[v], _mm256_loadu_ps(x + 8 * v)), _mm256_mul_ps(dc[v], lo[v]));
+
+					//Pairs 1, 2 and 4 apart.
+					__m256 t = lo[v];
+
+					t = _mm256_add_ps(_mm256_xor_ps(t, flipOdd), _mm256_permute_ps(t, _MM_SHUFFLE(2, 3, 0, 1)));
+					t = _mm256_add_ps(_mm256_xor_ps(t, flipPairs), _mm256_permute_ps(t, _MM_SHUFFLE(1, 0, 3, 2)));
+					t = _mm256_add_ps(_mm256_xor_ps(t, flipHigh), _mm256_permute2f128_ps(t, t, 1));
+
+					y[v] = t;
+				}
+
+				if(nVectors == 2) {
+					const __m256 a = y[0];
+
+					y[0] = _mm256_add_ps(a, y[1]);
+					y[1] = _mm256_sub_ps(a, y[1]);
+				}
+
+				const __m256 vin = _mm256_set1_ps(in[i]);
+
+				for(size_t v = 0; v < nVectors; ++v) {
+					y[v] = _mm256_mul_ps(y[v], norm);
+
+					_mm256_storeu_ps(out + 8 * v, _mm256_add_ps(y[v], _mm256_mul_ps(ig[v], vin)));
+				}
+
+				const __m128 first = _mm256_castps256_ps128(y[0]);
+
+				outLeft[i] = _mm_cvtss_f32(first);
+				outRight[i] = _mm_cvtss_f32(_mm_shuffle_ps(first, first, _MM_SHUFFLE(1, 1, 1, 1)));
+			}
+
+			for(size_t v = 0; v < nVectors; ++v) {
+				_mm256_storeu_ps(low + 8 * v, lo[v]);
+			}
+		}
+
+		//A cascade is at most 4 lanes, which SSE2 already covers.
+		#define biquadCascadeAVX2		biquadCascadeSSE2
+
+		//Same steps as fastLog2() and fastExp2(), 8 samples at a time.
+		NAUDIO_TARGET_AVX2 static inline __m256
+		fastLog2AVX2(__m256 x) {
+			const __m256i bits = _mm256_castps_si256(x);
+			const __m256 exponent = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_and_si256(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(0xFF)), _mm256_set1_epi32(127)));
+			const __m256 t = _mm256_sub_ps(_mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007FFFFF)), _mm256_set1_epi32(0x3F800000))), _mm256_set1_ps(1.0f));
+
+			__m256 p = _mm256_set1_ps(0.0448740f);
+
+			p = _mm256_add_ps(_mm256_set1_ps(-0.1954072f), _mm256_mul_ps(t, p));
+			p = _mm256_add_ps(_mm256_set1_ps(0.4201112f), _mm256_mul_ps(t, p));
+			p = _mm256_add_ps(_mm256_set1_ps(-0.7119966f), _mm256_mul_ps(t, p));
+			p = _mm256_add_ps(_mm256_set1_ps(1.4424186f), _mm256_mul_ps(t, p));
+
+			return(_mm256_add_ps(exponent, _mm256_mul_ps(t, p)));
+		}
+
+		NAUDIO_TARGET_AVX2 static inline __m256
+		fastExp2AVX2(__m256 x) {
+			const __m256 biased = _mm256_add_ps(_mm256_min_ps(_mm256_max_ps(x, _mm256_set1_ps(-126.0f)), _mm256_set1_ps(126.0f)), _mm256_set1_ps(127.0f));
+			const __m256i exponent = _mm256_cvttps_epi32(biased);
+			const __m256 t = _mm256_sub_ps(biased, _mm256_cvtepi32_ps(exponent));
+
+			__m256 p = _mm256_set1_ps(0.0018965f);
+
+			p = _mm256_add_ps(_mm256_set1_ps(0.0089702f), _mm256_mul_ps(t, p));
+			p = _mm256_add_ps(_mm256_set1_ps(0.0558116f), _mm256_mul_ps(t, p));
+			p = _mm256_add_ps(_mm256_set1_ps(0.2401729f), _mm256_mul_ps(t, p));
+			p = _mm256_add_ps(_mm256_set1_ps(0.6931488f), _mm256_mul_ps(t, p));
+			p = _mm256_add_ps(_mm256_set1_ps(1.0f), _mm256_mul_ps(t, p));
+
+			return(_mm256_mul_ps(_mm256_castsi256_ps(_mm256_slli_epi32(exponent, 23)), p));
+		}
+
+		NAUDIO_TARGET_AVX2 static float
+		levelDetectAVX2(float* dst, const float* src, size_t nChannels, bool squared, size_t nFrames) {
+			const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+			__m256 peak = _mm256_setzero_ps();
+			size_t i = 0;
+
+			for(; i + 8 <= nFrames; i += 8) {
+				__m256 level;
+
+				if(nChannels == 2) {
+					__m256 a = _mm256_loadu_ps(src + 2 * i);
+					__m256 b = _mm256_loadu_ps(src + 2 * i + 8);
+
+					a = squared ? _mm256_mul_ps(a, a) : _mm256_and_ps(a, absMask);
+					b = squared ? _mm256_mul_ps(b, b) : _mm256_and_ps(b, absMask);
+					level = _mm256_max_ps(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)), _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+					level = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(level), _MM_SHUFFLE(3, 1, 2, 0)));
+				}
+				else {
+					const __m256 x = _mm256_loadu_ps(src + i);
+
+					level = squared ? _mm256_mul_ps(x, x) : _mm256_and_ps(x, absMask);
+				}
+
+				_mm256_storeu_ps(dst + i, level);
+				peak = _mm256_max_ps(peak, level);
+			}
+
+			const float vectorPeak = horizontalMaxSSE2(_mm_max_ps(_mm256_castps256_ps128(peak), _mm256_extractf128_ps(peak, 1)));
+
+			_mm256_zeroupper();
+
+			return(Max(vectorPeak, levelDetectScalar(dst + i, src + i * nChannels, nChannels, squared, nFrames - i)));
+		}
+
+		NAUDIO_TARGET_AVX2 static void
+		gainComputerAVX2(float* io, float levelDbScale, float thresholdDb, float knee, float slope, size_t n) {
+			const __m256 vScale = _mm256_set1_ps(levelDbScale);
+			const __m256 vThreshold = _mm256_set1_ps(thresholdDb);
+			const __m256 vHalfKnee = _mm256_set1_ps(0.5f * knee);
+			const __m256 vKnee = _mm256_set1_ps(knee);
+			const __m256 vInvTwoKnee = _mm256_set1_ps((knee > 0.0f) ? 0.5f / knee : 0.0f);
+			const __m256 vSlope = _mm256_set1_ps(slope);
+			const __m256 zero = _mm256_setzero_ps();
+			size_t i = 0;
+
+			for(; i + 8 <= n; i += 8) {
+				const __m256 over = _mm256_sub_ps(_mm256_mul_ps(vScale, fastLog2AVX2(_mm256_loadu_ps(io + i))), vThreshold);
+				const __m256 x = _mm256_min_ps(_mm256_max_ps(_mm256_add_ps(over, vHalfKnee), zero), vKnee);
+
+				_mm256_storeu_ps(io + i, _mm256_mul_ps(vSlope, _mm256_add_ps(_mm256_mul_ps(_mm256_mul_ps(x, x), vInvTwoKnee), _mm256_max_ps(_mm256_sub_ps(over, vHalfKnee), zero))));
+			}
+
+			_mm256_zeroupper();
+			gainComputerScalar(io + i, levelDbScale, thresholdDb, knee, slope, n - i);
+		}
+
+		NAUDIO_TARGET_AVX2 static void
+		exp2ScaledAVX2(float* io, float scale, float gain, size_t n) {
+			const __m256 vScale = _mm256_set1_ps(scale);
+			const __m256 vGain = _mm256_set1_ps(gain);
+			size_t i = 0;
+
+			for(; i + 8 <= n; i += 8) {
+				_mm256_storeu_ps(io + i, _mm256_mul_ps(vGain, fastExp2AVX2(_mm256_mul_ps(vScale, _mm256_loadu_ps(io + i)))));
+			}
+
+			_mm256_zeroupper();
+			exp2ScaledScalar(io + i, scale, gain, n - i);
+		}
+
+		//The noise stream is 4 lanes wide, which SSE2 already covers.
+		#define noiseFillAVX2			noiseFillSSE2
+
+		static const SIMDKernels_ s_avx2Kernels = {
+			SIMDLevelAVX2,
+			addAVX2, subAVX2, mulAVX2, divAVX2,
+			addMonoAVX2, subMonoAVX2, mulMonoAVX2, divMonoAVX2,
+			addLeftAVX2, subLeftAVX2, mulLeftAVX2, divLeftAVX2,
+			scaleAVX2, offsetAVX2, fillAVX2, upmixAVX2, downmixAVX2,
+			firSymmetricAVX2, firAVX2, complexMultiplyAddAVX2, fftButterflyAVX2,
+			addScaledAVX2, combBankAVX2, allpassAVX2, fdnAVX2, biquadCascadeAVX2,
+			levelDetectAVX2, gainComputerAVX2, exp2ScaledAVX2, noiseFillAVX2
+		};
+
+		static bool
+		cpuSupportsAVX2() {
+	#if defined(_MSC_VER) && !defined(__clang__)
+			int info[4];
+
+			__cpuid(info, 0);
+
+			if(info[0] < 7) {
+				return(false);
+			}
+
+			//AVX and OSXSAVE, then check the OS saves the YMM state.
+			__cpuid(info, 1);
+
+			if((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0 || (_xgetbv(0) & 0x6) != 0x6) {
+				return(false);
+			}
+
+			__cpuidex(info, 7, 0);
+
+			return((info[1] & (1 << 5)) != 0);
+	#else
+			__builtin_cpu_init();
+
+			return(__builtin_cpu_supports("avx2") != 0);
+	#endif
+		}
+#endif
+
+#if defined(NAUDIO_SIMD_NEON)
+		//NEON kernels, 4 samples per iteration. vld2/vst2 do the (de)interleaving of stereo frames.
+		#define NAUDIO_NEON_BINARY(name, vop)																\
+			static void																						\
+			name##NEON(float* dst, const float* src, size_t n) {											\
+				size_t i = 0;																				\
+																											\
+				for(; i + 4 <= n; i += 4) {																	\
+					vst1q_f32(dst + i, vop(vld1q_f32(dst + i), vld1q_f32(src + i)));						\
+				}																							\
+																											\
+				name##Scalar(dst + i, src + i, n - i);														\
+			}																								\
+																											\
+			static void																						\
+			name##MonoNEON(float* dst, const float* src, size_t nFrames) {									\
+				size_t i = 0;																				\
+																											\
+				for(; i + 4 <= nFrames; i += 4) {															\
+					float32x4_t m = vld1q_f32(src + i);														\
+					float32x4x2_t d = vld2q_f32(dst + 2 * i);												\
+																											\
+					d.val[0] = vop(d.val[0], m);															\
+					d.val[1] = vop(d.val[1], m);															\
+					vst2q_f32(dst + 2 * i, d);																\
+				}																							\
+																											\
+				name##MonoScalar(dst + 2 * i, src + i, nFrames - i);										\
+			}																								\
+																											\
+			static void																						\
+			name##LeftNEON(float* dst, const float* src, size_t nFrames) {									\
+				size_t i = 0;																				\
+																											\
+				for(; i + 4 <= nFrames; i += 4) {															\
+					float32x4x2_t s = vld2q_f32(src + 2 * i);												\
+																											\
+					vst1q_f32(dst + i, vop(vld1q_f32(dst + i), s.val[0]));									\
+				}																							\
+																											\
+				name##LeftScalar(dst + i, src + 2 * i, nFrames - i);										\
+			}
+
+		NAUDIO_NEON_BINARY(add, vaddq_f32)
+		NAUDIO_NEON_BINARY(sub, vsubq_f32)
+		NAUDIO_NEON_BINARY(mul, vmulq_f32)
+
+	#if defined(__aarch64__) || defined(_M_ARM64)
+		NAUDIO_NEON_BINARY(div, vdivq_f32)
+	#else
+		//ARMv7 NEON has no exact vector divide, keep division scalar.
+		#define divNEON			divScalar
+		#define divMonoNEON		divMonoScalar
+		#define divLeftNEON		divLeftScalar
+	#endif
+
+		static void
+		scaleNEON(float* dst, float s, size_t n) {
+			size_t i = 0;
+
+			for(; i + 4 <= n; i += 4) {
+				vst1q_f32(dst + i, vmulq_n_f32(vld1q_f32(dst + i), s));
+			}
+
+			scaleScalar(dst + i, s, n - i);
+		}
+
+		static void
+		offsetNEON(float* dst, float s, size_t n) {
+			float32x4_t vs = vdupq_n_f32(s);
+			size_t i = 0;
+
+			for(; i + 4 <= n; i += 4) {
+				vst1q_f32(dst + i, vaddq_f32(vld1q_f32(dst + i), vs));
+			}
+
+			offsetScalar(dst + i, s, n - i);
+		}
+
+		static void
+		fillNEON(float* dst, float value, size_t n) {
+			float32x4_t v = vdupq_n_f32(value);
+			size_t i = 0;
+
+			for(; i + 4 <= n; i += 4) {
+				vst1q_f32(dst + i, v);
+			}
+
+			fillScalar(dst + i, value, n - i);
+		}
+
+		static void
+		upmixNEON(float* dst, const float* src, size_t nFrames) {
+			size_t i = 0;
+
+			for(; i + 4 <= nFrames; i += 4) {
+				float32x4x2_t d;
+
+				d.val[0] = vld1q_f32(src + i);
+				d.val[1] = d.val[0];
+				vst2q_f32(dst + 2 * i, d);
+			}
+
+			upmixScalar(dst + 2 * i, src + i, nFrames - i);
+		}
+
+		static void
+		downmixNEON(float* dst, const float* src, size_t nFrames) {
+			size_t i = 0;
+
+			for(; i + 4 <= nFrames; i += 4) {
+				float32x4x2_t s = vld2q_f32(src + 2 * i);
+
+				vst1q_f32(dst + i, vmulq_n_f32(vaddq_f32(s.val[0], s.val[1]), 0.5f));
+			}
+
+			downmixScalar(dst + i, src + 2 * i, nFrames - i);
+		}
+
+		static void
+		firSymmetricNEON(float* dst, const float* src, const float* coef, size_t nPairs, size_t n) {
+			const size_t last = 2 * nPairs - 1;
+			size_t i = 0;
+
+			for(; i + 4 <= n; i += 4) {
+				float32x4_t acc = vdupq_n_f32(0.0f);
+
+				for(size_t t = 0; t < nPairs; ++t) {
+					float32x4_t pair = vaddq_f32(vld1q_f32(src + i + t), vld1q_f32(src + i + last - t));
+					acc = vaddq_f32(acc, vmulq_n_f32(pair, coef[t]));
+				}
+
+				vst1q_f32(dst + i, acc);
+			}
+
+			firSymmetricScalar(dst + i, src + i, coef, nPairs, n - i);
+		}
+
+		static void
+		firNEON(float* dst, const float* src, const float* coef, size_t nTaps, size_t n) {
+			size_t i = 0;
+
+			for(; i + 4 <= n; i += 4) {
+				float32x4_t acc = vdupq_n_f32(0.0f);
+
+				for(size_t t = 0; t < nTaps; ++t) {
+					acc = vaddq_f32(acc, vmulq_n_f32(vld1q_f32(src + i + t), coef[t]));
+				}
+
+				vst1q_f32(dst + i, acc);
+			}
+
+			firScalar(dst + i, src + i, coef, nTaps, n - i);
+		}
+
+		static void
+		complexMultiplyAddNEON(float* dstRe, float* dstIm, const float* aRe, const float* aIm, const float* bRe, const float* bIm, size_t n) {
+			size_t i = 0;
+
+			for(; i + 4 <= n; i += 4) {
+				float32x4_t ar = vld1q_f32(aRe + i);
+				float32x4_t ai = vld1q_f32(aIm + i);
+				float32x4_t br = vld1q_f32(bRe + i);
+				float32x4_t bi = vld1q_f32(bIm + i);
+
+				vst1q_f32(dstRe + i, vaddq_f32(vld1q_f32(dstRe + i), vsubq_f32(vmulq_f32(ar, br), vmulq_f32(ai, bi))));
+				vst1q_f32(dstIm + i, vaddq_f32(vld1q_f32(dstIm + i), vaddq_f32(vmulq_f32(ar, bi), vmulq_f32(ai, br))));
+			}
+
+			complexMultiplyAddScalar(dstRe + i, dstIm + i, aRe + i, aIm + i, bRe + i, bIm + i, n - i);
+		}
+
+		static void
+		fftButterflyNEON(float* re0, float* im0, float* re1, float* im1, const float* wr, const float* wi, size_t n) {
+			size_t i = 0;
+
+			for(; i + 4 <= n; i += 4) {
+				float32x4_t r1 = vld1q_f32(re1 + i);
+				float32x4_t i1 = vld1q_f32(im1 + i);
+				float32x4_t c = vld1q_f32(wr + i);
+				float32x4_t d = vld1q_f32(wi + i);
+				float32x4_t r0 = vld1q_f32(re0 + i);
+				float32x4_t i0 = vld1q_f32(im0 + i);
+
+				float32x4_t tr = vsubq_f32(vmulq_f32(r1, c), vmulq_f32(i1, d));
+				float32x4_t ti = vaddq_f32(vmulq_f32(r1, d), vmulq_f32(i1, c));
+
+				vst1q_f32(re1 + i, vsubq_f32(r0, tr));
+				vst1q_f32(im1 + i, vsubq_f32(i0, ti));
+				vst1q_f32(re0 + i, vaddq_f32(r0, tr));
+				vst1q_f32(im0 + i, vaddq_f32(i0, ti));
+			}
+
+			fftButterflyScalar(re0 + i, im0 + i, re1 + i, im1 + i, wr + i, wi + i, n - i);
+		}
+
+		static void
+		addScaledNEON(float* dst, const float* src, float s, size_t n) {
+			const float32x4_t vs = vdupq_n_f32(s);
+			size_t i = 0;
+
+			for(; i + 4 <= n; i += 4) {
+				vst1q_f32(dst + i, vaddq_f32(vld1q_f32(dst + i), vmulq_f32(vs, vld1q_f32(src + i))));
+			}
+
+			addScaledScalar(dst + i, src + i, s, n - i);
+		}
+
+		//Four lanes per vector. The lines of a group are read and written one sample each per frame.
+		static void
+		combBankNEON(float* line, size_t lineStride, const size_t* readFrames, size_t writeFrame, float* low, float* high, const float* scale, float lowCoef, float highCoef, const float* in, size_t nFrames, size_t nLanes) {
+			const float32x4_t lowGain = vdupq_n_f32(1.0f - lowCoef);
+			const float32x4_t highGain = vdupq_n_f32(1.0f - highCoef);
+			const float32x4_t lc = vdupq_n_f32(lowCoef);
+			const float32x4_t hc = vdupq_n_f32(highCoef);
+			size_t l = 0;
+
+			for(; l + 4 <= nLanes; l += 4) {
+				const float* src0 = line + l * lineStride + readFrames[l];
+				const float* src1 = line + (l + 1) * lineStride + readFrames[l + 1];
+				const float* src2 = line + (l + 2) * lineStride + readFrames[l + 2];
+				const float* src3 = line + (l + 3) * lineStride + readFrames[l + 3];
+				float* dst = line + l * lineStride + writeFrame;
+
+				float32x4_t lo = vld1q_f32(low + l);
+				float32x4_t hi = vld1q_f32(high + l);
+				const float32x4_t sf = vld1q_f32(scale + l);
+
+				for(size_t i = 0; i < nFrames; ++i) {
+					float32x4_t x = vdupq_n_f32(src0[i]);
+
+					x = vsetq_lane_f32(src1[i], x, 1);
+					x = vsetq_lane_f32(src2[i], x, 2);
+					x = vsetq_lane_f32(src3[i], x, 3);
+
+					lo = vaddq_f32(vmulq_f32(lowGain, x), vmulq_f32(lc, lo));
+					hi = vsubq_f32(vmulq_f32(highGain, lo), vmulq_f32(hc, hi));
+
+					const float32x4_t y = vaddq_f32(vmulq_f32(hi, sf), vdupq_n_f32(in[i]));
+
+					dst[i] = vgetq_lane_f32(y, 0);
+					dst[i + lineStride] = vgetq_lane_f32(y, 1);
+					dst[i + 2 * lineStride] = vgetq_lane_f32(y, 2);
+					dst[i + 3 * lineStride] = vgetq_lane_f32(y, 3);
+				}
+
+				vst1q_f32(low + l, lo);
+				vst1q_f32(high + l, hi);
+			}
+
+			combBankScalar(line + l * lineStride, lineStride, readFrames + l, writeFrame, low + l, high + l, scale + l, lowCoef, highCoef, in, nFrames, nLanes - l);
+		}
+
+		static void
+		allpassNEON(float* io, float* dst, const float* src, float coef, size_t n) {
+			const float32x4_t c = vdupq_n_f32(coef);
+			const float32x4_t gain = vdupq_n_f32(1.0f + coef);
+			size_t i = 0;
+
+			for(; i + 4 <= n; i += 4) {
+				const float32x4_t p = vld1q_f32(src + i);
+				const float32x4_t y = vaddq_f32(vld1q_f32(io + i), vmulq_f32(p, c));
+
+				vst1q_f32(dst + i, y);
+				vst1q_f32(io + i, vsubq_f32(vmulq_f32(gain, p), y));
+			}
+
+			allpassScalar(io + i, dst + i, src + i, coef, n - i);
+		}
+
+		//Four lanes per vector. Butterflies within a vector are a lane swap and a sign flip, the ones between vectors plain adds.
+		static void
+		fdnNEON(float* dst, const float* src, float* low, const float* feedGain, const float* dampCoef, const float* inGain, const float* in, float* outLeft, float* outRight, size_t nLanes, size_t nFrames) {
+			const size_t nVectors = nLanes / 4;
+			const float32x4_t norm = vdupq_n_f32(1.0f / sqrtf((float)nLanes));
+			const float oddSigns[4] = { 1.0f, -1.0f, 1.0f, -1.0f };
+			const float highSigns[4] = { 1.0f, 1.0f, -1.0f, -1.0f };
+			const float32x4_t flipOdd = vld1q_f32(oddSigns);
+			const float32x4_t flipHigh = vld1q_f32(highSigns);
+
+			float32x4_t lo[4];
+			float32x4_t fg[4];
+			float32x4_t dc[4];
+			float32x4_t ig[4];
+			float32x4_t y[4];
+
+			for(size_t v = 0; v < nVectors; ++v) {
+				lo[v] = vld1q_f32(low + 4 * v);
+				fg[v] = vld1q_f32(feedGain + 4 * v);
+				dc[v] = vld1q_f32(dampCoef + 4 * v);
+				ig[v] = vld1q_f32(inGain + 4 * v);
+			}
+
+			for(size_t i = 0; i < nFrames; ++i) {
+				const float* x = src + i * nLanes;
+				float* out = dst + i * nLanes;
+
+				for(size_t v = 0; v < nVectors; ++v) {
+					lo[v] = vaddq_f32(vmulq_f32(fg[v], vld1q_f32(x + 4 * v)), vmulq_f32(dc[v], lo[v]));
+
+					//Pairs 1 apart, then 2 apart. Multiplying by -1 flips the sign exactly.
+					float32x4_t t = lo[v];
+
+					t = vaddq_f32(vmulq_f32(t, flipOdd), vrev64q_f32(t));
+					t = vaddq_f32(vmulq_f32(t, flipHigh), vcombine_f32(vget_high_f32(t), vget_low_f32(t)));
+
+					y[v] = t;
+				}
+
+				for(size_t h = 1; h < nVectors; h *= 2) {
+					for(size_t j = 0; j < nVectors; j += 2 * h) {
+						for(size_t k = j; k < j + h; ++k) {
+							const float32x4_t a = y[k];
+							const float32x4_t b = y[k + h];
+
+							y[k] = vaddq_f32(a, b);
+							y[k + h] = vsubq_f32(a, b);
+						}
+					}
+				}
+
+				const float32x4_t vin = vdupq_n_f32(in[i]);
+
+				for(size_t v = 0; v < nVectors; ++v) {
+					y[v] = vmulq_f32(y[v], norm);
+
+					vst1q_f32(out + 4 * v, vaddq_f32(y[v], vmulq_f32(ig[v], vin)));
+				}
+
+				outLeft[i] = vgetq_lane_f32(y[0], 0);
+				outRight[i] = vgetq_lane_f32(y[0], 1);
+			}
+
+			for(size_t v = 0; v < nVectors; ++v) {
+				vst1q_f32(low + 4 * v, lo[v]);
+			}
+		}
+
+		//The whole cascade fits one vector. While the wavefront fills and drains, idle lanes keep their state and coefficients through a mask.
+		static void
+		biquadCascadeNEON(float* out, const float* in, float* state, float* coef, const float* coefStep, size_t nChannels, size_t nStages, size_t nFrames) {
+			const size_t nLanes = nChannels * nStages;
+			const size_t lastLane = nLanes - nChannels;
+			const float32x4_t zero = vdupq_n_f32(0.0f);
+
+			float32x4_t s1 = vld1q_f32(state);
+			float32x4_t s2 = vld1q_f32(state + 4);
+
+			float32x4_t b0 = vld1q_f32(coef);
+			float32x4_t b1 = vld1q_f32(coef + 4);
+			float32x4_t b2 = vld1q_f32(coef + 8);
+			float32x4_t a1 = vld1q_f32(coef + 12);
+			float32x4_t a2 = vld1q_f32(coef + 16);
+
+			const bool steps = (coefStep != NULL);
+			const float32x4_t db0 = steps ? vld1q_f32(coefStep) : zero;
+			const float32x4_t db1 = steps ? vld1q_f32(coefStep + 4) : zero;
+			const float32x4_t db2 = steps ? vld1q_f32(coefStep + 8) : zero;
+			const float32x4_t da1 = steps ? vld1q_f32(coefStep + 12) : zero;
+			const float32x4_t da2 = steps ? vld1q_f32(coefStep + 16) : zero;
+
+			//Stage of every lane. Lanes past the cascade are never active.
+			const int laneStages[4] = { 0, (int)(1 / nChannels), (nLanes > 2) ? (int)(2 / nChannels) : 0x3fffffff, (nLanes > 3) ? (int)(3 / nChannels) : 0x3fffffff };
+			const int32x4_t stages = vld1q_s32(laneStages);
+			const int32x4_t frameCount = vdupq_n_s32((int)nFrames);
+
+			float32x4_t y = zero;
+			float lanes[4];
+
+			for(size_t i = 0; i < nFrames + nStages - 1; ++i) {
+				float32x4_t x = zero;
+
+				if(i < nFrames) {
+					x = (nChannels == 1) ? vsetq_lane_f32(in[i], zero, 0) : vcombine_f32(vld1_f32(in + 2 * i), vdup_n_f32(0.0f));
+				}
+
+				//The first stage takes the input, every other one the output of the stage before it, one frame behind.
+				const float32x4_t shifted = (nChannels == 1) ? vextq_f32(zero, y, 3) : vextq_f32(zero, y, 2);
+
+				x = vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(x), vreinterpretq_u32_f32(shifted)));
+
+				if(i + 1 >= nStages && i < nFrames) {
+					if(steps) {
+						b0 = vaddq_f32(b0, db0);
+						b1 = vaddq_f32(b1, db1);
+						b2 = vaddq_f32(b2, db2);
+						a1 = vaddq_f32(a1, da1);
+						a2 = vaddq_f32(a2, da2);
+					}
+
+					y = vaddq_f32(vmulq_f32(b0, x), s1);
+					s1 = vaddq_f32(vsubq_f32(vmulq_f32(b1, x), vmulq_f32(a1, y)), s2);
+					s2 = vsubq_f32(vmulq_f32(b2, x), vmulq_f32(a2, y));
+				}
+				else {
+					const int32x4_t frame = vsubq_s32(vdupq_n_s32((int)i), stages);
+					const uint32x4_t active = vandq_u32(vcgeq_s32(frame, vdupq_n_s32(0)), vcltq_s32(frame, frameCount));
+
+					if(steps) {
+						b0 = vaddq_f32(b0, vbslq_f32(active, db0, zero));
+						b1 = vaddq_f32(b1, vbslq_f32(active, db1, zero));
+						b2 = vaddq_f32(b2, vbslq_f32(active, db2, zero));
+						a1 = vaddq_f32(a1, vbslq_f32(active, da1, zero));
+						a2 = vaddq_f32(a2, vbslq_f32(active, da2, zero));
+					}
+
+					y = vaddq_f32(vmulq_f32(b0, x), s1);
+
+					s1 = vbslq_f32(active, vaddq_f32(vsubq_f32(vmulq_f32(b1, x), vmulq_f32(a1, y)), s2), s1);
+					s2 = vbslq_f32(active, vsubq_f32(vmulq_f32(b2, x), vmulq_f32(a2, y)), s2);
+				}
+
+				if(i + 1 >= nStages) {
+					vst1q_f32(lanes, y);
+
+					for(size_t ch = 0; ch < nChannels; ++ch) {
+						out[(i + 1 - nStages) * nChannels + ch] = lanes[lastLane + ch];
+					}
+				}
+			}
+
+			vst1q_f32(state, s1);
+			vst1q_f32(state + 4, s2);
+
+			if(steps) {
+				vst1q_f32(coef, b0);
+				vst1q_f32(coef + 4, b1);
+				vst1q_f32(coef + 8, b2);
+				vst1q_f32(coef + 12, a1);
+				vst1q_f32(coef + 16, a2);
+			}
+		}
+
+		//Same steps as fastLog2() and fastExp2(), 4 samples at a time.
+		static inline float32x4_t
+		fastLog2NEON(float32x4_t x) {
+			const uint32x4_t bits = vreinterpretq_u32_f32(x);
+			const float32x4_t exponent = vcvtq_f32_s32(vsubq_s32(vreinterpretq_s32_u32(vandq_u32(vshrq_n_u32(bits, 23), vdupq_n_u32(0xFF))), vdupq_n_s32(127)));
+			const float32x4_t t = vsubq_f32(vreinterpretq_f32_u32(vorrq_u32(vandq_u32(bits, vdupq_n_u32(0x007FFFFF)), vdupq_n_u32(0x3F800000))), vdupq_n_f32(1.0f));
+
+			float32x4_t p = vdupq_n_f32(0.0448740f);
+
+			p = vaddq_f32(vdupq_n_f32(-0.1954072f), vmulq_f32(t, p));
+			p = vaddq_f32(vdupq_n_f32(0.4201112f), vmulq_f32(t, p));
+			p = vaddq_f32(vdupq_n_f32(-0.7119966f), vmulq_f32(t, p));
+			p = vaddq_f32(vdupq_n_f32(1.4424186f), vmulq_f32(t, p));
+
+			return(vaddq_f32(exponent, vmulq_f32(t, p)));
+		}
+
+		static inline float32x4_t
+		fastExp2NEON(float32x4_t x) {
+			const float32x4_t biased = vaddq_f32(vminq_f32(vmaxq_f32(x, vdupq_n_f32(-126.0f)), vdupq_n_f32(126.0f)), vdupq_n_f32(127.0f));
+			const int32x4_t exponent = vcvtq_s32_f32(biased);
+			const float32x4_t t = vsubq_f32(biased, vcvtq_f32_s32(exponent));
+
+			float32x4_t p = vdupq_n_f32(0.0018965f);
+
+			p = vaddq_f32(vdupq_n_f32(0.0089702f), vmulq_f32(t, p));
+			p = vaddq_f32(vdupq_n_f32(0.0558116f), vmulq_f32(t, p));
+			p = vaddq_f32(vdupq_n_f32(0.2401729f), vmulq_f32(t, p));
+			p = vaddq_f32(vdupq_n_f32(0.6931488f), vmulq_f32(t, p));
+			p = vaddq_f32(vdupq_n_f32(1.0f), vmulq_f32(t, p));
+
+			return(vmulq_f32(vreinterpretq_f32_s32(vshlq_n_s32(exponent, 23)), p));
+		}
+
+		static float
+		levelDetectNEON(float* dst, const float* src, size_t nChannels, bool squared, size_t nFrames) {
+			float32x4_t peak = vdupq_n_f32(0.0f);
+			size_t i = 0;
+
+			for(; i + 4 <= nFrames; i += 4) {
+				float32x4_t level;
+
+				if(nChannels == 2) {
+					const float32x4x2_t s = vld2q_f32(src + 2 * i);
+
+					level = squared ? vmaxq_f32(vmulq_f32(s.val[0], s.val[0]), vmulq_f32(s.val[1], s.val[1])) : vmaxq_f32(vabsq_f32(s.val[0]), vabsq_f32(s.val[1]));
+				}
+				else {
+					const float32x4_t x = vld1q_f32(src + i);
+
+					level = squared ? vmulq_f32(x, x) : vabsq_f32(x);
+				}
+
+				vst1q_f32(dst + i, level);
+				peak = vmaxq_f32(peak, level);
+			}
+
+			float32x2_t pairs = vpmax_f32(vget_low_f32(peak), vget_high_f32(peak));
+
+			pairs = vpmax_f32(pairs, pairs);
+
+			return(Max(vget_lane_f32(pairs, 0), levelDetectScalar(dst + i, src + i * nChannels, nChannels, squared, nFrames - i)));
+		}
+
+		static void
+		gainComputerNEON(float* io, float levelDbScale, float thresholdDb, float knee, float slope, size_t n) {
+			const float32x4_t vThreshold = vdupq_n_f32(thresholdDb);
+			const float32x4_t vHalfKnee = vdupq_n_f32(0.5f * knee);
+			const float32x4_t vKnee = vdupq_n_f32(knee);
+			const float32x4_t zero = vdupq_n_f32(0.0f);
+			const float invTwoKnee = (knee > 0.0f) ? 0.5f / knee : 0.0f;
+			size_t i = 0;
+
+			for(; i + 4 <= n; i += 4) {
+				const float32x4_t over = vsubq_f32(vmulq_n_f32(fastLog2NEON(vld1q_f32(io + i)), levelDbScale), vThreshold);
+				const float32x4_t x = vminq_f32(vmaxq_f32(vaddq_f32(over, vHalfKnee), zero), vKnee);
+
+				vst1q_f32(io + i, vmulq_n_f32(vaddq_f32(vmulq_n_f32(vmulq_f32(x, x), invTwoKnee), vmaxq_f32(vsubq_f32(over, vHalfKnee), zero)), slope));
+			}
+
+			gainComputerScalar(io + i, levelDbScale, thresholdDb, knee, slope, n - i);
+		}
+
+		static void
+		exp2ScaledNEON(float* io, float scale, float gain, size_t n) {
+			size_t i = 0;
+
+			for(; i + 4 <= n; i += 4) {
+				vst1q_f32(io + i, vmulq_n_f32(fastExp2NEON(vmulq_n_f32(vld1q_f32(io + i), scale)), gain));
+			}
+
+			exp2ScaledScalar(io + i, scale, gain, n - i);
+		}
+
+		//The 4 lanes are one vector per state word.
+		static void
+		noiseFillNEON(float* dst, unsigned int* state, size_t n) {
+			uint32x4_t s0 = vld1q_u32(state);
+			uint32x4_t s1 = vld1q_u32(state + 4);
+			uint32x4_t s2 = vld1q_u32(state + 8);
+			uint32x4_t s3 = vld1q_u32(state + 12);
+
+			const float32x4_t one = vdupq_n_f32(1.0f);
+			size_t i = 0;
+
+			for(; i + 4 <= n; i += 4) {
+				const uint32x4_t result = vaddq_u32(s0, s3);
+				const uint32x4_t t = vshlq_n_u32(s1, 9);
+
+				s2 = veorq_u32(s2, s0);
+				s3 = veorq_u32(s3, s1);
+				s1 = veorq_u32(s1, s2);
+				s0 = veorq_u32(s0, s3);
+				s2 = veorq_u32(s2, t);
+				s3 = vorrq_u32(vshlq_n_u32(s3, 11), vshrq_n_u32(s3, 21));
+
+				vst1q_f32(dst + i, vsubq_f32(vmulq_n_f32(vcvtq_f32_u32(vshrq_n_u32(result, 8)), 1.0f / 8388608.0f), one));
+			}
+
+			vst1q_u32(state, s0);
+			vst1q_u32(state + 4, s1);
+			vst1q_u32(state + 8, s2);
+			vst1q_u32(state + 12, s3);
+
+			noiseFillScalar(dst + i, state, n - i);
+		}
+
+		static const SIMDKernels_ s_neonKernels = {
+			SIMDLevelNEON,
+			addNEON, subNEON, mulNEON, divNEON,
+			addMonoNEON, subMonoNEON, mulMonoNEON, divMonoNEON,
+			addLeftNEON, subLeftNEON, mulLeftNEON, divLeftNEON,
+			scaleNEON, offsetNEON, fillNEON, upmixNEON, downmixNEON,
+			firSymmetricNEON, firNEON, complexMultiplyAddNEON, fftButterflyNEON,
+			addScaledNEON, combBankNEON, allpassNEON, fdnNEON, biquadCascadeNEON,
+			levelDetectNEON, gainComputerNEON, exp2ScaledNEON, noiseFillNEON
+		};
+#endif
+
+		//Return the kernel table for a level, or NULL if this build or CPU can't run it.
+		static const SIMDKernels_*
+		kernelsForLevel(SIMDLevel level) {
+			switch(level) {
+#if defined(NAUDIO_SIMD_AVX2)
+				case SIMDLevelAVX2:
+					return(cpuSupportsAVX2() ? &s_avx2Kernels : NULL);
+#endif
+#if defined(NAUDIO_SIMD_SSE2)
+				case SIMDLevelSSE2:
+					return(&s_sse2Kernels);
+#endif
+#if defined(NAUDIO_SIMD_NEON)
+				case SIMDLevelNEON:
+					return(&s_neonKernels);
+#endif
+				case SIMDLevelScalar:
+					return(&s_scalarKernels);
+
+				default:
+					return(NULL);
+			}
+		}
+
+		void
+		selectSIMDKernels() {
+			static const SIMDLevel preferred[] = { SIMDLevelAVX2, SIMDLevelSSE2, SIMDLevelNEON, SIMDLevelScalar };
+
+			for(unsigned int i = 0; i < sizeof(preferred) / sizeof(preferred[0]); ++i) {
+				const SIMDKernels_* kernels = kernelsForLevel(preferred[i]);
+
+				if(kernels != NULL) {
+					s_simdKernels.store(kernels, std::memory_order_release);
+					return;
+				}
+			}
+		}
+	}
+
+	SIMDLevel
+	getSIMDLevel() {
+		return(NAudio_DSP::SIMD().level);
+	}
+
+	void
+	setSIMDLevel(SIMDLevel level) {
+		const NAudio_DSP::SIMDKernels_* kernels = NAudio_DSP::kernelsForLevel(level);
+
+		if(kernels == NULL) {
+			LOG(NLOG_WARN, "SIMD level %d is not supported on this CPU, using the best supported level instead.", (int)level);
+			NAudio_DSP::selectSIMDKernels();
+		}
+		else {
+			NAudio_DSP::s_simdKernels.store(kernels, std::memory_order_release);
+		}
+	}
+}
\ No newline at end of file
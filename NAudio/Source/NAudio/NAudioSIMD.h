@@ -0,0 +1,138 @@
+#pragma once
+
+#include "NAudioCore.h"
+
+#include <atomic>
+
+//Vectorized block kernels used by NAudioFrames and the generators that work on raw sample blocks.
+//One kernel table exists per instruction set (scalar, SSE2, AVX2, NEON). The best table supported by the running CPU is chosen on first use.
+//Define NAUDIO_DISABLE_SIMD to compile only the scalar kernels.
+namespace NAudio {
+	//Instruction sets the kernels can be compiled for.
+	typedef enum {
+		SIMDLevelScalar = 0,
+		SIMDLevelSSE2,
+		SIMDLevelAVX2,
+		SIMDLevelNEON
+	} SIMDLevel;
+
+	namespace NAudio_DSP {
+		//Kernel table for one instruction set. Pointers do not need to be aligned. Stereo buffers are interleaved.
+		struct SIMDKernels_ {
+			SIMDLevel level;
+
+			//dst[i] (op)= src[i] over n samples.
+			void (*add)(float* dst, const float* src, size_t n);
+			void (*sub)(float* dst, const float* src, size_t n);
+			void (*mul)(float* dst, const float* src, size_t n);
+			void (*div)(float* dst, const float* src, size_t n);
+
+			//Stereo dst, mono src. Both channels of dst frame i (op)= src[i].
+			void (*addMono)(float* dst, const float* src, size_t nFrames);
+			void (*subMono)(float* dst, const float* src, size_t nFrames);
+			void (*mulMono)(float* dst, const float* src, size_t nFrames);
+			void (*divMono)(float* dst, const float* src, size_t nFrames);
+
+			//Mono dst, stereo src. dst[i] (op)= left channel of src frame i.
+			void (*addLeft)(float* dst, const float* src, size_t nFrames);
+			void (*subLeft)(float* dst, const float* src, size_t nFrames);
+			void (*mulLeft)(float* dst, const float* src, size_t nFrames);
+			void (*divLeft)(float* dst, const float* src, size_t nFrames);
+
+			//dst[i] *= s over n samples.
+			void (*scale)(float* dst, float s, size_t n);
+
+			//dst[i] += s over n samples.
+			void (*offset)(float* dst, float s, size_t n);
+
+			//dst[i] = value over n samples.
+			void (*fill)(float* dst, float value, size_t n);
+
+			//Stereo dst, mono src. src is copied to both channels.
+			void (*upmix)(float* dst, const float* src, size_t nFrames);
+
+			//Mono dst, stereo src. dst is the average of both channels.
+			void (*downmix)(float* dst, const float* src, size_t nFrames);
+
+			//Symmetric FIR over a contiguous mono history: dst[i] = sum over t < nPairs of coef[t] * (src[i + t] + src[i + 2 * nPairs - 1 - t]).
+			//src holds n + 2 * nPairs - 1 samples. Every level adds the tap pairs in the same order.
+			void (*firSymmetric)(float* dst, const float* src, const float* coef, size_t nPairs, size_t n);
+
+			//FIR over a contiguous mono history: dst[i] = sum over t < nTaps of coef[t] * src[i + t]. src holds n + nTaps - 1 samples.
+			void (*fir)(float* dst, const float* src, const float* coef, size_t nTaps, size_t n);
+
+			//Complex multiply-accumulate on split complex data: dst[i] += a[i] * b[i].
+			void (*complexMultiplyAdd)(float* dstRe, float* dstIm, const float* aRe, const float* aIm, const float* bRe, const float* bIm, size_t n);
+
+			//Radix-2 FFT butterflies on split complex data. With t = (re1[i], im1[i]) * (wr[i], wi[i]): x1 = x0 - t, then x0 += t.
+			void (*fftButterfly)(float* re0, float* im0, float* re1, float* im1, const float* wr, const float* wi, size_t n);
+
+			//dst[i] += s * src[i] over n samples.
+			void (*addScaled)(float* dst, const float* src, float s, size_t n);
+
+			//Bank of feedback comb filters with one-pole lowpass and highpass damping, one comb per lane. The delay line of lane l starts at line + l * lineStride.
+			//Frame i of lane l reads the line at readFrames[l] + i and writes at writeFrame + i, callers split blocks so neither wraps. Per frame:
+			//low = (1 - lowCoef) * read + lowCoef * low, high = (1 - highCoef) * low - highCoef * high, and high * scale[l] + in[i] is written.
+			void (*combBank)(float* line, size_t lineStride, const size_t* readFrames, size_t writeFrame, float* low, float* high, const float* scale, float lowCoef, float highCoef, const float* in, size_t nFrames, size_t nLanes);
+
+			//Allpass diffuser over one delay segment. With p = src[i] and y = io[i] + coef * p: dst[i] = y, then io[i] = (1 + coef) * p - y.
+			//src and dst are either the same samples or don't overlap.
+			void (*allpass)(float* io, float* dst, const float* src, float coef, size_t n);
+
+			//Feedback delay network frames. src and dst hold nFrames frames of nLanes samples, nLanes is 8 or 16. For frame i, with x frame i of src:
+			//low = feedGain * x + dampCoef * low, y = H * low with H the Hadamard matrix scaled by 1 / sqrt(nLanes), then outLeft[i] = y[0], outRight[i] = y[1] and frame i of dst = y + inGain * in[i].
+			//Every level runs the butterflies of H in the same order.
+			void (*fdn)(float* dst, const float* src, float* low, const float* feedGain, const float* dampCoef, const float* inGain, const float* in, float* outLeft, float* outRight, size_t nLanes, size_t nFrames);
+
+			//Cascade of biquads in transposed direct form II, one biquad per lane of 4. in and out hold nFrames interleaved frames of nChannels (1 or 2) and may be the same buffer.
+			//Lane l is stage l / nChannels of channel l % nChannels, with nChannels * nStages <= 4. Lanes past the cascade must have zero coefficients, steps and state.
+			//coef holds b0, b1, b2, a1, a2 and state holds s1, s2, 4 lanes each. For each sample x of a lane: y = b0 * x + s1, s1 = b1 * x - a1 * y + s2, s2 = b2 * x - a2 * y.
+			//Stages run as a wavefront, stage s on frame i - s, so the whole cascade is one pass over the block. If coefStep is not NULL, it is added to coef before every sample of a lane, and coef is left at its final value.
+			void (*biquadCascade)(float* out, const float* in, float* state, float* coef, const float* coefStep, size_t nChannels, size_t nStages, size_t nFrames);
+
+			//Level detection. src holds nFrames interleaved frames of nChannels (1 or 2). dst[i] is the largest |x|, or x * x if squared, of frame i. Returns the largest dst[i], 0 for no frames.
+			float (*levelDetect)(float* dst, const float* src, size_t nChannels, bool squared, size_t nFrames);
+
+			//Compressor gain computer, from levels to gain change in dB. With over = levelDbScale * fastLog2(io[i]) - thresholdDb and x = Clamp(over + knee / 2, 0, knee):
+			//io[i] = slope * (x * x / (2 * knee) + Max(over - knee / 2, 0)). A knee of 0 is a hard knee, io[i] = slope * Max(over, 0).
+			void (*gainComputer)(float* io, float levelDbScale, float thresholdDb, float knee, float slope, size_t n);
+
+			//io[i] = gain * fastExp2(scale * io[i]) over n samples.
+			void (*exp2Scaled)(float* io, float scale, float gain, size_t n);
+
+			//White noise from xoshiro128+ in 4 lanes. state holds words s0 to s3 of the lanes, planar, so word k of lane l is state[4 * k + l].
+			//dst[i] is randomWordToSample() of the next output of lane i % 4. A block that isn't a multiple of 4 only advances the lanes it uses, the next one starts at lane 0.
+			void (*noiseFill)(float* dst, unsigned int* state, size_t n);
+		};
+
+		//Currently selected kernel table. NULL until the first call to SIMD(). Atomic, so setSIMDLevel() can switch tables while other threads render.
+		extern std::atomic<const SIMDKernels_*> s_simdKernels;
+
+		//Select the best kernel table for the running CPU.
+		void
+		selectSIMDKernels();
+
+		//Return the active kernel table.
+		inline const SIMDKernels_&
+		SIMD() {
+			const SIMDKernels_* kernels = s_simdKernels.load(std::memory_order_acquire);
+
+			if(kernels == NULL) {
+				selectSIMDKernels();
+				kernels = s_simdKernels.load(std::memory_order_acquire);
+			}
+
+			return(*kernels);
+		}
+	}
+
+	//Return the instruction set used by the block kernels.
+	SIMDLevel
+	getSIMDLevel();
+
+	//Force the instruction set used by the block kernels (mostly useful for testing and benchmarking).
+	//If the level is not supported by this build or CPU, the best supported level is used instead.
+	//NOTE: CHANGING WHILE AUDIO IS RUNNING IS SAFE BUT MAY MIX KERNELS WITHIN ONE BLOCK.
+	void
+	setSIMDLevel(SIMDLevel level);
+}
\ No newline at end of file
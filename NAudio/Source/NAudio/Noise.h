@@ -1,23 +1,31 @@
 #pragma once
 
 #include "Generator.h"
-#include "NRNG/NRNG.h"
+#include "RandomUtils.h"
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#endif
 
 namespace NAudio {
 	namespace NAudio_DSP {
 		class Noise_ : public Generator_ {
 		protected:
+			Xoshiro128 random_;
+
 			void
 			computeSynthesisBlock(const SynthesisContext_& context);
+
+		public:
+			void
+			setSeed(unsigned long long seed) {
+				random_.seed(seed);
+			}
 		};
 
 		inline void
 		Noise_::computeSynthesisBlock(const SynthesisContext_& context) {
-			float* fdata = &outputFrames_[0];
-
-			for(unsigned int i = 0; i < outputFrames_.Size(); ++i) {
-				*fdata++ = NRNG::GetInstance()->GetSample();
-			}
+			random_.fill(&outputFrames_[0], outputFrames_.Size());
 		}
 
 #define kNumPinkNoiseBins			16
@@ -31,6 +39,8 @@ namespace NAudio {
 
 			unsigned long pinkCount_;
 
+			Xoshiro128 random_;
+
 			unsigned long
 			countTrailingZeros(unsigned long n);
 
@@ -39,6 +49,11 @@ namespace NAudio {
 
 		public:
 			PinkNoise_();
+
+			void
+			setSeed(unsigned long long seed) {
+				random_.seed(seed);
+			}
 		};
 
 		inline void
@@ -50,14 +65,17 @@ namespace NAudio {
 
 			float* outptr = &outputFrames_[0];
 
-			for(unsigned int i = 0; i < kSynthesisBlockSize; ++i) {
+			//White noise for the whole block first, the pink bins are added to it frame by frame.
+			random_.fill(outptr, outputFrames_.Frames());
+
+			for(unsigned int i = 0; i < outputFrames_.Frames(); ++i) {
 				binidx = countTrailingZeros(pinkCount_);
 				binidx = binidx & (kNumPinkNoiseBins - 1);
 
 				prevbinval = pinkBins_[binidx];
 
 				while(true) {
-					binval = NRNG::GetInstance()->GetSample();
+					binval = random_.getSample();
 
 					pinkBins_[binidx] = binval;
 
@@ -74,19 +92,27 @@ namespace NAudio {
 
 				pinkCount_++;
 
-				*outptr++ = (NRNG::GetInstance()->GetSample() + pinkAccum_) / (kNumPinkNoiseBinsLog2 + 1);
+				*outptr = (*outptr + pinkAccum_) / (kNumPinkNoiseBinsLog2 + 1);
+				++outptr;
 			}
 		}
 
 		inline unsigned long
 		PinkNoise_::countTrailingZeros(unsigned long n) {
-			unsigned long i = 0;
-
-			while(((n >> i) & 1) == 0 && i < sizeof(unsigned long) * 8ul) {
-				i++;
+			//The bit scan is undefined for 0.
+			if(n == 0) {
+				return(sizeof(unsigned long) * 8ul);
 			}
 
+#if defined(_MSC_VER)
+			unsigned long i;
+
+			_BitScanForward(&i, n);
+
 			return(i);
+#else
+			return((unsigned long)__builtin_ctzl(n));
+#endif
 		}
 	}
 
@@ -95,8 +121,22 @@ namespace NAudio {
 		Noise(bool stereo = false) {
 			gen()->setIsStereoOutput(stereo);
 		}
+
+		//Restart the noise from seed. Noise generators with the same seed play the same noise.
+		Noise&
+		seed(unsigned long long seed) {
+			gen()->setSeed(seed);
+			return(*this);
+		}
 	};
 
 	class PinkNoise : public TemplatedGenerator<NAudio_DSP::PinkNoise_> {
+	public:
+		//Restart the noise from seed. Pink noise generators with the same seed play the same noise.
+		PinkNoise&
+		seed(unsigned long long seed) {
+			gen()->setSeed(seed);
+			return(*this);
+		}
 	};
 }
\ No newline at end of file
@@ -0,0 +1,136 @@
+#include "OfflineRenderer.h"
+
+#if NAUDIO_HAS_CPP_11
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "AudioFileUtils.h"
+
+namespace NAudio {
+	//Frames handed to fillBufferOfFloats per call.
+	static const unsigned long kOfflineRenderChunkFrames = 4096;
+
+	OfflineRenderer::OfflineRenderer(unsigned int numThreads) :
+		numThreads_(numThreads), numChannels_(2), keepSamples_(true), lastRenderSeconds_(0.0), lastAudioSeconds_(0.0)
+	{
+		if(numThreads_ == 0) {
+			numThreads_ = Max(1u, std::thread::hardware_concurrency());
+		}
+	}
+
+	void
+	OfflineRenderer::setNumChannels(unsigned int numChannels) {
+		if(numChannels < 1 || numChannels > 2) {
+			LOG(NLOG_ERROR, "OfflineRenderer can only render mono or stereo (1 or 2 channels).");
+			return;
+		}
+
+		numChannels_ = numChannels;
+	}
+
+	void
+	OfflineRenderer::addJob(BufferFiller source, float seconds, std::string name, std::string wavPath) {
+		for(std::vector<Job_>::iterator it = jobs_.begin(); it != jobs_.end(); ++it) {
+			if(it->source == source) {
+				LOG(NLOG_ERROR, "The same BufferFiller was added twice to an OfflineRenderer, ignoring job %s.", name.c_str());
+				return;
+			}
+		}
+
+		Job_ job(source);
+		job.name = name;
+		job.wavPath = wavPath;
+		job.sampleRate = source.getSampleRate();
+		job.numFrames = (unsigned long)(Max(0.0f, seconds) * job.sampleRate);
+
+		jobs_.push_back(job);
+	}
+
+	void
+	OfflineRenderer::addJob(std::string synthName, float seconds, std::string wavPath) {
+		addJob(SynthFactory::createInstance(synthName), seconds, synthName, wavPath);
+	}
+
+	void
+	OfflineRenderer::renderJob(const Job_& job, RenderResult& result) {
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		result.name = job.name;
+		result.numFrames = job.numFrames;
+		result.numChannels = numChannels_;
+		result.sampleRate = job.sampleRate;
+
+		try {
+			BufferFiller source = job.source;
+			std::vector<float> samples(job.numFrames * numChannels_);
+
+			for(unsigned long frame = 0; frame < job.numFrames; frame += kOfflineRenderChunkFrames) {
+				unsigned long n = Min(kOfflineRenderChunkFrames, job.numFrames - frame);
+				source.fillBufferOfFloats(&samples[frame * numChannels_], (unsigned int)n, numChannels_);
+			}
+
+			result.succeeded = true;
+
+			if(!job.wavPath.empty() && !writeWavFile(job.wavPath, samples.empty() ? NULL : &samples[0], job.numFrames, numChannels_, job.sampleRate)) {
+				result.succeeded = false;
+				result.error = "Could not write " + job.wavPath;
+			}
+
+			if(keepSamples_) {
+				result.samples.swap(samples);
+			}
+		}
+		catch(std::exception& e) {
+			result.succeeded = false;
+			result.error = e.what();
+		}
+
+		result.renderSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		if(result.renderSeconds > 0.0) {
+			result.realtimeFactor = ((double)job.numFrames / job.sampleRate) / result.renderSeconds;
+		}
+	}
+
+	std::vector<RenderResult>
+	OfflineRenderer::render() {
+		std::vector<Job_> jobs;
+		jobs.swap(jobs_);
+
+		std::vector<RenderResult> results(jobs.size());
+		std::atomic<size_t> nextJob(0);
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		//Each worker pulls the next job index until none are left, so long and short jobs balance out.
+		std::vector<std::thread> workers;
+		unsigned int numWorkers = (unsigned int)Min((size_t)numThreads_, jobs.size());
+
+		for(unsigned int t = 0; t < numWorkers; ++t) {
+			workers.push_back(std::thread([this, &jobs, &results, &nextJob]() {
+				for(size_t i = nextJob++; i < jobs.size(); i = nextJob++) {
+					renderJob(jobs[i], results[i]);
+				}
+			}));
+		}
+
+		for(size_t t = 0; t < workers.size(); ++t) {
+			workers[t].join();
+		}
+
+		lastRenderSeconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		lastAudioSeconds_ = 0.0;
+
+		for(size_t i = 0; i < jobs.size(); ++i) {
+			lastAudioSeconds_ += (double)jobs[i].numFrames / jobs[i].sampleRate;
+
+			if(!results[i].succeeded) {
+				LOG(NLOG_ERROR, "Offline render of %s failed: %s", results[i].name.c_str(), results[i].error.c_str());
+			}
+		}
+
+		return(results);
+	}
+}
+#endif
\ No newline at end of file
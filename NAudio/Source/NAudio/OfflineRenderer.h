@@ -0,0 +1,98 @@
+#pragma once
+
+#include "Synth.h"
+
+#if NAUDIO_HAS_CPP_11
+namespace NAudio {
+	//Output of one render job.
+	struct RenderResult {
+		std::string name;
+
+		//Interleaved samples. Empty if the renderer was told not to keep samples in memory.
+		std::vector<float> samples;
+		unsigned long numFrames;
+		unsigned int numChannels;
+		float sampleRate;
+
+		//Wall clock time spent rendering, and rendered audio time divided by it.
+		double renderSeconds;
+		double realtimeFactor;
+
+		bool succeeded;
+		std::string error;
+
+		RenderResult() :
+			numFrames(0), numChannels(0), sampleRate(0.0f), renderSeconds(0.0), realtimeFactor(0.0), succeeded(false)
+		{
+		}
+	};
+
+	//Renders Synths, Mixers or any other BufferFiller faster than realtime, to memory and/or WAV files.
+	//Jobs are independent and are spread over a pool of worker threads, one job per thread at a time.
+	//NOTE: JOBS MUST NOT SHARE GENERATORS WITH EACH OTHER OR WITH A RUNNING AUDIO CALLBACK, SINCE EACH JOB IS TICKED ON ITS OWN THREAD.
+	class OfflineRenderer {
+	private:
+		struct Job_ {
+			BufferFiller source;
+			std::string name;
+			std::string wavPath;
+			unsigned long numFrames;
+			float sampleRate;
+
+			Job_(BufferFiller source) :
+				source(source), numFrames(0), sampleRate(0.0f)
+			{
+			}
+		};
+
+		std::vector<Job_> jobs_;
+
+		unsigned int numThreads_;
+		unsigned int numChannels_;
+		bool keepSamples_;
+
+		double lastRenderSeconds_;
+		double lastAudioSeconds_;
+
+		void
+		renderJob(const Job_& job, RenderResult& result);
+
+	public:
+		//numThreads = 0 uses one thread per hardware thread.
+		OfflineRenderer(unsigned int numThreads = 0);
+
+		//Set the number of interleaved output channels (1 or 2). Defaults to 2.
+		void
+		setNumChannels(unsigned int numChannels);
+
+		//If false, rendered samples are only written to the job's WAV file and the result's sample vector is left empty. Defaults to true.
+		void
+		setKeepSamples(bool keepSamples) {
+			keepSamples_ = keepSamples;
+		}
+
+		//Queue a job rendering seconds of audio from source, at the source's sample rate. If wavPath is not empty, the result is also written there.
+		void
+		addJob(BufferFiller source, float seconds, std::string name = "", std::string wavPath = "");
+
+		//Queue a job for a synth registered with NAUDIO_REGISTER_SYNTH. The synth is created now, on the calling thread.
+		void
+		addJob(std::string synthName, float seconds, std::string wavPath = "");
+
+		unsigned long
+		numJobs() {
+			return((unsigned long)jobs_.size());
+		}
+
+		//Render all queued jobs and clear the queue. Blocks until done. Results are in the order jobs were added.
+		std::vector<RenderResult>
+		render();
+
+		//Audio time rendered by the last render() divided by its wall clock time.
+		double
+		getRealtimeFactor() {
+			return((lastRenderSeconds_ > 0.0) ? lastAudioSeconds_ / lastRenderSeconds_ : 0.0);
+		}
+	};
+}
+#endif
\ No newline at end of file
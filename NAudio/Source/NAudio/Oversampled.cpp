@@ -0,0 +1,72 @@
+#include "Oversampled.h"
+
+namespace NAudio {
+	namespace NAudio_DSP {
+		OversampledInput_::OversampledInput_() :
+			source_(NULL), nStages_(0)
+		{
+		}
+
+		void
+		OversampledInput_::initialize(unsigned int nStages) {
+			nStages_ = Min(nStages, kMaxOversamplingStages);
+
+			//The first stage works on the input at the outer rate.
+			for(unsigned int s = 0; s < nStages_; ++s) {
+				upsamplers_[s].initialize((s == 0) ? kOversamplingOuterPairs : kOversamplingInnerPairs, kOversamplingKaiserBeta);
+			}
+		}
+
+		Oversampled_::Oversampled_() :
+			hasSubgraph_(false), factor_(1), nStages_(0)
+		{
+			upsampledInputGen_ = new OversampledInput_();
+			upsampledInput_ = Generator(upsampledInputGen_);
+			subgraph_ = upsampledInput_;
+		}
+
+		void
+		Oversampled_::initialize(unsigned int factor) {
+			if(factor != 1 && factor != 2 && factor != 4 && factor != 8) {
+				LOG(NLOG_ERROR, "Oversampling factor must be 1, 2, 4 or 8, got %u. Using 2.", factor);
+				factor = 2;
+			}
+
+			factor_ = factor;
+			nStages_ = 0;
+
+			while((1u << nStages_) < factor_) {
+				++nStages_;
+			}
+
+			upsampledInputGen_->initialize(nStages_);
+
+			//Stages run from the subgraph's rate down, so the last one produces the outer rate.
+			for(unsigned int s = 0; s < nStages_; ++s) {
+				downsamplers_[s].initialize((s == nStages_ - 1) ? kOversamplingOuterPairs : kOversamplingInnerPairs, kOversamplingKaiserBeta);
+			}
+		}
+
+		void
+		Oversampled_::setInput(Generator input) {
+			Effect_::setInput(input);
+			setIsStereoInput(input.isStereoOutput());
+			upsampledInputGen_->setIsStereoOutput(input.isStereoOutput());
+
+			if(!hasSubgraph_) {
+				setIsStereoOutput(input.isStereoOutput());
+			}
+		}
+
+		void
+		Oversampled_::setSubgraph(Generator subgraph) {
+			subgraph_ = subgraph;
+			hasSubgraph_ = true;
+			setIsStereoOutput(subgraph.isStereoOutput());
+		}
+	}
+
+	Oversampled::Oversampled(unsigned int factor) {
+		gen()->initialize(factor);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,172 @@
+#pragma once
+
+#include "Effect.h"
+#include "FilterUtils.h"
+
+namespace NAudio {
+	//Half-band stages for kMaxOversamplingFactor. Each doubling is one stage.
+	static const unsigned int kMaxOversamplingStages = 3;
+
+	//Half-band filter settings. The stage next to the outer rate has to keep the whole audible band, so it is the long one. Stages further in have a much wider transition band.
+	static const unsigned int kOversamplingOuterPairs = 16;
+	static const unsigned int kOversamplingInnerPairs = 6;
+	static const float kOversamplingKaiserBeta = 8.0f;
+
+	namespace NAudio_DSP {
+		//The input of an Oversampled_ effect, upsampled to the rate of its subgraph. Only valid inside that subgraph.
+		class OversampledInput_ : public Generator_ {
+		protected:
+			//Input block at the outer rate. Set by the owning Oversampled_ before it ticks the subgraph.
+			const NAudioFrames* source_;
+
+			unsigned int nStages_;
+			HalfBandUpsampler upsamplers_[kMaxOversamplingStages];
+
+			//Output of every stage but the last, which writes straight into outputFrames_.
+			NAudioFrames stageFrames_[kMaxOversamplingStages - 1];
+
+			void
+			computeSynthesisBlock(const SynthesisContext_& context);
+
+		public:
+			OversampledInput_();
+
+			void
+			initialize(unsigned int nStages);
+
+			void
+			setSource(const NAudioFrames* source) {
+				source_ = source;
+			}
+		};
+
+		inline void
+		OversampledInput_::computeSynthesisBlock(const SynthesisContext_&) {
+			if(source_ == NULL) {
+				return;
+			}
+
+			//At factor 1 the subgraph runs at the outer rate and gets the input as it is.
+			if(nStages_ == 0) {
+				outputFrames_.Copy(*source_);
+				return;
+			}
+
+			const NAudioFrames* stageIn = source_;
+
+			for(unsigned int s = 0; s < nStages_; ++s) {
+				NAudioFrames& stageOut = (s == nStages_ - 1) ? outputFrames_ : stageFrames_[s];
+
+				if(&stageOut != &outputFrames_) {
+					stageOut.Resize(stageIn->Frames() * 2, stageIn->Channels());
+				}
+
+				upsamplers_[s].process(*stageIn, stageOut);
+
+				stageIn = &stageOut;
+			}
+		}
+
+		//Runs a subgraph at a multiple of the graph's rate and brings its output back down, so only that subgraph pays for oversampling.
+		class Oversampled_ : public Effect_ {
+		protected:
+			//Defaults to the upsampled input itself, which only resamples.
+			Generator subgraph_;
+			bool hasSubgraph_;
+
+			//Upsampled input handed to the subgraph. Kept as a smart pointer so it stays alive as long as the effect.
+			Generator upsampledInput_;
+			OversampledInput_* upsampledInputGen_;
+
+			unsigned int factor_;
+			unsigned int nStages_;
+
+			HalfBandDownsampler downsamplers_[kMaxOversamplingStages];
+
+			//Output of every downsampling stage but the last, which writes straight into outputFrames_.
+			NAudioFrames stageFrames_[kMaxOversamplingStages - 1];
+
+			void
+			computeSynthesisBlock(const SynthesisContext_& context);
+
+		public:
+			Oversampled_();
+
+			void
+			initialize(unsigned int factor);
+
+			//Overridden so the upsampled input has the input's channel layout. The output follows the subgraph's layout.
+			void
+			setInput(Generator input);
+
+			void
+			setSubgraph(Generator subgraph);
+
+			Generator
+			getUpsampledInput() {
+				return(upsampledInput_);
+			}
+		};
+
+		inline void
+		Oversampled_::computeSynthesisBlock(const SynthesisContext_& context) {
+			//The subgraph runs on the same frame clock as the outer graph, so control generators shared with it are only computed once per block.
+			//It is not recorded into the outer graph's schedule, its blocks have a different size.
+			SynthesisContext_ innerContext = context;
+
+			innerContext.blockSize = (unsigned int)outputFrames_.Frames() * factor_;
+			innerContext.sampleRate = context.sampleRate * (float)factor_;
+			innerContext.recorder = NULL;
+
+			upsampledInputGen_->setSource(&dryFrames_);
+
+			const NAudioFrames& innerFrames = subgraph_.tickView(innerContext);
+
+			if(nStages_ == 0) {
+				outputFrames_.Copy(innerFrames);
+				return;
+			}
+
+			//Stages run from the subgraph's rate back down to the outer rate.
+			const NAudioFrames* stageIn = &innerFrames;
+
+			for(unsigned int s = 0; s < nStages_; ++s) {
+				NAudioFrames& stageOut = (s == nStages_ - 1) ? outputFrames_ : stageFrames_[s];
+
+				if(&stageOut != &outputFrames_) {
+					stageOut.Resize(stageIn->Frames() / 2, stageIn->Channels());
+				}
+
+				downsamplers_[s].process(*stageIn, stageOut);
+
+				stageIn = &stageOut;
+			}
+		}
+	}
+
+	//Runs a subgraph at 2x, 4x or 8x the graph's sample rate inside its own synthesis context, then filters and downsamples the result.
+	//Use it around nonlinear or hard-edged generators (clippers, BitCrusher, RectWave, SawtoothWave...) that alias at the normal rate.
+	//Build the subgraph from upsampledInput(), which is this effect's input at the oversampled rate, or from sources of its own:
+	//	Oversampled os = Oversampled(4).input(signal);
+	//	os.subgraph(BitCrusher().input(os.upsampledInput()).bitDepth(4));
+	//Resampling uses polyphase half-band FIR stages, which add a few samples of latency.
+	//NOTE: GENERATORS INSIDE THE SUBGRAPH MUST NOT ALSO BE USED OUTSIDE IT, THEIR BLOCKS ARE A DIFFERENT SIZE. CONTROL GENERATORS CAN BE SHARED.
+	//Set the input before building the subgraph from upsampledInput(), effects read their input's channel layout when it's set.
+	//Sample-accurate control events reach the subgraph at the same frame offset as in the outer graph, which is earlier in time by the oversampling factor.
+	class Oversampled : public TemplatedEffect<Oversampled, NAudio_DSP::Oversampled_> {
+	public:
+		Oversampled(unsigned int factor = 2);
+
+		//This effect's input, upsampled. Only valid inside the subgraph.
+		Generator
+		upsampledInput() {
+			return(gen()->getUpsampledInput());
+		}
+
+		Oversampled&
+		subgraph(Generator subgraph) {
+			gen()->setSubgraph(subgraph);
+			return(*this);
+		}
+	};
+}
\ No newline at end of file
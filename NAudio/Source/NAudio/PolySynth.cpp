@@ -0,0 +1,238 @@
+#include "PolySynth.h"
+
+namespace NAudio {
+	namespace NAudio_DSP {
+		PolySynth_::PolySynth_() :
+			stealMode_(PolyStealOldest), startCounter_(0), noteQueue_(kPolyNoteQueueCapacity), activeVoiceCount_(0)
+		{
+			deferredNotes_.reserve(kPolyNoteQueueCapacity);
+		}
+
+		void
+		PolySynth_::initialize(PolyVoiceFactory factory, unsigned int numVoices) {
+			std::vector<PolyVoice_> voices;
+
+			for(unsigned int i = 0; i < numVoices; ++i) {
+				PolyVoice_ voice;
+				voice.synth = factory(voice.envelope);
+				voice.note = -1;
+				voice.startOrder = 0;
+				voice.startFrame = 0;
+				voice.gateOn = false;
+				voice.active = false;
+
+				std::vector<ControlParameter> parameters = voice.synth.getParameters();
+				bool hasNote = false;
+				bool hasGate = false;
+
+				for(std::vector<ControlParameter>::iterator it = parameters.begin(); it != parameters.end(); ++it) {
+					if(it->getName() == "polyNote") {
+						voice.noteParam = *it;
+						hasNote = true;
+					}
+					else if(it->getName() == "polyGate") {
+						voice.gateParam = *it;
+						hasGate = true;
+					}
+				}
+
+				if(!hasNote || !hasGate) {
+					LOG(NLOG_ERROR, "PolySynth voices must have \"polyNote\" and \"polyGate\" parameters, voice %u does not.", i);
+					return;
+				}
+
+				voices.push_back(voice);
+			}
+
+			voices_.swap(voices);
+			activeVoiceCount_.store(0, std::memory_order_relaxed);
+		}
+
+		bool
+		PolySynth_::noteOn(int note, float velocity, unsigned int sampleOffset) {
+			PolyNoteCommand_ command = { note, velocity, sampleOffset };
+
+			if(!noteQueue_.push(command)) {
+				LOG(NLOG_WARN, "Note queue is full, note %d was dropped.", note);
+				return(false);
+			}
+
+			return(true);
+		}
+
+		bool
+		PolySynth_::noteOff(int note, unsigned int sampleOffset) {
+			return(noteOn(note, 0.0f, sampleOffset));
+		}
+
+		void
+		PolySynth_::setParameter(std::string name, float value, bool normalized) {
+			for(std::vector<PolyVoice_>::iterator it = voices_.begin(); it != voices_.end(); ++it) {
+				it->synth.setParameter(name, value, normalized);
+			}
+		}
+
+		void
+		PolySynth_::processCommands(const SynthesisContext_& context) {
+			//Idle voices are not rendered, so their parameter changes are applied here. Otherwise their queues fill up and a retriggered voice plays stale values.
+			for(std::vector<PolyVoice_>::iterator it = voices_.begin(); it != voices_.end(); ++it) {
+				it->synth.pollCommands(context);
+			}
+
+			const unsigned long blockEnd = context.elapsedFrames + context.blockSize;
+
+			//Notes deferred from earlier blocks go first, so a note on and its note off keep their order.
+			size_t kept = 0;
+
+			for(size_t i = 0; i < deferredNotes_.size(); ++i) {
+				if(deferredNotes_[i].frame < blockEnd) {
+					applyNote(deferredNotes_[i], context);
+				}
+				else {
+					deferredNotes_[kept++] = deferredNotes_[i];
+				}
+			}
+
+			deferredNotes_.resize(kept);
+
+			PolyNoteCommand_ command;
+
+			while(noteQueue_.pop(command)) {
+				command.frame += context.elapsedFrames;
+
+				if(command.frame < blockEnd) {
+					applyNote(command, context);
+				}
+				else if(deferredNotes_.size() < deferredNotes_.capacity()) {
+					deferredNotes_.push_back(command);
+				}
+				else {
+					//Never allocate on the audio thread, apply early instead.
+					LOG(NLOG_WARN, "Too many deferred notes, playing note %d early.", command.note);
+					applyNote(command, context);
+				}
+			}
+		}
+
+		void
+		PolySynth_::applyNote(const PolyNoteCommand_& command, const SynthesisContext_& context) {
+			//Notes that are late, or applied early because too many are deferred, start with the block.
+			const bool inBlock = command.frame > context.elapsedFrames && command.frame < context.elapsedFrames + context.blockSize;
+			const unsigned long frame = inBlock ? command.frame : context.elapsedFrames;
+
+			//MIDI convention, a note on with no velocity is a note off.
+			if(command.velocity > 0.0f) {
+				startNote(command.note, command.velocity, frame, context);
+			}
+			else {
+				stopNote(command.note, frame, context);
+			}
+		}
+
+		void
+		PolySynth_::startNote(int note, float velocity, unsigned long frame, const SynthesisContext_& context) {
+			if(voices_.empty()) {
+				return;
+			}
+
+			PolyVoice_& voice = allocateVoice(note);
+			const unsigned int offset = (unsigned int)(frame - context.elapsedFrames);
+
+			voice.noteParam.value((float)note, offset);
+			voice.gateParam.value(velocity, offset);
+
+			voice.note = note;
+			voice.startOrder = ++startCounter_;
+			voice.startFrame = frame;
+			voice.gateOn = true;
+			voice.active = true;
+		}
+
+		void
+		PolySynth_::stopNote(int note, unsigned long frame, const SynthesisContext_& context) {
+			//Release the oldest voice holding the note, so repeated presses of one note are released in order.
+			PolyVoice_* held = NULL;
+
+			for(std::vector<PolyVoice_>::iterator it = voices_.begin(); it != voices_.end(); ++it) {
+				if(it->gateOn && it->note == note && (held == NULL || it->startOrder < held->startOrder)) {
+					held = &(*it);
+				}
+			}
+
+			if(held == NULL) {
+				return;
+			}
+
+			//A note off on the frame its note started would replace the note on in the gate's changes, so the envelope would never start. Release one frame later instead.
+			if(frame <= held->startFrame) {
+				frame = held->startFrame + 1;
+
+				//Past this block, release in the next one. The voice stays held until then.
+				if(frame >= context.elapsedFrames + context.blockSize) {
+					PolyNoteCommand_ command = { note, 0.0f, frame };
+
+					if(deferredNotes_.size() < deferredNotes_.capacity()) {
+						deferredNotes_.push_back(command);
+						return;
+					}
+
+					//Never allocate on the audio thread, the note is not played.
+					frame = held->startFrame;
+				}
+			}
+
+			held->gateParam.value(0.0f, (unsigned int)(frame - context.elapsedFrames));
+			held->gateOn = false;
+		}
+
+		PolyVoice_&
+		PolySynth_::allocateVoice(int note) {
+			if(stealMode_ == PolyStealSameNote) {
+				for(std::vector<PolyVoice_>::iterator it = voices_.begin(); it != voices_.end(); ++it) {
+					if(it->active && it->note == note) {
+						return(*it);
+					}
+				}
+			}
+
+			for(std::vector<PolyVoice_>::iterator it = voices_.begin(); it != voices_.end(); ++it) {
+				if(!it->active) {
+					return(*it);
+				}
+			}
+
+			PolyVoice_* voice = findStealCandidate(false);
+
+			if(voice == NULL) {
+				voice = findStealCandidate(true);
+			}
+
+			return(*voice);
+		}
+
+		PolyVoice_*
+		PolySynth_::findStealCandidate(bool gateOn) {
+			PolyVoice_* candidate = NULL;
+
+			for(std::vector<PolyVoice_>::iterator it = voices_.begin(); it != voices_.end(); ++it) {
+				if(it->gateOn != gateOn) {
+					continue;
+				}
+
+				if(candidate == NULL) {
+					candidate = &(*it);
+				}
+				else if(stealMode_ == PolyStealQuietest) {
+					if(it->envelope.getLevel() < candidate->envelope.getLevel()) {
+						candidate = &(*it);
+					}
+				}
+				else if(it->startOrder < candidate->startOrder) {
+					candidate = &(*it);
+				}
+			}
+
+			return(candidate);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,209 @@
+#pragma once
+
+#include "Synth.h"
+#include "ADSR.h"
+
+#include <atomic>
+
+namespace NAudio {
+	//How a PolySynth picks the voice to take over when a note starts and every voice is sounding.
+	//Voices that are already releasing are always stolen before held ones.
+	typedef enum {
+		PolyStealOldest = 0,
+		PolyStealQuietest,
+		PolyStealSameNote
+	} PolyStealMode;
+
+	//Number of note events that can be waiting for the audio thread at once.
+	static const unsigned int kPolyNoteQueueCapacity = 1024;
+
+	//Builds one voice of a PolySynth. Must return a Synth with "polyNote" and "polyGate" parameters and set envelope to the voice's amplitude envelope.
+	typedef Synth (*PolyVoiceFactory)(ADSR& envelope);
+
+	namespace NAudio_DSP {
+		//Note event queued from a control thread. A velocity of 0 is a note off.
+		struct PolyNoteCommand_ {
+			int note;
+			float velocity;
+
+			//Offset in frames from the start of the block the command is picked up in. Absolute frame once picked up by the audio thread.
+			unsigned long frame;
+		};
+
+		//One voice of the pool. Only touched by the audio thread once the pool is built.
+		struct PolyVoice_ {
+			Synth synth;
+			ADSR envelope;
+
+			ControlParameter noteParam;
+			ControlParameter gateParam;
+
+			int note;
+
+			//Order the voice was last started in, for oldest-first stealing.
+			unsigned long startOrder;
+
+			//Absolute frame the voice was last started on.
+			unsigned long startFrame;
+
+			//Note is held down.
+			bool gateOn;
+
+			//Envelope may still be producing output. Inactive voices are not rendered.
+			bool active;
+		};
+
+		class PolySynth_ : public BufferFiller_ {
+		private:
+			std::vector<PolyVoice_> voices_;
+
+			PolyStealMode stealMode_;
+			unsigned long startCounter_;
+
+			//Written by one control thread, drained by the audio thread in processCommands().
+			SPSCQueue<PolyNoteCommand_> noteQueue_;
+
+			//Commands whose frame is past the current block. Only touched by the audio thread.
+			std::vector<PolyNoteCommand_> deferredNotes_;
+
+			//Published by the audio thread after every block.
+			std::atomic<unsigned int> activeVoiceCount_;
+
+			void
+			computeSynthesisBlock(const SynthesisContext_& context);
+
+			void
+			processCommands(const SynthesisContext_& context);
+
+			void
+			applyNote(const PolyNoteCommand_& command, const SynthesisContext_& context);
+
+			//frame is absolute and falls within the block of context.
+			void
+			startNote(int note, float velocity, unsigned long frame, const SynthesisContext_& context);
+
+			void
+			stopNote(int note, unsigned long frame, const SynthesisContext_& context);
+
+			//Voice a new note should go to. Never fails once the pool is built.
+			PolyVoice_&
+			allocateVoice(int note);
+
+			//Pick the voice to steal among voices whose gate matches gateOn. Returns NULL if there is none.
+			PolyVoice_*
+			findStealCandidate(bool gateOn);
+
+		public:
+			PolySynth_();
+
+			void
+			initialize(PolyVoiceFactory factory, unsigned int numVoices);
+
+			void
+			setStealMode(PolyStealMode mode) {
+				stealMode_ = mode;
+			}
+
+			bool
+			noteOn(int note, float velocity, unsigned int sampleOffset);
+
+			bool
+			noteOff(int note, unsigned int sampleOffset);
+
+			void
+			setParameter(std::string name, float value, bool normalized);
+
+			unsigned int
+			getNumVoices() const {
+				return((unsigned int)voices_.size());
+			}
+
+			unsigned int
+			getActiveVoiceCount() const {
+				return(activeVoiceCount_.load(std::memory_order_relaxed));
+			}
+		};
+
+		inline void
+		PolySynth_::computeSynthesisBlock(const SynthesisContext_& context) {
+			outputFrames_.Clear();
+
+			unsigned int activeCount = 0;
+			bool silent = true;
+
+			for(std::vector<PolyVoice_>::iterator it = voices_.begin(); it != voices_.end(); ++it) {
+				if(!it->active) {
+					continue;
+				}
+
+				const NAudioFrames& frames = it->synth.tickView(context);
+
+				if(!it->synth.isSilent()) {
+					outputFrames_ += frames;
+					silent = false;
+				}
+
+				//The voice is rendered until its envelope has run out, not just until note off.
+				if(it->envelope.isIdle()) {
+					it->active = false;
+					it->gateOn = false;
+				}
+				else {
+					++activeCount;
+				}
+			}
+
+			outputIsSilent_ = silent;
+			activeVoiceCount_.store(activeCount, std::memory_order_relaxed);
+		}
+	}
+
+	//Polyphonic synth. Plays notes on a pool of voices built up front from a prototype, so no graph is created while notes are playing.
+	//Voices whose envelope is idle are not rendered at all, their graphs do not advance until they get a note again.
+	class PolySynth : public TemplatedBufferFiller<NAudio_DSP::PolySynth_> {
+	public:
+		//Build numVoices voices by calling factory once per voice. Replaces any existing voices.
+		//NOTE: CALL BEFORE THE SYNTH IS RENDERED, THE POOL IS NOT SWAPPED SAFELY WHILE THE AUDIO THREAD RUNS.
+		void
+		initialize(PolyVoiceFactory factory, unsigned int numVoices) {
+			gen()->initialize(factory, numVoices);
+		}
+
+		//Voice to take over when every voice is sounding. Defaults to PolyStealOldest.
+		//PolyStealSameNote also restarts the voice already playing a note when that note starts again, instead of using a second voice.
+		void
+		setStealMode(PolyStealMode mode) {
+			gen()->setStealMode(mode);
+		}
+
+		//Start a note sampleOffset frames after the start of the next block. "polyNote" is set to note and "polyGate" to velocity.
+		//Lock-free, only one thread may send notes at a time. Returns false if the queue is full and the note was dropped.
+		bool
+		noteOn(int note, float velocity = 1.0f, unsigned int sampleOffset = 0) {
+			return(gen()->noteOn(note, velocity, sampleOffset));
+		}
+
+		//Release a note, "polyGate" is set to 0 on the voice holding it. Same rules as noteOn.
+		bool
+		noteOff(int note, unsigned int sampleOffset = 0) {
+			return(gen()->noteOff(note, sampleOffset));
+		}
+
+		//Set a parameter on every voice. The change is queued on each voice and applied the next time the voice is rendered.
+		void
+		setParameter(std::string name, float value = 1.0f, bool normalized = false) {
+			gen()->setParameter(name, value, normalized);
+		}
+
+		unsigned int
+		getNumVoices() {
+			return(gen()->getNumVoices());
+		}
+
+		//Number of voices rendered in the last block. Can be called from any thread.
+		unsigned int
+		getActiveVoiceCount() {
+			return(gen()->getActiveVoiceCount());
+		}
+	};
+}
\ No newline at end of file
@@ -23,6 +23,10 @@ namespace NAudio {
 			void
 			computeSynthesisBlock(const SynthesisContext_& context);
 
+			//Render nFrames of the current ramp starting at fdata, with stride floats between frames.
+			void
+			renderFrames(float* fdata, unsigned int nFrames, unsigned int stride);
+
 		public:
 			RampedValue_();
 			~RampedValue_();
@@ -49,26 +53,74 @@ namespace NAudio {
 
 		inline void
 		RampedValue_::computeSynthesisBlock(const SynthesisContext_& context) {
-			//First set the value, if necessary (abort ramp, go immediately to value).
 			ControlGeneratorOutput valueOutput = valueGen_.tick(context);
-
-			if(valueOutput.triggered) {
-				updateValue(valueOutput.value);
-			}
-
-			//Then update the target or ramp length (start a new ramp).
 			ControlGeneratorOutput lengthOutput = lengthGen_.tick(context);
 			ControlGeneratorOutput targetOutput = targetGen_.tick(context);
 
+			unsigned int nFrames = outputFrames_.Frames();
+			unsigned int stride = outputFrames_.Channels();
+			unsigned int frame = 0;
+
+			float* fdata = &outputFrames_[0];
+
+			//A finished ramp holds its last value until an event starts a new one.
+			bool startsFinished = (finished_ || count_ == len_);
+
+			//Events are applied on the frame they fall on: the block is rendered up to the event, then the state changes.
+			//First set the value, if necessary (abort ramp, go immediately to value).
+			for(unsigned int i = 0; i < valueOutput.numEvents(); ++i) {
+				ControlEvent change = valueOutput.event(i);
+				unsigned int eventFrame = Clamp(change.offset, frame, nFrames);
+
+				renderFrames(fdata + frame * stride, eventFrame - frame, stride);
+				frame = eventFrame;
+
+				updateValue(change.value);
+			}
+
+			//Then update the target or ramp length (start a new ramp). Each change of target starts a ramp from wherever the last one got to.
 			if(lengthOutput.triggered || targetOutput.triggered) {
-				unsigned long lSamp = (unsigned long)(lengthOutput.value * NAudio::SampleRate());
-				updateTarget(targetOutput.value, lSamp);
+				unsigned long lSamp = (unsigned long)(lengthOutput.value * context.sampleRate);
+				unsigned int nTargets = targetOutput.numEvents();
+
+				if(nTargets == 0) {
+					unsigned int eventFrame = Clamp(lengthOutput.offset, frame, nFrames);
+
+					renderFrames(fdata + frame * stride, eventFrame - frame, stride);
+					frame = eventFrame;
+
+					updateTarget(targetOutput.value, lSamp);
+				}
+
+				for(unsigned int i = 0; i < nTargets; ++i) {
+					ControlEvent change = targetOutput.event(i);
+					unsigned int eventOffset = (lengthOutput.triggered && i == nTargets - 1) ? Max(change.offset, lengthOutput.offset) : change.offset;
+					unsigned int eventFrame = Clamp(eventOffset, frame, nFrames);
+
+					renderFrames(fdata + frame * stride, eventFrame - frame, stride);
+					frame = eventFrame;
+
+					updateTarget(change.value, lSamp);
+				}
 			}
 
-			float* fdata = &outputFrames_[0];
+			renderFrames(fdata + frame * stride, nFrames - frame, stride);
 
-			unsigned int nFrames = kSynthesisBlockSize;
-			unsigned int stride = outputFrames_.Channels();
+			if(outputFrames_(nFrames - 1, 0u) != outputFrames_(nFrames - 1, 0u)) {
+				LOG(NLOG_ERROR, "NaN detected.");
+			}
+
+			//Mono source, so need to fill out channels if necessary.
+			outputFrames_.FillChannels();
+
+			outputIsConstant_ = (startsFinished && !valueOutput.triggered && !lengthOutput.triggered && !targetOutput.triggered);
+		}
+
+		inline void
+		RampedValue_::renderFrames(float* fdata, unsigned int nFrames, unsigned int stride) {
+			if(nFrames == 0) {
+				return;
+			}
 
 			//Edge case.
 			if(count_ == len_) {
@@ -112,16 +164,8 @@ namespace NAudio {
 					}
 
 					count_ += nFrames;
-					last_ = outputFrames_(nFrames - 1, 0u);
 				}
 			}
-
-			if(*fdata != *fdata) {
-				LOG(NLOG_ERROR, "NaN detected.");
-			}
-
-			//Mono source, so need to fill out channels if necessary.
-			outputFrames_.FillChannels();
 		}
 
 		//Generator setters.
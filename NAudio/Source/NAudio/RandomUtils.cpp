@@ -0,0 +1,112 @@
+#include "RandomUtils.h"
+#include "NAudioSIMD.h"
+
+#include <ctime>
+
+namespace NAudio {
+	//Next output of SplitMix64, which spreads any 64-bit seed over all state bits.
+	static unsigned long long
+	splitMix64(unsigned long long& x) {
+		x += 0x9E3779B97F4A7C15ull;
+
+		unsigned long long z = x;
+
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+
+		return(z ^ (z >> 31));
+	}
+
+	//Seeds are the base seed mixed with a count of the seeds handed out.
+	struct RandomSeedSource_ {
+		NAUDIO_MUTEX_T mutex;
+
+		unsigned long long base;
+		unsigned long long count;
+
+		RandomSeedSource_() :
+			count(0)
+		{
+			NAUDIO_MUTEX_INIT(mutex);
+
+			base = unpredictableBase();
+		}
+
+		~RandomSeedSource_() {
+			NAUDIO_MUTEX_DESTROY(mutex);
+		}
+
+		unsigned long long
+		unpredictableBase() {
+			unsigned long long x = (unsigned long long)time(NULL) ^ ((unsigned long long)clock() << 32) ^ (unsigned long long)(size_t)this ^ count;
+
+			return(splitMix64(x));
+		}
+	};
+
+	static RandomSeedSource_&
+	randomSeedSource() {
+		static RandomSeedSource_ source;
+
+		return(source);
+	}
+
+	void
+	setRandomSeed(unsigned long long seed) {
+		RandomSeedSource_& source = randomSeedSource();
+
+		NAUDIO_MUTEX_LOCK(source.mutex);
+
+		source.base = seed;
+		source.count = 0;
+
+		NAUDIO_MUTEX_UNLOCK(source.mutex);
+	}
+
+	void
+	clearRandomSeed() {
+		RandomSeedSource_& source = randomSeedSource();
+
+		NAUDIO_MUTEX_LOCK(source.mutex);
+
+		source.base = source.unpredictableBase();
+
+		NAUDIO_MUTEX_UNLOCK(source.mutex);
+	}
+
+	unsigned long long
+	nextRandomSeed() {
+		RandomSeedSource_& source = randomSeedSource();
+
+		NAUDIO_MUTEX_LOCK(source.mutex);
+
+		unsigned long long x = source.base + source.count++;
+
+		NAUDIO_MUTEX_UNLOCK(source.mutex);
+
+		return(splitMix64(x));
+	}
+
+	Xoshiro128::Xoshiro128() {
+		seed(nextRandomSeed());
+	}
+
+	Xoshiro128::Xoshiro128(unsigned long long seed) {
+		this->seed(seed);
+	}
+
+	void
+	Xoshiro128::seed(unsigned long long seed) {
+		for(unsigned int i = 0; i < 16; i += 2) {
+			const unsigned long long bits = splitMix64(seed);
+
+			state_[i] = (unsigned int)bits;
+			state_[i + 1] = (unsigned int)(bits >> 32);
+		}
+	}
+
+	void
+	Xoshiro128::fill(float* dst, size_t n) {
+		NAudio_DSP::SIMD().noiseFill(dst, state_, n);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "NAudioCore.h"
+
+namespace NAudio {
+	//Seed every random source created from now on from seed, in the order they are created. A graph built the same way then gets the same noise on every run and render thread, at any SIMD level.
+	void
+	setRandomSeed(unsigned long long seed);
+
+	//Seed random sources created from now on unpredictably. The default.
+	void
+	clearRandomSeed();
+
+	//Seed for a new random source. Follows setRandomSeed() if it was called, unpredictable otherwise.
+	unsigned long long
+	nextRandomSeed();
+
+	//Pseudo random numbers from xoshiro128+ in 4 independent lanes. Every generator owns one, so nothing is shared between render threads.
+	//fill() runs the lanes side by side through the noiseFill kernel, single draws step lane 0.
+	class Xoshiro128 {
+	private:
+		//Words s0 to s3 of the 4 lanes, planar.
+		unsigned int state_[16];
+
+	public:
+		//Seeded from nextRandomSeed().
+		Xoshiro128();
+
+		Xoshiro128(unsigned long long seed);
+
+		//Restart the sequence. The same seed gives the same numbers.
+		void
+		seed(unsigned long long seed);
+
+		//Next 32 random bits.
+		unsigned int
+		next() {
+			return(xoshiro128Next(state_, 4));
+		}
+
+		//Uniform in [-1, 1).
+		float
+		getSample() {
+			return(randomWordToSample(next()));
+		}
+
+		//Uniform in [min, max).
+		float
+		getFloat(float min, float max) {
+			return(min + (max - min) * ((float)(next() >> 8) * (1.0f / 16777216.0f)));
+		}
+
+		//Fill n samples with white noise in [-1, 1).
+		void
+		fill(float* dst, size_t n);
+	};
+}
\ No newline at end of file
@@ -37,25 +37,20 @@ namespace NAudio {
 
 		inline void
 		RectWave_::computeSynthesisBlock(const SynthesisContext_& context) {
-			//Tick freq and pwm.
-			freqGen_.tick(freqFrames_, context);
-			pwmGen_.tick(pwmFrames_, context);
+			const float rateConstant = NAUDIO_RECT_RES / context.sampleRate;
 
-			const float rateConstant = NAUDIO_RECT_RES / NAudio::SampleRate();
+			//Tick freq and pwm. Freq is pre-multiplied by the rate constant for speed. Fixed inputs are read from a single value.
+			float constantRate;
+			unsigned int freqStride;
+			unsigned int pwmStride;
+
+			const float* freqptr = freqGen_.tickScaledSamples(freqFrames_, rateConstant, constantRate, context, freqStride);
+			const float* pwmptr = pwmGen_.tickSamples(pwmFrames_, context, pwmStride);
 
 			float* outptr = &outputFrames_[0];
-			float* freqptr = &freqFrames_[0];
-			float* pwmptr = &pwmFrames_[0];
 
 			FastPhasor sd;
 
-			//Pre-multiply rate constant for speed.
-			for(unsigned int i = 0; i < kSynthesisBlockSize; ++i) {
-				*freqptr++ *= rateConstant;
-			}
-
-			freqptr = &freqFrames_[0];
-
 			sd.d = BIT32DECPT;
 
 			int offs;
@@ -64,11 +59,14 @@ namespace NAudio {
 
 			for(unsigned int i = 0; i < outputFrames_.Frames(); ++i) {
 				sd.d = ps;
-				ps += *freqptr++;
+				ps += *freqptr;
 				offs = sd.i[1] & (NAUDIO_RECT_RES - 1);
 				sd.i[1] = msbi;
 
-				*outptr++ = offs > (NAUDIO_RECT_RES * *pwmptr++) ? -1.0f : 1.0f;
+				*outptr++ = offs > (NAUDIO_RECT_RES * *pwmptr) ? -1.0f : 1.0f;
+
+				freqptr += freqStride;
+				pwmptr += pwmStride;
 			}
 
 			sd.d = BIT32DECPT * NAUDIO_RECT_RES;
@@ -100,25 +98,20 @@ namespace NAudio {
 
 		inline void
 		RectWaveBL_::computeSynthesisBlock(const NAudio_DSP::SynthesisContext_& context) {
-			static const float rateConstant = 1.0f / NAudio::SampleRate();
+			const float rateConstant = 1.0f / context.sampleRate;
 
-			//Tick freq and pwm.
-			freqGen_.tick(freqFrames_, context);
-			pwmGen_.tick(pwmFrames_, context);
+			//Tick freq and pwm. Freq is pre-multiplied by the rate constant for speed. Fixed inputs are read from a single value.
+			float constantRate;
+			unsigned int freqStride;
+			unsigned int pwmStride;
 
-			float* outptr = &outputFrames_[0];
-			float* freqptr = &freqFrames_[0];
-			float* pwmptr = &pwmFrames_[0];
-
-			//Pre-multiply rate constant for speed.
-			for(unsigned int i = 0; i < kSynthesisBlockSize; ++i) {
-				*freqptr++ *= rateConstant;
-			}
+			const float* freqptr = freqGen_.tickScaledSamples(freqFrames_, rateConstant, constantRate, context, freqStride);
+			const float* pwmptr = pwmGen_.tickSamples(pwmFrames_, context, pwmStride);
 
-			freqptr = &freqFrames_[0];
+			float* outptr = &outputFrames_[0];
 
 			//TODO: Maybe do this using a fast phasor for wraparound speed.
-			for(unsigned int i = 0; i < kSynthesisBlockSize; ++i, ++pwmptr, ++freqptr, ++outptr) {
+			for(unsigned int i = 0; i < outputFrames_.Frames(); ++i, pwmptr += pwmStride, freqptr += freqStride, ++outptr) {
 				phase_ += *freqptr;
 
 				//Add BLEP at end.
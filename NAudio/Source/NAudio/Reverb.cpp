@@ -1,4 +1,5 @@
 #include "Reverb.h"
+#include "NAudioSIMD.h"
 
 #define NAUDIO_REVERB_MIN_TAPS			2
 #define NAUDIO_REVERB_MAX_TAPS			20
@@ -15,6 +16,7 @@
 #define NAUDIO_REVERB_MIN_COMB_TIME		0.015f
 #define NAUDIO_REVERB_MAX_COMB_TIME		0.035f
 #define NAUDIO_REVERB_STEREO_SPREAD		0.001f
+#define NAUDIO_REVERB_MAX_COMB_DELAY	0.125f
 
 //Number of allpass filters per channel.
 #define NAUDIO_REVERB_N_ALLPASS			4
@@ -22,31 +24,167 @@
 
 namespace NAudio {
 	namespace NAudio_DSP {
-		ImpulseDiffuserAllpass::ImpulseDiffuserAllpass(float delay, float coef) {
-			delay_ = delay;
-			coef_ = coef;
-
-			delayBack_.initialize(delay, 1u);
-			delayForward_.initialize(delay, 1u);
-			delayBack_.setInterpolates(false);
-			delayForward_.setInterpolates(false);
+		ImpulseDiffuserAllpass::ImpulseDiffuserAllpass(float delay, float coef) :
+			writeFrame_(0), delayFrames_(0), delay_(delay), coef_(coef), sampleRate_(NAudio::SampleRate())
+		{
+			resize();
 		}
 
-		ImpulseDiffuserAllpass::ImpulseDiffuserAllpass(const ImpulseDiffuserAllpass& other) {
-			delay_ = other.delay_;
-			coef_ = other.coef_;
+		void
+		ImpulseDiffuserAllpass::resize() {
+			const unsigned int nFrames = (unsigned int)Max(2.0f, delay_ * sampleRate_);
+
+			line_.assign(nFrames, 0.0f);
+			writeFrame_ = 0;
+
+			delayFrames_ = reverbDelayFrames(delay_, sampleRate_, nFrames);
+		}
+
+		void
+		ImpulseDiffuserAllpass::tickThrough(NAudioFrames& frames) {
+			const SIMDKernels_& simd = SIMD();
+			const unsigned int nLineFrames = (unsigned int)line_.size();
+			const unsigned int nFrames = frames.Frames();
+
+			float* io = &frames[0];
+			unsigned int done = 0;
+
+			//Frames less than a delay apart don't depend on each other. Segments also stop where the line wraps.
+			while(done < nFrames) {
+				const unsigned int readFrame = (writeFrame_ + nLineFrames - delayFrames_) % nLineFrames;
+				const unsigned int count = Min(Min(nFrames - done, delayFrames_), Min(nLineFrames - writeFrame_, nLineFrames - readFrame));
+
+				simd.allpass(io + done, &line_[writeFrame_], &line_[readFrame], coef_, count);
+
+				writeFrame_ = (writeFrame_ + count) % nLineFrames;
+				done += count;
+			}
+		}
+
+		void
+		ReverbTapLine::process(const float* in, float* out, unsigned int nFrames) {
+			const unsigned int writeAhead = (unsigned int)line_.getWriteAheadFrames();
+			const SIMDKernels_& simd = SIMD();
+
+			//Write a segment, then read every tap over it. Only blocks longer than the line's write-ahead (oversampled subgraphs) take more than one segment.
+			for(unsigned int done = 0, count = 0; done < nFrames; done += count) {
+				count = Min(nFrames - done, writeAhead);
+
+				line_.write(in + done, count);
+
+				simd.fill(out + done, 0.0f, count);
+
+				for(unsigned int t = 0; t < tapTimes_.size(); ++t) {
+					line_.readAdd(out + done, tapTimes_[t], tapScales_[t], count);
+				}
+
+				line_.advance(count);
+			}
+		}
+
+		ReverbCombBank::ReverbCombBank() :
+			nLanes_(0), nLineFrames_(0), writeFrame_(0), maxDelay_(0.0f), sampleRate_(NAudio::SampleRate())
+		{
+		}
+
+		void
+		ReverbCombBank::initialize(unsigned int nLanes, float maxDelay) {
+			nLanes_ = nLanes;
+			maxDelay_ = maxDelay;
+
+			nLineFrames_ = (unsigned int)Max(2.0f, maxDelay_ * sampleRate_);
+			lines_.assign(nLanes_ * nLineFrames_, 0.0f);
+			writeFrame_ = 0;
+
+			delayTimes_.resize(nLanes_, 0.0f);
+			readFrames_.resize(nLanes_, 0);
+			scales_.resize(nLanes_, 0.0f);
+			lows_.assign(nLanes_, 0.0f);
+			highs_.assign(nLanes_, 0.0f);
+
+			for(unsigned int l = 0; l < nLanes_; ++l) {
+				updateReadFrame(l);
+			}
+		}
+
+		void
+		ReverbCombBank::setSampleRate(float sampleRate) {
+			if(sampleRate != sampleRate_) {
+				sampleRate_ = sampleRate;
+
+				//Filter states carry over, like the state of a single comb filter does.
+				nLineFrames_ = (unsigned int)Max(2.0f, maxDelay_ * sampleRate_);
+				lines_.assign(nLanes_ * nLineFrames_, 0.0f);
+				writeFrame_ = 0;
+
+				for(unsigned int l = 0; l < nLanes_; ++l) {
+					updateReadFrame(l);
+				}
+			}
+		}
+
+		void
+		ReverbCombBank::updateReadFrame(unsigned int lane) {
+			readFrames_[lane] = (writeFrame_ + nLineFrames_ - reverbDelayFrames(delayTimes_[lane], sampleRate_, nLineFrames_)) % nLineFrames_;
+		}
+
+		void
+		ReverbCombBank::setLane(unsigned int lane, float delayTime, float scaleFactor) {
+			scales_[lane] = scaleFactor;
+
+			if(delayTime != delayTimes_[lane]) {
+				delayTimes_[lane] = delayTime;
+				updateReadFrame(lane);
+			}
+		}
+
+		void
+		ReverbCombBank::process(const float* in, float* outLeft, float* outRight, unsigned int nFrames, float lowCoef, float highCoef) {
+			const SIMDKernels_& simd = SIMD();
+			const unsigned int nLeftLanes = nLanes_ / 2;
+
+			unsigned int done = 0;
+
+			//Run up to the next point where the write frame or a read frame wraps. Frames less than the shortest delay apart don't depend on each other, so runs stop there too.
+			while(done < nFrames) {
+				unsigned int count = Min(nFrames - done, nLineFrames_ - writeFrame_);
+
+				for(unsigned int l = 0; l < nLanes_; ++l) {
+					const unsigned int delayFrames = nLineFrames_ - (unsigned int)((readFrames_[l] + nLineFrames_ - writeFrame_) % nLineFrames_);
+
+					count = Min(count, Min(delayFrames, nLineFrames_ - (unsigned int)readFrames_[l]));
+				}
+
+				simd.combBank(&lines_[0], nLineFrames_, &readFrames_[0], writeFrame_, &lows_[0], &highs_[0], &scales_[0], lowCoef, highCoef, in + done, count, nLanes_);
+
+				//What was just written is the output of each comb.
+				for(unsigned int l = 0; l < nLanes_; ++l) {
+					simd.add((l < nLeftLanes ? outLeft : outRight) + done, &lines_[l * nLineFrames_ + writeFrame_], count);
 
-			delayBack_.initialize(delay_, 1u);
-			delayForward_.initialize(delay_, 1u);
-			delayBack_.setInterpolates(false);
-			delayForward_.setInterpolates(false);
+					readFrames_[l] += count;
+
+					if(readFrames_[l] == nLineFrames_) {
+						readFrames_[l] = 0;
+					}
+				}
+
+				writeFrame_ += count;
+
+				if(writeFrame_ == nLineFrames_) {
+					writeFrame_ = 0;
+				}
+
+				done += count;
+			}
 		}
 
 		//Changing these will change the character of the late-stage reverb.
 		static const float combTimeScales_[NAUDIO_REVERB_N_COMBS] = { 1.17f, 1.12f, 1.02f, 0.97f, 0.95f, 0.88f, 0.84f, 0.82f };
 		static const float allpassTimes_[NAUDIO_REVERB_N_ALLPASS] = { 0.0051f, 0.010f, 0.012f, 0.00833f };
 
-		Reverb_::Reverb_() {
+		Reverb_::Reverb_() :
+			reflectDensity_(-1.0f), reflectShape_(-1.0f), reflectSize_(-1.0f), inputFilter_(2u), inputFilterSampleRate_(0.0f)
+		{
 			setIsStereoOutput(true);
 
 			//Default to 50% wet.
@@ -58,14 +196,10 @@ namespace NAudio {
 			preOutputFrames_[0].Resize(kSynthesisBlockSize, 1u, 0.0f);
 			preOutputFrames_[1].Resize(kSynthesisBlockSize, 1u, 0.0f);
 
-			preDelayLine_.initialize(0.1f, 1u);
-			reflectDelayLine_.initialize(0.1f, 1u);
-
-			inputLPF_.setIsStereoInput(false);
-			inputLPF_.setIsStereoInput(false);
-
-			inputLPF_.Q(0.707f);
-			inputHPF_.Q(0.707f);
+			preDelayLine_.initialize(0.1f);
+			preDelayLine_.setNumTaps(1u);
+			reflectDelayLine_.initialize(0.1f);
+			combBank_.initialize(2 * NAUDIO_REVERB_N_COMBS, NAUDIO_REVERB_MAX_COMB_DELAY);
 
 			preDelayTimeCtrlGen_ = ControlValue(0.01f);
 			inputFiltBypasCtrlGen_ = ControlValue(false);
@@ -78,19 +212,9 @@ namespace NAudio {
 			setInputLPFCutoffCtrlGen(ControlValue(10000.0f));
 			setInputHPFCutoffCtrlGen(ControlValue(20.0f));
 
-			for(unsigned int i = 0; i < NAUDIO_REVERB_N_COMBS; ++i) {
-				ControlValue delayL = ControlValue(0.01f);
-				ControlValue delayR = ControlValue(0.01f);
-				ControlValue scaleL = ControlValue(0.5f);
-				ControlValue scaleR = ControlValue(0.5f);
-
-				combFilterDelayTimes_[NAUDIO_LEFT].push_back(delayL);
-				combFilterDelayTimes_[NAUDIO_RIGHT].push_back(delayR);
-				combFilterScaleFactors_[NAUDIO_LEFT].push_back(scaleL);
-				combFilterScaleFactors_[NAUDIO_RIGHT].push_back(scaleR);
-
-				combFilters_[NAUDIO_LEFT].push_back(FilteredFBCombFilter6(0.01f, 0.125f).delayTime(delayL).scaleFactor(scaleL));
-				combFilters_[NAUDIO_RIGHT].push_back(FilteredFBCombFilter6(0.01f, 0.125f).delayTime(delayR).scaleFactor(scaleR));
+			//Lanes start at the delay and feedback the comb filters were created with.
+			for(unsigned int i = 0; i < 2 * NAUDIO_REVERB_N_COMBS; ++i) {
+				combBank_.setLane(i, 0.01f, 0.5f);
 			}
 
 			for(unsigned int i = 0; i < NAUDIO_REVERB_N_ALLPASS; ++i) {
@@ -102,6 +226,29 @@ namespace NAudio {
 			setDecayHPFCtrlGen(ControlValue(60.0f));
 		}
 
+		void
+		Reverb_::updateInputFilter(const SynthesisContext_& context) {
+			ControlGeneratorOutput lowPassOutput = inputLPFCutoffCtrlGen_.tick(context);
+			ControlGeneratorOutput highPassOutput = inputHPFCutoffCtrlGen_.tick(context);
+
+			if(!lowPassOutput.triggered && !highPassOutput.triggered && context.sampleRate == inputFilterSampleRate_) {
+				return;
+			}
+
+			inputFilterSampleRate_ = context.sampleRate;
+
+			//Same response as LPF12 into HPF12 at a Q of 0.707.
+			const float invQ = 1.0f / 0.7071f;
+			const float nyquist = context.sampleRate / 2.0f;
+			float newCoef[5];
+
+			bltCoef(0.0f, 0.0f, invQ, invQ, 1.0f, Clamp(lowPassOutput.value, 20.0f, nyquist), newCoef, context.sampleRate);
+			inputFilter_.setCoefficients(0u, newCoef);
+
+			bltCoef(invQ, 0.0f, 0.0f, invQ, 1.0f, Clamp(highPassOutput.value, 20.0f, nyquist), newCoef, context.sampleRate);
+			inputFilter_.setCoefficients(1u, newCoef);
+		}
+
 		void
 		Reverb_::updateDelayTimes(const SynthesisContext_& context) {
 			ControlGeneratorOutput densityOutput = densityCtrlGen_.tick(context);
@@ -109,9 +256,12 @@ namespace NAudio {
 			ControlGeneratorOutput sizeOutput = roomSizeCtrlGen_.tick(context);
 			ControlGeneratorOutput decayOutput = decayTimeCtrlGen_.tick(context);
 
-			if(densityOutput.triggered || shapeOutput.triggered || sizeOutput.triggered) {
-				reflectTapTimes_.clear();
-				reflectTapScale_.clear();
+			const bool reflectionsChanged = densityOutput.value != reflectDensity_ || shapeOutput.value != reflectShape_ || sizeOutput.value != reflectSize_;
+
+			if((densityOutput.triggered || shapeOutput.triggered || sizeOutput.triggered) && reflectionsChanged) {
+				reflectDensity_ = densityOutput.value;
+				reflectShape_ = shapeOutput.value;
+				reflectSize_ = sizeOutput.value;
 
 				//Compute base round-trip times from listener to wall, based on shape and size values.
 				float shape = Clamp(shapeOutput.value, 0.0f, 1.0f);
@@ -124,11 +274,12 @@ namespace NAudio {
 
 				float tapScale = 1.0f / Max(2.0f, sqrtf(nTaps));
 
+				reflectDelayLine_.setNumTaps(nTaps);
+
 				for(unsigned int i = 0; i < nTaps; ++i) {
-					float dist = (i % 2 == 0 ? wDist1 : wDist2) * (1.0f + NRNG::GetInstance()->GetFloat(-NAUDIO_REVERB_FUDGE_AMT, NAUDIO_REVERB_FUDGE_AMT));
+					float dist = (i % 2 == 0 ? wDist1 : wDist2) * (1.0f + random_.getFloat(-NAUDIO_REVERB_FUDGE_AMT, NAUDIO_REVERB_FUDGE_AMT));
 
-					reflectTapTimes_.push_back(dist / NAUDIO_REVERB_SOS);
-					reflectTapScale_.push_back(DBToLin(dist * NAUDIO_REVERB_AIRDECAY)*tapScale);
+					reflectDelayLine_.setTap(i, dist / NAUDIO_REVERB_SOS, DBToLin(dist * NAUDIO_REVERB_AIRDECAY)*tapScale);
 				}
 			}
 
@@ -140,28 +291,10 @@ namespace NAudio {
 				for(unsigned int i = 0; i < NAUDIO_REVERB_N_COMBS; ++i) {
 					float scaledDelayTime = combTimeScales_[i % NAUDIO_REVERB_N_COMBS] * baseCombDelayTime;
 
-					combFilterDelayTimes_[NAUDIO_LEFT][i].value(scaledDelayTime);
-					combFilterDelayTimes_[NAUDIO_RIGHT][i].value(scaledDelayTime + NAUDIO_REVERB_STEREO_SPREAD);
-					combFilterScaleFactors_[NAUDIO_LEFT][i].value(powf(10.0f, (-3.0f * scaledDelayTime / decayTime)));
-					combFilterScaleFactors_[NAUDIO_RIGHT][i].value(powf(10.0f, (-3.0f * (scaledDelayTime + NAUDIO_REVERB_STEREO_SPREAD) / decayTime)));
+					combBank_.setLane(i, scaledDelayTime, powf(10.0f, (-3.0f * scaledDelayTime / decayTime)));
+					combBank_.setLane(NAUDIO_REVERB_N_COMBS + i, scaledDelayTime + NAUDIO_REVERB_STEREO_SPREAD, powf(10.0f, (-3.0f * (scaledDelayTime + NAUDIO_REVERB_STEREO_SPREAD) / decayTime)));
 				}
 			}
 		}
-
-		void
-		Reverb_::setDecayLPFCtrlGen(ControlGenerator gen) {
-			for(unsigned int i = 0; i < NAUDIO_REVERB_N_COMBS; ++i) {
-				combFilters_[NAUDIO_LEFT][i].lowpassCutoff(gen);
-				combFilters_[NAUDIO_RIGHT][i].lowpassCutoff(gen);
-			}
-		}
-
-		void
-		Reverb_::setDecayHPFCtrlGen(ControlGenerator gen) {
-			for(unsigned int i = 0; i < NAUDIO_REVERB_N_COMBS; ++i) {
-				combFilters_[NAUDIO_LEFT][i].highpassCutoff(gen);
-				combFilters_[NAUDIO_RIGHT][i].highpassCutoff(gen);
-			}
-		}
 	}
 }
\ No newline at end of file
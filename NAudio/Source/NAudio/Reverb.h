@@ -2,47 +2,145 @@
 
 #include "Effect.h"
 #include "DelayUtils.h"
-#include "CombFilter.h"
 #include "Filters.h"
 #include "MonoToStereoPanner.h"
-#include "NRNG/NRNG.h"
+#include "RandomUtils.h"
 
 namespace NAudio {
 	namespace NAudio_DSP {
+		//Read head of a line of nFrames frames, delayTime seconds behind a write head at frame 0.
+		inline static float
+		reverbReadHead(float delayTime, float sampleRate, unsigned int nFrames) {
+			const float readHead = (float)nFrames - Clamp(delayTime * sampleRate, 0.0f, (float)nFrames);
+
+			return(readHead >= (float)nFrames ? 0.0f : readHead);
+		}
+
+		//Whole frames a non-interpolating delay line of nFrames frames reads behind its write head for delayTime seconds, between 1 and nFrames.
+		//Fractions round up, through the float read head, so delays a rounding error above a whole frame stay on that frame.
+		//A delay of 0 is the whole line, since the line is read before it is written.
+		inline static unsigned int
+		reverbDelayFrames(float delayTime, float sampleRate, unsigned int nFrames) {
+			return(nFrames - (unsigned int)reverbReadHead(delayTime, sampleRate, nFrames));
+		}
+
 		//Allpass filter for use with reverb. This is not a Generator_ subclass and is optimized for the purposes of the Reverb_ class.
 		class ImpulseDiffuserAllpass {
 		protected:
-			DelayLine delayForward_;
-			DelayLine delayBack_;
+			//Feedback and feed forward stages delay the same signal, so they share one line.
+			std::vector<float> line_;
+			unsigned int writeFrame_;
+			unsigned int delayFrames_;
 
 			float delay_;
 			float coef_;
+			float sampleRate_;
+
+			//Size the line for the current sample rate and clear it.
+			void
+			resize();
 
 		public:
 			ImpulseDiffuserAllpass(float delay, float coef);
-			ImpulseDiffuserAllpass(const ImpulseDiffuserAllpass& other);
 
+			void
+			setSampleRate(float sampleRate) {
+				if(sampleRate != sampleRate_) {
+					sampleRate_ = sampleRate;
+					resize();
+				}
+			}
+
+			//Filter frames in place, one segment of up to a delay at a time.
 			void
 			tickThrough(NAudioFrames& frames);
 		};
 
-		inline void
-		ImpulseDiffuserAllpass::tickThrough(NAudio::NAudioFrames& frames) {
-			float* dptr = &frames[0];
-			float y;
+		//Mono delay line read by any number of fixed, scaled taps. Used for the pre-delay and the early reflections of Reverb_.
+		//Taps interpolate linearly, each one is read over a block at a time with DelayLine::readAdd.
+		class ReverbTapLine {
+		protected:
+			DelayLine line_;
 
-			for(int i = 0; i < kSynthesisBlockSize; ++i) {
-				//Feedback stage.
-				y = *dptr + delayBack_.tickOut(delay_) * coef_;
-				delayBack_.tickIn(y);
-				delayBack_.advance();
+			//Per tap settings.
+			std::vector<float> tapTimes_;
+			std::vector<float> tapScales_;
 
-				//Feed forward stage.
-				*dptr++ = (1.0f + coef_)*delayForward_.tickOut(delay_) - y;
-				delayForward_.tickIn(y);
-				delayForward_.advance();
+		public:
+			void
+			initialize(float maxDelay) {
+				line_.initialize(maxDelay);
 			}
-		}
+
+			//Resize the line for a graph running at sampleRate. Clears the line if the rate changes.
+			void
+			setSampleRate(float sampleRate) {
+				line_.setSampleRate(sampleRate);
+			}
+
+			float
+			getMaxDelay() const {
+				return(line_.getMaxDelay());
+			}
+
+			void
+			setNumTaps(unsigned int nTaps) {
+				tapTimes_.resize(nTaps, 0.0f);
+				tapScales_.resize(nTaps, 0.0f);
+			}
+
+			void
+			setTap(unsigned int tap, float delayTime, float scale) {
+				tapTimes_[tap] = delayTime;
+				tapScales_[tap] = scale;
+			}
+
+			//Write nFrames of input, then set out to the sum of the taps over those same frames. in and out must not overlap.
+			void
+			process(const float* in, float* out, unsigned int nFrames);
+		};
+
+		//Feedback comb filters with one-pole lowpass and highpass damping, stored as a structure of arrays so all of them advance together in vector lanes.
+		//The first half of the lanes is the left channel, the second half the right one. This is not a Generator_ subclass and is optimized for the purposes of the Reverb_ class.
+		class ReverbCombBank {
+		protected:
+			//The line of lane l is lines_[l * nLineFrames_, (l + 1) * nLineFrames_). All lines share the write frame.
+			std::vector<float> lines_;
+			unsigned int nLanes_;
+			unsigned int nLineFrames_;
+			unsigned int writeFrame_;
+
+			float maxDelay_;
+			float sampleRate_;
+
+			//Per lane settings and state.
+			std::vector<float> delayTimes_;
+			std::vector<size_t> readFrames_;
+			std::vector<float> scales_;
+			std::vector<float> lows_;
+			std::vector<float> highs_;
+
+			void
+			updateReadFrame(unsigned int lane);
+
+		public:
+			ReverbCombBank();
+
+			void
+			initialize(unsigned int nLanes, float maxDelay);
+
+			//Resize the lines for a graph running at sampleRate. Clears the lines if the rate changes.
+			void
+			setSampleRate(float sampleRate);
+
+			void
+			setLane(unsigned int lane, float delayTime, float scaleFactor);
+
+			//Run in through every comb and add the left lanes into outLeft and the right lanes into outRight.
+			//highCoef is the one-pole highpass coefficient, 1 - cutoffToOnePoleCoef(cutoff).
+			void
+			process(const float* in, float* outLeft, float* outRight, unsigned int nFrames, float lowCoef, float highCoef);
+		};
 
 		//Moorer-Schroeder style Artificial Reverb effect: Pre-delay; Input filter; Early reflection taps; Decay time and decay filtering; Variable "Room size"; Variable stereo width.
 		//TODO: Reverb fb comb cutoff setting parameters should be normalized value, not Hz. Not a "true" cutoff.
@@ -51,19 +149,27 @@ namespace NAudio {
 		class Reverb_ : public WetDryEffect_ {
 		protected:
 			//Filters and delay lines.
-			DelayLine preDelayLine_;
-			DelayLine reflectDelayLine_;
+			ReverbTapLine preDelayLine_;
+			ReverbTapLine reflectDelayLine_;
 
-			LPF12 inputLPF_;
-			HPF12 inputHPF_;
+			//Scatters the early reflection times.
+			Xoshiro128 random_;
 
-			std::vector<float> reflectTapTimes_;
-			std::vector<float> reflectTapScale_;
+			//Density, shape and size the reflections were last scattered for. A control that triggers again with the same value keeps them, so they don't move at a block boundary.
+			float reflectDensity_;
+			float reflectShape_;
+			float reflectSize_;
 
-			//Comb filters.
-			std::vector<FilteredFBCombFilter6> combFilters_[2];
-			std::vector<ControlValue> combFilterDelayTimes_[2];
-			std::vector<ControlValue> combFilterScaleFactors_[2];
+			//Butterworth 2-pole lowpass, then highpass, on the input. One biquad cascade of 2 stages.
+			BiquadCascade inputFilter_;
+			ControlGenerator inputLPFCutoffCtrlGen_;
+			ControlGenerator inputHPFCutoffCtrlGen_;
+			float inputFilterSampleRate_;
+
+			//Comb filters, NAUDIO_REVERB_N_COMBS per channel.
+			ReverbCombBank combBank_;
+			ControlGenerator combLowCutoffCtrlGen_;
+			ControlGenerator combHighCutoffCtrlGen_;
 
 			//Allpass filters.
 			std::vector<ImpulseDiffuserAllpass> allpassFilters_[2];
@@ -85,6 +191,9 @@ namespace NAudio {
 			void
 			updateDelayTimes(const SynthesisContext_& context);
 
+			void
+			updateInputFilter(const SynthesisContext_& context);
+
 			void
 			computeSynthesisBlock(const SynthesisContext_& context);
 
@@ -103,12 +212,12 @@ namespace NAudio {
 
 			void
 			setInputLPFCutoffCtrlGen(ControlGenerator gen) {
-				inputLPF_.cutoff(gen);
+				inputLPFCutoffCtrlGen_ = gen;
 			}
 
 			void
 			setInputHPFCutoffCtrlGen(ControlGenerator gen) {
-				inputHPF_.cutoff(gen);
+				inputHPFCutoffCtrlGen_ = gen;
 			}
 
 			void
@@ -136,63 +245,65 @@ namespace NAudio {
 				stereoWidthCtrlGen_ = gen;
 			}
 
-			//These are special setters, they will be passed to all the comb filters.
+			//These are special setters, they apply to all the comb filters.
 			void
-			setDecayLPFCtrlGen(ControlGenerator gen);
+			setDecayLPFCtrlGen(ControlGenerator gen) {
+				combLowCutoffCtrlGen_ = gen;
+			}
 
 			void
-			setDecayHPFCtrlGen(ControlGenerator gen);
+			setDecayHPFCtrlGen(ControlGenerator gen) {
+				combHighCutoffCtrlGen_ = gen;
+			}
 		};
 
 		inline void
 		Reverb_::computeSynthesisBlock(const SynthesisContext_& context) {
+			const unsigned int nFrames = outputFrames_.Frames();
+
+			//Follow the block size.
+			workspaceFrames_[0].Resize(nFrames, 1u);
+			workspaceFrames_[1].Resize(nFrames, 1u);
+			preOutputFrames_[NAUDIO_LEFT].Resize(nFrames, 1u);
+			preOutputFrames_[NAUDIO_RIGHT].Resize(nFrames, 1u);
+
+			//Follow the sample rate.
+			preDelayLine_.setSampleRate(context.sampleRate);
+			reflectDelayLine_.setSampleRate(context.sampleRate);
+			combBank_.setSampleRate(context.sampleRate);
+
+			for(unsigned int i = 0; i < allpassFilters_[NAUDIO_LEFT].size(); ++i) {
+				allpassFilters_[NAUDIO_LEFT][i].setSampleRate(context.sampleRate);
+				allpassFilters_[NAUDIO_RIGHT][i].setSampleRate(context.sampleRate);
+			}
+
 			updateDelayTimes(context);
+			updateInputFilter(context);
 
 			//Pass thru input filters.
 			if(inputFiltBypasCtrlGen_.tick(context).value == 0.0f) {
-				inputLPF_.tickThrough(dryFrames_, workspaceFrames_[0], context);
-				inputHPF_.tickThrough(workspaceFrames_[0], workspaceFrames_[0], context);
+				inputFilter_.filter(dryFrames_, workspaceFrames_[0]);
 			}
 			else {
 				workspaceFrames_[0].Copy(dryFrames_);
 			}
 
-			float* wkptr0 = &(workspaceFrames_[0])[0];
-			float* wkptr1 = &(workspaceFrames_[1])[0];
-
-			//Pass thru pre-delay, input filters, and sum the early reflections.
+			//Filtered input is in w0. Pre-delay output goes to w1, then the sum of the early reflections back to w0.
 			float preDelayTime = preDelayTimeCtrlGen_.tick(context).value;
 
-			for(unsigned int i = 0; i < kSynthesisBlockSize; ++i) {
-				//Filtered input is in w0. Predelay output is in w1.
-				//Pre-delay.
-				preDelayLine_.tickIn(*wkptr0);
-				*wkptr1 = preDelayLine_.tickOut(preDelayTime);
-				preDelayLine_.advance();
+			preDelayLine_.setTap(0, preDelayTime, 1.0f);
+			preDelayLine_.process(&workspaceFrames_[0][0], &workspaceFrames_[1][0], nFrames);
 
-				//Taps, write back to w0.
-				reflectDelayLine_.tickIn(*wkptr1++);
-
-				*wkptr0 = 0;
-
-				for(unsigned int t = 0; t < reflectTapTimes_.size(); ++t) {
-					*wkptr0 += reflectDelayLine_.tickOut(reflectTapTimes_[t]) * reflectTapScale_[t];
-				}
-
-				reflectDelayLine_.advance();
-				wkptr0++;
-			}
+			reflectDelayLine_.process(&workspaceFrames_[1][0], &workspaceFrames_[0][0], nFrames);
 
 			//Comb filers.
 			preOutputFrames_[NAUDIO_LEFT].Clear();
 			preOutputFrames_[NAUDIO_RIGHT].Clear();
 
-			for(unsigned int i = 0; i < combFilters_[NAUDIO_LEFT].size(); ++i) {
-				combFilters_[NAUDIO_LEFT][i].tickThrough(workspaceFrames_[0], workspaceFrames_[1], context);
-				preOutputFrames_[NAUDIO_LEFT] += workspaceFrames_[1];
-				combFilters_[NAUDIO_RIGHT][i].tickThrough(workspaceFrames_[0], workspaceFrames_[1], context);
-				preOutputFrames_[NAUDIO_RIGHT] += workspaceFrames_[1];
-			}
+			float lowCoef = cutoffToOnePoleCoef(combLowCutoffCtrlGen_.tick(context).value, context.sampleRate);
+			float hiCoef = 1.0f - cutoffToOnePoleCoef(combHighCutoffCtrlGen_.tick(context).value, context.sampleRate);
+
+			combBank_.process(&workspaceFrames_[0][0], &preOutputFrames_[NAUDIO_LEFT][0], &preOutputFrames_[NAUDIO_RIGHT][0], nFrames, lowCoef, hiCoef);
 
 			//Allpass filters.
 			for(unsigned int i = 0; i < allpassFilters_[NAUDIO_LEFT].size(); ++i) {
@@ -208,10 +319,14 @@ namespace NAudio {
 			float spreadValue = Clamp(1.0f - stereoWidthCtrlGen_.tick(context).value, 0.0f, 1.0f);
 			float normValue = (1.0f / (1.0f + spreadValue)) * 0.04f;										//Scale back levels quite a bit.
 
-			for(unsigned int i = 0; i < kSynthesisBlockSize; ++i) {
+			for(unsigned int i = 0; i < nFrames; ++i) {
 				*outptr++ = (*preoutptrL + (spreadValue * (*preoutptrR)))*normValue;
 				*outptr++ = (*preoutptrR++ + (spreadValue * (*preoutptrL++)))*normValue;
 			}
+
+			//Combs fall by 60 dB over the decay time, after the pre-delay and the early reflections.
+			float decayTime = Max(0.0f, decayTimeCtrlGen_.tick(context).value);
+			tailLength_ = preDelayTime + reflectDelayLine_.getMaxDelay() + decayTime * (kEffectTailFloorDb / -60.0f);
 		}
 	}
 
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "NAudioCore.h"
+
+#include <atomic>
+
+namespace NAudio {
+	namespace NAudio_DSP {
+		//Lock-free, wait-free queue with exactly one producer thread and one consumer thread. Used to pass commands from control threads to the audio thread.
+		//Capacity is rounded up to a power of two. All memory is allocated in the constructor, push and pop never allocate.
+		//NOTE: IF SEVERAL THREADS NEED TO PUSH, THEY MUST SERIALIZE THEIR CALLS TO PUSH THEMSELVES.
+		template<typename T>
+		class SPSCQueue {
+		private:
+			std::vector<T> items_;
+			size_t mask_;
+
+			//Written only by the consumer.
+			std::atomic<size_t> readIndex_;
+
+			//Written only by the producer.
+			std::atomic<size_t> writeIndex_;
+
+			SPSCQueue(const SPSCQueue&);
+			SPSCQueue& operator=(const SPSCQueue&);
+
+		public:
+			SPSCQueue(size_t capacity = 1024);
+
+			size_t
+			capacity() const {
+				return(items_.size());
+			}
+
+			//Producer side. Returns true if a push would fail.
+			bool
+			full() const {
+				return(writeIndex_.load(std::memory_order_relaxed) - readIndex_.load(std::memory_order_acquire) >= items_.size());
+			}
+
+			//Producer side. Returns false if the queue is full.
+			bool
+			push(const T& item);
+
+			//Producer side. Pushes all n items or none of them. The consumer sees them all at once, so a bulk push is never split between two drains.
+			//items is any iterator, so items can be produced as they are pushed instead of being gathered in an array first.
+			template<typename Iterator>
+			bool
+			push(Iterator items, size_t n);
+
+			//Consumer side. Returns false if the queue is empty.
+			bool
+			pop(T& item);
+		};
+
+		template<typename T>
+		SPSCQueue<T>::SPSCQueue(size_t capacity) :
+			readIndex_(0), writeIndex_(0)
+		{
+			size_t size = 1;
+
+			while(size < capacity) {
+				size <<= 1;
+			}
+
+			items_.resize(size);
+			mask_ = size - 1;
+		}
+
+		template<typename T>
+		inline bool
+		SPSCQueue<T>::push(const T& item) {
+			return(push(&item, 1));
+		}
+
+		template<typename T>
+		template<typename Iterator>
+		inline bool
+		SPSCQueue<T>::push(Iterator items, size_t n) {
+			const size_t write = writeIndex_.load(std::memory_order_relaxed);
+			const size_t read = readIndex_.load(std::memory_order_acquire);
+
+			if(items_.size() - (write - read) < n) {
+				return(false);
+			}
+
+			for(size_t i = 0; i < n; ++i, ++items) {
+				items_[(write + i) & mask_] = *items;
+			}
+
+			writeIndex_.store(write + n, std::memory_order_release);
+
+			return(true);
+		}
+
+		template<typename T>
+		inline bool
+		SPSCQueue<T>::pop(T& item) {
+			const size_t read = readIndex_.load(std::memory_order_relaxed);
+
+			if(read == writeIndex_.load(std::memory_order_acquire)) {
+				return(false);
+			}
+
+			item = items_[read & mask_];
+			readIndex_.store(read + 1, std::memory_order_release);
+
+			return(true);
+		}
+	}
+}
\ No newline at end of file
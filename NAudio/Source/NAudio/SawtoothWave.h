@@ -37,30 +37,25 @@ namespace NAudio {
 
 		inline void
 		AngularWave_::computeSynthesisBlock(const SynthesisContext_& context) {
-			//Tick freq and slope inputs.
-			freqGen_.tick(freqFrames_, context);
-			slopeGen_.tick(slopeFrames_, context);
-
 			//Calculate the output wave.
-			float const rateConstant = NAUDIO_SAW_RES / NAudio::SampleRate();
+			float const rateConstant = NAUDIO_SAW_RES / context.sampleRate;
+
+			//Tick freq and slope inputs. Freq is pre-multiplied by the rate constant for speed. Fixed inputs are read from a single value.
+			float constantRate;
+			unsigned int freqStride;
+			unsigned int slopeStride;
+
+			const float* freqptr = freqGen_.tickScaledSamples(freqFrames_, rateConstant, constantRate, context, freqStride);
+			const float* slopeptr = slopeGen_.tickSamples(slopeFrames_, context, slopeStride);
 
 			float slope;
 			float frac;
 			float phase;
 
 			float* outptr = &outputFrames_[0];
-			float* freqptr = &freqFrames_[0];
-			float* slopeptr = &slopeFrames_[0];
 
 			FastPhasor sd;
 
-			//Pre-multiply rate constant for speed.
-			for(unsigned int i = 0; i < kSynthesisBlockSize; ++i) {
-				*freqptr++ *= rateConstant;
-			}
-
-			freqptr = &freqFrames_[0];
-
 			sd.d = BIT32DECPT;
 
 			int offs;
@@ -70,10 +65,12 @@ namespace NAudio {
 
 			for(unsigned int i = 0; i < outputFrames_.Frames(); ++i) {
 				//Update the slope.
-				slope = Clamp(*slopeptr++, 0.0f, 1.0f) * NAUDIO_SAW_RES;
+				slope = Clamp(*slopeptr, 0.0f, 1.0f) * NAUDIO_SAW_RES;
+				slopeptr += slopeStride;
 
 				sd.d = ps;
-				ps += *freqptr++;
+				ps += *freqptr;
+				freqptr += freqStride;
 				offs = sd.i[1] & (NAUDIO_SAW_RES - 1);
 				sd.i[1] = msbi;
 				frac = (float)(sd.d - BIT32DECPT);
@@ -107,23 +104,18 @@ namespace NAudio {
 
 		inline void
 		SawtoothWaveBL_::computeSynthesisBlock(const NAudio_DSP::SynthesisContext_& context) {
-			static const float rateConstant = 1.0f / NAudio::SampleRate();
+			const float rateConstant = 1.0f / context.sampleRate;
 
-			//Tick freq and pwm.
-			freqGen_.tick(freqFrames_, context);
+			//Tick freq, pre-multiplied by the rate constant for speed. A fixed freq is read from a single value.
+			float constantRate;
+			unsigned int freqStride;
 
-			float* outptr = &outputFrames_[0];
-			float* freqptr = &freqFrames_[0];
+			const float* freqptr = freqGen_.tickScaledSamples(freqFrames_, rateConstant, constantRate, context, freqStride);
 
-			//Pre-multiply rate constant for speed.
-			for(unsigned int i = 0; i < kSynthesisBlockSize; i++) {
-				*freqptr++ *= rateConstant;
-			}
-
-			freqptr = &freqFrames_[0];
+			float* outptr = &outputFrames_[0];
 
 			//TODO: Maybe do this using a fast phasor for wraparound speed.
-			for(unsigned int i = 0; i < kSynthesisBlockSize; ++i, ++freqptr, ++outptr) {
+			for(unsigned int i = 0; i < outputFrames_.Frames(); ++i, freqptr += freqStride, ++outptr) {
 				phase_ += *freqptr;
 
 				//Add BLEP at end.
@@ -0,0 +1,210 @@
+#include "StateVariableFilter.h"
+
+//Cutoff range, the top as a fraction of the sample rate. The prewarped cutoff runs off to infinity at Nyquist.
+#define NAUDIO_SVF_MIN_CUTOFF			20.0f
+#define NAUDIO_SVF_MAX_CUTOFF_RATIO		0.49f
+
+//Lowest Q. The damping 1 / Q grows without bound below it.
+#define NAUDIO_SVF_MIN_Q				0.05f
+
+namespace NAudio {
+	namespace NAudio_DSP {
+		//Coefficients of the filter loop from the prewarped cutoff g and the damping k = 1 / Q.
+		inline static void
+		svfCoefficients(float g, float k, float m1Scale, float* a1, float* a2, float* a3, float* m1) {
+			const float d = 1.0f / (1.0f + g * (g + k));
+
+			*a1 = d;
+			*a2 = g * d;
+			*a3 = g * g * d;
+			*m1 = k * m1Scale;
+		}
+
+		//Run the filter over nFrames interleaved frames. coefs holds planes of a1, a2, a3 and m1, planeSize apart, advancing by coefStride each frame. A stride of 0 runs the whole block on one set.
+		static void
+		runStateVariableFilter(const float* in, float* out, unsigned int nChannels, unsigned int nFrames, const float* coefs, unsigned int planeSize, unsigned int coefStride, float m0, float m2, float* ic1eq, float* ic2eq) {
+			const float* a1s = coefs;
+			const float* a2s = coefs + planeSize;
+			const float* a3s = coefs + 2 * planeSize;
+			const float* m1s = coefs + 3 * planeSize;
+
+			float s1[2] = { ic1eq[0], ic1eq[1] };
+			float s2[2] = { ic2eq[0], ic2eq[1] };
+
+			for(unsigned int i = 0; i < nFrames; ++i) {
+				const unsigned int n = i * coefStride;
+				const float a1 = a1s[n];
+				const float a2 = a2s[n];
+				const float a3 = a3s[n];
+				const float m1 = m1s[n];
+
+				for(unsigned int c = 0; c < nChannels; ++c) {
+					const float v0 = *in++;
+					const float v3 = v0 - s2[c];
+					const float v1 = a1 * s1[c] + a2 * v3;
+					const float v2 = s2[c] + a2 * s1[c] + a3 * v3;
+
+					s1[c] = 2.0f * v1 - s1[c];
+					s2[c] = 2.0f * v2 - s2[c];
+
+					*out++ = m0 * v0 + m1 * v1 + m2 * v2;
+				}
+			}
+
+			ic1eq[0] = s1[0];
+			ic1eq[1] = s1[1];
+			ic2eq[0] = s2[0];
+			ic2eq[1] = s2[1];
+		}
+
+		StateVariableFilter_::StateVariableFilter_() :
+			cutoff_(FixedValue(20000.0f)), Q_(FixedValue(0.7071f)), gain_(ControlValue(0.0f)),
+			mode_(SVFModeLowpass), modeChanged_(true),
+			gScale_(1.0f), kScale_(1.0f), m0_(0.0f), m1Scale_(0.0f), m2_(1.0f)
+		{
+			ic1eq_[0] = 0.0f;
+			ic1eq_[1] = 0.0f;
+			ic2eq_[0] = 0.0f;
+			ic2eq_[1] = 0.0f;
+
+			cutoffFrames_.Resize(kSynthesisBlockSize, 1u, 0.0f);
+			QFrames_.Resize(kSynthesisBlockSize, 1u, 0.0f);
+			frameCoefs_.resize(4 * kSynthesisBlockSize, 0.0f);
+		}
+
+		void
+		StateVariableFilter_::setInput(Generator input) {
+			Effect_::setInput(input);
+			setIsStereoInput(input.isStereoOutput());
+			setIsStereoOutput(input.isStereoOutput());
+		}
+
+		void
+		StateVariableFilter_::setMode(SVFMode mode) {
+			mode_ = mode;
+			modeChanged_ = true;
+		}
+
+		void
+		StateVariableFilter_::updateModeTerms(float gainDb) {
+			//Amplitude at the middle of the transition, half the gain in dB.
+			const float A = powf(10.0f, gainDb / 40.0f);
+
+			gScale_ = 1.0f;
+			kScale_ = 1.0f;
+			m0_ = 0.0f;
+			m1Scale_ = 0.0f;
+			m2_ = 0.0f;
+
+			switch(mode_) {
+				case SVFModeLowpass:
+					m2_ = 1.0f;
+					break;
+				case SVFModeHighpass:
+					m0_ = 1.0f;
+					m1Scale_ = -1.0f;
+					m2_ = -1.0f;
+					break;
+				case SVFModeBandpass:
+					m1Scale_ = 1.0f;
+					break;
+				case SVFModeNotch:
+					m0_ = 1.0f;
+					m1Scale_ = -1.0f;
+					break;
+				case SVFModePeak:
+					m0_ = 1.0f;
+					m1Scale_ = -1.0f;
+					m2_ = -2.0f;
+					break;
+				case SVFModeBell:
+					//Narrower when boosting, so boost and cut of the same gain undo each other.
+					kScale_ = 1.0f / A;
+					m0_ = 1.0f;
+					m1Scale_ = A * A - 1.0f;
+					break;
+				case SVFModeLowShelf:
+					gScale_ = 1.0f / sqrtf(A);
+					m0_ = 1.0f;
+					m1Scale_ = A - 1.0f;
+					m2_ = A * A - 1.0f;
+					break;
+				case SVFModeHighShelf:
+					gScale_ = sqrtf(A);
+					m0_ = A * A;
+					m1Scale_ = (1.0f - A) * A;
+					m2_ = 1.0f - A * A;
+					break;
+			}
+		}
+
+		void
+		StateVariableFilter_::computeSynthesisBlock(const SynthesisContext_& context) {
+			const unsigned int nFrames = outputFrames_.Frames();
+
+			ControlGeneratorOutput gainOutput = gain_.tick(context);
+
+			if(gainOutput.triggered || modeChanged_) {
+				updateModeTerms(gainOutput.value);
+				modeChanged_ = false;
+			}
+
+			unsigned int cutoffStride;
+			unsigned int QStride;
+
+			const float* cutoff = cutoff_.tickSamples(cutoffFrames_, context, cutoffStride);
+			const float* Q = Q_.tickSamples(QFrames_, context, QStride);
+
+			const float minCutoff = NAUDIO_SVF_MIN_CUTOFF;
+			const float maxCutoff = NAUDIO_SVF_MAX_CUTOFF_RATIO * context.sampleRate;
+			const float warp = PI / context.sampleRate;
+
+			//Ringing at the cutoff decays with a time constant of Q / (PI * cutoff). The bell narrows with its gain, so its Q is effectively Q / kScale_.
+			tailLength_ = logf(1.0f / DBToLin(kEffectTailFloorDb)) * Max(Q[0], NAUDIO_SVF_MIN_Q) / (kScale_ * PI * Clamp(cutoff[0], minCutoff, maxCutoff));
+
+			if(cutoffStride == 0 && QStride == 0) {
+				//Nothing moves, one set of coefficients for the block.
+				float coefs[4];
+
+				svfCoefficients(fastTan(warp * Clamp(cutoff[0], minCutoff, maxCutoff)) * gScale_, kScale_ / Max(Q[0], NAUDIO_SVF_MIN_Q), m1Scale_, coefs, coefs + 1, coefs + 2, coefs + 3);
+				runStateVariableFilter(&dryFrames_[0], &outputFrames_[0], dryFrames_.Channels(), nFrames, coefs, 1u, 0u, m0_, m2_, ic1eq_, ic2eq_);
+				return;
+			}
+
+			//One set per frame, in planes of a1, a2, a3 and m1. Each pass has no dependency between frames, so they vectorize.
+			if(frameCoefs_.size() < 4 * nFrames) {
+				frameCoefs_.resize(4 * nFrames);
+			}
+
+			float* a1 = &frameCoefs_[0];
+			float* a2 = a1 + nFrames;
+			float* a3 = a2 + nFrames;
+			float* m1 = a3 + nFrames;
+
+			//g goes to a1 and k to a2 first, then both are turned into the coefficients in place.
+			if(cutoffStride == 0) {
+				std::fill(a1, a1 + nFrames, fastTan(warp * Clamp(cutoff[0], minCutoff, maxCutoff)) * gScale_);
+			}
+			else {
+				for(unsigned int i = 0; i < nFrames; ++i) {
+					a1[i] = fastTan(warp * Clamp(cutoff[i], minCutoff, maxCutoff)) * gScale_;
+				}
+			}
+
+			if(QStride == 0) {
+				std::fill(a2, a2 + nFrames, kScale_ / Max(Q[0], NAUDIO_SVF_MIN_Q));
+			}
+			else {
+				for(unsigned int i = 0; i < nFrames; ++i) {
+					a2[i] = kScale_ / Max(Q[i], NAUDIO_SVF_MIN_Q);
+				}
+			}
+
+			for(unsigned int i = 0; i < nFrames; ++i) {
+				svfCoefficients(a1[i], a2[i], m1Scale_, a1 + i, a2 + i, a3 + i, m1 + i);
+			}
+
+			runStateVariableFilter(&dryFrames_[0], &outputFrames_[0], dryFrames_.Channels(), nFrames, a1, nFrames, 1u, m0_, m2_, ic1eq_, ic2eq_);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,178 @@
+#pragma once
+
+#include "Effect.h"
+#include "FilterUtils.h"
+#include "Generator.h"
+#include "ControlGenerator.h"
+
+//Zero-delay feedback state variable filter. Follows its cutoff and Q every sample, so envelopes and audio-rate modulation sweep it without stepping.
+namespace NAudio {
+	typedef enum {
+		SVFModeLowpass = 0,
+		SVFModeHighpass,
+		SVFModeBandpass,		//Constant 0dB peak.
+		SVFModeNotch,
+		SVFModePeak,			//Lowpass minus highpass. Flat, with a resonant peak at the cutoff that grows with Q.
+		SVFModeBell,			//Peaking EQ. Boosts or cuts around the cutoff by the gain, Q sets the width.
+		SVFModeLowShelf,		//Boosts or cuts below the cutoff by the gain.
+		SVFModeHighShelf		//Boosts or cuts above the cutoff by the gain.
+	} SVFMode;
+
+	namespace NAudio_DSP {
+		//Two trapezoidal integrators in a loop, solved without a unit delay (topology-preserving transform). Lowpass, bandpass and highpass all come out of the same core, every mode is a mix of them.
+		//When cutoff and Q are constant over a block the coefficients are computed once, otherwise once per frame in a pass ahead of the filter loop.
+		class StateVariableFilter_ : public Effect_ {
+		protected:
+			Generator cutoff_;
+			Generator Q_;
+			ControlGenerator gain_;
+
+			SVFMode mode_;
+			bool modeChanged_;
+
+			//Integrator states of each channel.
+			float ic1eq_[2];
+			float ic2eq_[2];
+
+			//Per block terms from the mode and gain. The cutoff is prewarped and scaled by gScale_, 1 / Q by kScale_.
+			//The output is m0_ * input + k * m1Scale_ * bandpass + m2_ * lowpass.
+			float gScale_;
+			float kScale_;
+			float m0_;
+			float m1Scale_;
+			float m2_;
+
+			//Workspaces for modulated cutoff and Q, and per frame coefficients a1, a2, a3, m1 when either of them is.
+			NAudioFrames cutoffFrames_;
+			NAudioFrames QFrames_;
+			std::vector<float> frameCoefs_;
+
+			void
+			updateModeTerms(float gainDb);
+
+			void
+			computeSynthesisBlock(const SynthesisContext_& context);
+
+		public:
+			StateVariableFilter_();
+
+			//Overridden so output channel layout follows input channel layout.
+			virtual void
+			setInput(Generator input);
+
+			void
+			setMode(SVFMode mode);
+
+			void
+			setCutoff(Generator cutoff) {
+				cutoff_ = cutoff;
+			}
+
+			void
+			setQ(Generator Q) {
+				Q_ = Q;
+			}
+
+			void
+			setGain(ControlGenerator gain) {
+				gain_ = gain;
+			}
+		};
+	}
+
+	//Smart Pointers.
+	template<class FilterType>
+	class TemplatedStateVariableFilter : public TemplatedEffect<FilterType, NAudio_DSP::StateVariableFilter_> {
+	public:
+		TemplatedStateVariableFilter(SVFMode mode) {
+			this->gen()->setMode(mode);
+		}
+
+		//Value in Hz. Read every sample.
+		NAUDIO_MAKE_GEN_SETTERS(FilterType, cutoff, setCutoff);
+
+		//Read every sample. 0.7071 is the flattest response without a peak.
+		NAUDIO_MAKE_GEN_SETTERS(FilterType, Q, setQ);
+
+		//Value in dB for the bell and shelf modes.
+		NAUDIO_MAKE_CTRL_GEN_SETTERS(FilterType, gain, setGain);
+	};
+
+	//Any mode, which can change while the filter runs.
+	class StateVariableFilter : public TemplatedStateVariableFilter<StateVariableFilter> {
+	public:
+		StateVariableFilter(SVFMode mode = SVFModeLowpass) :
+			TemplatedStateVariableFilter<StateVariableFilter>(mode)
+		{}
+
+		StateVariableFilter&
+		mode(SVFMode mode) {
+			this->gen()->setMode(mode);
+			return(*this);
+		}
+	};
+
+	//SVF lowpass.
+	class SVFLowpass : public TemplatedStateVariableFilter<SVFLowpass> {
+	public:
+		SVFLowpass() :
+			TemplatedStateVariableFilter<SVFLowpass>(SVFModeLowpass)
+		{}
+	};
+
+	//SVF highpass.
+	class SVFHighpass : public TemplatedStateVariableFilter<SVFHighpass> {
+	public:
+		SVFHighpass() :
+			TemplatedStateVariableFilter<SVFHighpass>(SVFModeHighpass)
+		{}
+	};
+
+	//SVF bandpass.
+	class SVFBandpass : public TemplatedStateVariableFilter<SVFBandpass> {
+	public:
+		SVFBandpass() :
+			TemplatedStateVariableFilter<SVFBandpass>(SVFModeBandpass)
+		{}
+	};
+
+	//SVF notch.
+	class SVFNotch : public TemplatedStateVariableFilter<SVFNotch> {
+	public:
+		SVFNotch() :
+			TemplatedStateVariableFilter<SVFNotch>(SVFModeNotch)
+		{}
+	};
+
+	//SVF peak.
+	class SVFPeak : public TemplatedStateVariableFilter<SVFPeak> {
+	public:
+		SVFPeak() :
+			TemplatedStateVariableFilter<SVFPeak>(SVFModePeak)
+		{}
+	};
+
+	//SVF bell.
+	class SVFBell : public TemplatedStateVariableFilter<SVFBell> {
+	public:
+		SVFBell() :
+			TemplatedStateVariableFilter<SVFBell>(SVFModeBell)
+		{}
+	};
+
+	//SVF low shelf.
+	class SVFLowShelf : public TemplatedStateVariableFilter<SVFLowShelf> {
+	public:
+		SVFLowShelf() :
+			TemplatedStateVariableFilter<SVFLowShelf>(SVFModeLowShelf)
+		{}
+	};
+
+	//SVF high shelf.
+	class SVFHighShelf : public TemplatedStateVariableFilter<SVFHighShelf> {
+	public:
+		SVFHighShelf() :
+			TemplatedStateVariableFilter<SVFHighShelf>(SVFModeHighShelf)
+		{}
+	};
+}
\ No newline at end of file
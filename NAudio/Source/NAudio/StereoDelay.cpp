@@ -10,6 +10,7 @@ namespace NAudio {
 			delayTimeFrames_[NAUDIO_RIGHT].Resize(kSynthesisBlockSize, 1, 0);
 			
 			fbkFrames_.Resize(kSynthesisBlockSize, 1u, 0.0f);
+			feedbackFrames_.Resize(kSynthesisBlockSize, 2u, 0.0f);
 
 			setFeedback(FixedValue(0.0f));
 			setDryLevelGen(FixedValue(0.5f));
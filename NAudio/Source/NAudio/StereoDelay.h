@@ -15,6 +15,9 @@ namespace NAudio {
 
 			DelayLine delayLine_[2];
 
+			//Input plus feedback of both channels, interleaved, written into the lines.
+			NAudioFrames feedbackFrames_;
+
 			void
 			computeSynthesisBlock(const SynthesisContext_& context);
 
@@ -42,39 +45,55 @@ namespace NAudio {
 
 		inline void
 		StereoDelay_::computeSynthesisBlock(const SynthesisContext_& context) {
-			delayTimeGen_[0].tick(delayTimeFrames_[NAUDIO_LEFT], context);
-			delayTimeGen_[1].tick(delayTimeFrames_[NAUDIO_RIGHT], context);
+			delayLine_[NAUDIO_LEFT].setSampleRate(context.sampleRate);
+			delayLine_[NAUDIO_RIGHT].setSampleRate(context.sampleRate);
+
+			//Delay times and feedback are usually fixed, those are read from a single value instead of being copied into the workspaces.
+			unsigned int delStride[2];
+			unsigned int fbkStride;
+
+			const float* delptr_l = delayTimeGen_[0].tickSamples(delayTimeFrames_[NAUDIO_LEFT], context, delStride[NAUDIO_LEFT]);
+			const float* delptr_r = delayTimeGen_[1].tickSamples(delayTimeFrames_[NAUDIO_RIGHT], context, delStride[NAUDIO_RIGHT]);
+
+			const float* fbkptr = fbkGen_.tickSamples(fbkFrames_, context, fbkStride);
 
-			fbkGen_.tick(fbkFrames_, context);
+			const float lastFbk = fbkptr[(outputFrames_.Frames() - 1) * fbkStride];
 
-			float outSamp[2];
-			float fbk;
+			const unsigned int nFrames = outputFrames_.Frames();
+			const unsigned int run = Min(delayLine_[NAUDIO_LEFT].getFeedbackRunFrames(delptr_l, delStride[NAUDIO_LEFT], nFrames), delayLine_[NAUDIO_RIGHT].getFeedbackRunFrames(delptr_r, delStride[NAUDIO_RIGHT], nFrames));
 
-			float *dryptr = &dryFrames_[0];
-			float *outptr = &outputFrames_[0];
-			float *fbkptr = &fbkFrames_[0];
-			float *delptr_l = &(delayTimeFrames_[NAUDIO_LEFT])[0];
-			float *delptr_r = &(delayTimeFrames_[NAUDIO_RIGHT])[0];
+			feedbackFrames_.Resize(nFrames, 2u);
 
-			for(unsigned int i = 0; i < kSynthesisBlockSize; ++i) {
-				//Don't clamp feedback,be careful! Negative feedback could be interesting.
-				fbk = *fbkptr++;
+			float* dryptr = &dryFrames_[0];
+			float* outptr = &outputFrames_[0];
+			float* fbptr = &feedbackFrames_[0];
 
-				outSamp[NAUDIO_LEFT] = delayLine_[NAUDIO_LEFT].tickOut(*delptr_l++);
-				outSamp[NAUDIO_RIGHT] = delayLine_[NAUDIO_RIGHT].tickOut(*delptr_r++);
+			//Read a run of both lines, then feed them back. Runs are short enough that none of their reads reach the frames they write.
+			for(unsigned int done = 0, count = 0; done < nFrames; done += count) {
+				count = Min(nFrames - done, run);
 
-				//Output left sample.
-				*outptr++ = outSamp[NAUDIO_LEFT];
-				delayLine_[NAUDIO_LEFT].tickIn(*dryptr++ + outSamp[NAUDIO_LEFT] * fbk);
+				delayLine_[NAUDIO_LEFT].read(outptr + done * 2, 2u, delptr_l + done * delStride[NAUDIO_LEFT], delStride[NAUDIO_LEFT], count);
+				delayLine_[NAUDIO_RIGHT].read(outptr + done * 2 + 1, 2u, delptr_r + done * delStride[NAUDIO_RIGHT], delStride[NAUDIO_RIGHT], count);
 
-				//Output right sample.
-				*outptr++ = outSamp[NAUDIO_RIGHT];
-				delayLine_[NAUDIO_RIGHT].tickIn(*dryptr++ + outSamp[NAUDIO_RIGHT] * fbk);
+				for(unsigned int i = done * 2; i < (done + count) * 2; i += 2) {
+					//Don't clamp feedback,be careful! Negative feedback could be interesting.
+					float fbk = *fbkptr;
+					fbkptr += fbkStride;
 
-				//Advance delay lines.
-				delayLine_[NAUDIO_LEFT].advance();
-				delayLine_[NAUDIO_RIGHT].advance();
+					fbptr[i] = dryptr[i] + outptr[i] * fbk;
+					fbptr[i + 1] = dryptr[i + 1] + outptr[i + 1] * fbk;
+				}
+
+				delayLine_[NAUDIO_LEFT].write(fbptr + done * 2, 2u, count, 0u);
+				delayLine_[NAUDIO_RIGHT].write(fbptr + done * 2 + 1, 2u, count, 0u);
+
+				delayLine_[NAUDIO_LEFT].advance(count);
+				delayLine_[NAUDIO_RIGHT].advance(count);
 			}
+
+			//The lines can be read anywhere up to their maximum delay, so the tail is measured from there.
+			float maxDelay = Max(delayLine_[NAUDIO_LEFT].getMaxDelay(), delayLine_[NAUDIO_RIGHT].getMaxDelay());
+			tailLength_ = feedbackDelayTail(maxDelay, lastFbk, kEffectTailFloorDb);
 		}
 	}
 	
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "SPSCQueue.h"
+
+namespace NAudio {
+	namespace NAudio_DSP {
+		//RCU-style holder for state that is read by the audio thread and replaced by control threads, such as a synth's output graph or a mixer's input list.
+		//Control threads build a new copy and publish() it. The audio thread installs the newest published copy with update() at a block boundary, with one atomic exchange.
+		//Replaced copies are handed back to the control side and deleted there, so the audio thread never blocks, allocates or frees memory.
+		//NOTE: CALLS TO latest(), publish() AND collectGarbage() MUST BE SERIALIZED BY THE CALLER (BufferFiller_::lockMutex() IS USED FOR THAT). THE AUDIO THREAD NEVER TAKES THAT LOCK.
+		template<typename T>
+		class SwapSlot {
+		private:
+			//Copy the audio thread is using. Only touched by the audio thread after construction.
+			T* current_;
+
+			//Newest published copy not yet installed, or NULL.
+			std::atomic<T*> pending_;
+
+			//Newest published copy, whether installed or not. Control side only.
+			T* latest_;
+
+			//Copies replaced by update(), waiting to be deleted by the control side.
+			SPSCQueue<T*> retired_;
+
+			SwapSlot(const SwapSlot&);
+			SwapSlot& operator=(const SwapSlot&);
+
+		public:
+			SwapSlot(size_t retireCapacity = 64);
+			~SwapSlot();
+
+			//Audio thread. State to use for the current block.
+			T&
+			current() {
+				return(*current_);
+			}
+
+			//Audio thread. Install the newest published copy, if any. Returns true if the state changed.
+			//If too many old copies are still waiting to be deleted, the swap is postponed to a later block.
+			bool
+			update();
+
+			//Control side. Newest published state, to be copied and modified before the next publish().
+			const T&
+			latest() const {
+				return(*latest_);
+			}
+
+			//Control side. Take ownership of next and schedule it for installation. A copy published earlier but never installed is deleted right away.
+			void
+			publish(T* next);
+
+			//Control side. Delete copies the audio thread no longer uses. Also done by every publish().
+			void
+			collectGarbage();
+		};
+
+		template<typename T>
+		SwapSlot<T>::SwapSlot(size_t retireCapacity) :
+			current_(new T), pending_(NULL), retired_(retireCapacity)
+		{
+			latest_ = current_;
+		}
+
+		template<typename T>
+		SwapSlot<T>::~SwapSlot() {
+			collectGarbage();
+
+			delete pending_.exchange(NULL);
+			delete current_;
+		}
+
+		template<typename T>
+		inline bool
+		SwapSlot<T>::update() {
+			if(pending_.load(std::memory_order_relaxed) == NULL || retired_.full()) {
+				return(false);
+			}
+
+			T* next = pending_.exchange(NULL, std::memory_order_acq_rel);
+
+			if(next == NULL) {
+				return(false);
+			}
+
+			retired_.push(current_);
+			current_ = next;
+
+			return(true);
+		}
+
+		template<typename T>
+		void
+		SwapSlot<T>::publish(T* next) {
+			latest_ = next;
+
+			//The audio thread can only take the pending copy through the same exchange, so an old copy returned here was never installed.
+			delete pending_.exchange(next, std::memory_order_acq_rel);
+
+			collectGarbage();
+		}
+
+		template<typename T>
+		void
+		SwapSlot<T>::collectGarbage() {
+			T* old;
+
+			while(retired_.pop(old)) {
+				delete old;
+			}
+		}
+	}
+}
\ No newline at end of file
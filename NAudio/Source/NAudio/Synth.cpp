@@ -6,26 +6,148 @@ namespace NAudio {
 
 	namespace NAudio_DSP {
 		Synth_::Synth_() :
-			limitOutput_(true)
+			limitOutput_(true), compileGraph_(false), commandQueue_(kParameterQueueCapacity)
 		{
 			limiter_.setIsStereo(true);
+			deferredCommands_.reserve(kParameterQueueCapacity);
+		}
+
+		void
+		Synth_::setOutputGen(Generator gen) {
+			lockMutex();
+			{
+				SynthGraph_* next = new SynthGraph_(graph_.latest());
+
+				next->outputGen = gen;
+				graph_.publish(next);
+			}
+			unlockMutex();
+		}
+
+		const Generator
+		Synth_::getOutputGen() {
+			lockMutex();
+			Generator gen = graph_.latest().outputGen;
+			unlockMutex();
+
+			return(gen);
+		}
+
+		void
+		Synth_::addAuxControlGenerator(ControlGenerator generator) {
+			lockMutex();
+			{
+				SynthGraph_* next = new SynthGraph_(graph_.latest());
+
+				next->auxControlGenerators.push_back(generator);
+				graph_.publish(next);
+			}
+			unlockMutex();
 		}
 
 		void
 		Synth_::setParameter(std::string name, float value, bool normalized) {
-			if(parameters_.find(name) != parameters_.end()) {
-				ControlParameter& param = parameters_[name];
+			ParameterHandle handle = getParameterHandle(name);
+
+			if(handle != kInvalidParameterHandle) {
+				setParameter(handle, value, normalized, 0);
+			}
+			else {
+				LOG(NLOG_ERROR, "Message: %s was not registered. You can register a message using Synth::addParameter.", name.c_str());
+			}
+		}
+
+		ParameterHandle
+		Synth_::getParameterHandle(std::string name) {
+			std::map<std::string, ParameterHandle>::iterator it = parameterHandles_.find(name);
+
+			if(it == parameterHandles_.end()) {
+				return(kInvalidParameterHandle);
+			}
+
+			return(it->second);
+		}
+
+		bool
+		Synth_::setParameter(ParameterHandle handle, float value, bool normalized, unsigned int sampleOffset) {
+			return(setParameters(&handle, &value, 1, normalized, sampleOffset));
+		}
+
+		bool
+		Synth_::setParameters(const ParameterHandle* handles, const float* values, unsigned int count, bool normalized, unsigned int sampleOffset) {
+			for(unsigned int i = 0; i < count; ++i) {
+				if(handles[i] < 0 || handles[i] >= (ParameterHandle)parameterList_.size()) {
+					LOG(NLOG_ERROR, "Invalid parameter handle %d.", handles[i]);
+					return(false);
+				}
+			}
+
+			if(count > 0 && !commandQueue_.push(ParameterCommandIterator_(handles, values, normalized, sampleOffset), count)) {
+				LOG(NLOG_WARN, "Parameter queue is full, %u parameter changes were dropped.", count);
+				return(false);
+			}
 
-				if(normalized) {
-					param.setNormalizedValue(value);
+			return(true);
+		}
+
+		void
+		Synth_::processCommands(const SynthesisContext_& context) {
+			//Install a graph published by a control thread, if any. The schedule is recorded again on the next block.
+			if(graph_.update()) {
+				schedule_.invalidate();
+			}
+
+			const unsigned long blockEnd = context.elapsedFrames + context.blockSize;
+
+			//Handles added after the installed graph was published wait for the next one.
+			const ParameterHandle installed = (ParameterHandle)graph_.current().parameters.size();
+
+			//Commands deferred from earlier blocks go first, so changes to the same parameter keep their order.
+			size_t kept = 0;
+
+			for(size_t i = 0; i < deferredCommands_.size(); ++i) {
+				if(deferredCommands_[i].frame < blockEnd && deferredCommands_[i].handle < installed) {
+					applyCommand(deferredCommands_[i], context.elapsedFrames);
 				}
 				else {
-					param.value(value);
+					deferredCommands_[kept++] = deferredCommands_[i];
 				}
 			}
-			else {
-				LOG(NLOG_ERROR, "Message: %s was not registered. You can register a message using Synth::addParameter.", name);
+
+			deferredCommands_.resize(kept);
+
+			ParameterCommand_ command;
+
+			while(commandQueue_.pop(command)) {
+				command.frame += context.elapsedFrames;
+
+				if(command.frame < blockEnd && command.handle < installed) {
+					applyCommand(command, context.elapsedFrames);
+				}
+				else if(deferredCommands_.size() < deferredCommands_.capacity()) {
+					deferredCommands_.push_back(command);
+				}
+				else if(command.handle < installed) {
+					//Never allocate on the audio thread, apply early instead.
+					LOG(NLOG_WARN, "Too many deferred parameter changes, applying change to parameter %d early.", command.handle);
+					applyCommand(command, context.elapsedFrames);
+				}
+				else {
+					LOG(NLOG_WARN, "Too many deferred parameter changes, dropping change to parameter %d.", command.handle);
+				}
+			}
+		}
+
+		void
+		Synth_::publishParameters() {
+			lockMutex();
+			{
+				SynthGraph_* next = new SynthGraph_(graph_.latest());
+
+				next->parameters = parameterList_;
+				graph_.publish(next);
 			}
+			unlockMutex();
 		}
 
 		ControlParameter
@@ -34,6 +156,10 @@ namespace NAudio {
 				ControlParameter param = ControlParameter().name(name).value(initialValue).displayName(name);
 				parameters_[name] = param;
 
+				parameterHandles_[name] = (ParameterHandle)parameterList_.size();
+				parameterList_.push_back(param);
+				publishParameters();
+
 				orderedParameterNames_.push_back(name);
 			}
 
@@ -45,6 +171,19 @@ namespace NAudio {
 			std::string name = parameter.getName();
 			parameters_[name] = parameter;
 
+			//Replacing a parameter keeps its handle.
+			std::map<std::string, ParameterHandle>::iterator it = parameterHandles_.find(name);
+
+			if(it != parameterHandles_.end()) {
+				parameterList_[it->second] = parameter;
+			}
+			else {
+				parameterHandles_[name] = (ParameterHandle)parameterList_.size();
+				parameterList_.push_back(parameter);
+			}
+
+			publishParameters();
+
 			orderedParameterNames_.push_back(name);
 		}
 
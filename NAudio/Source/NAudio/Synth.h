@@ -4,49 +4,137 @@
 #include "ControlParameter.h"
 #include "CompressorLimiter.h"
 #include "ControlChangeNotifier.h"
+#include "SPSCQueue.h"
 
 namespace NAudio {
 	//Forward declaration.
 	class Synth;
 
+	//Precompiled reference to a Synth parameter, obtained once with Synth::getParameterHandle and then used instead of the parameter name.
+	typedef int ParameterHandle;
+
+	static const ParameterHandle kInvalidParameterHandle = -1;
+
+	//Number of parameter changes that can be waiting for the audio thread at once.
+	static const unsigned int kParameterQueueCapacity = 4096;
+
 	namespace NAudio_DSP {
+		//Parameter change queued from a control thread.
+		struct ParameterCommand_ {
+			ParameterHandle handle;
+			float value;
+			bool normalized;
+
+			//Offset in frames from the start of the block the command is picked up in. Absolute frame once picked up by the audio thread.
+			unsigned long frame;
+		};
+
+		//Part of a Synth_ that can be replaced while the synth is running. Swapped as a whole through a SwapSlot.
+		struct SynthGraph_ {
+			Generator outputGen;
+
+			//ControlGenerators that may not be part of the synthesis graph, but should be ticked anyway.
+			std::vector<ControlGenerator> auxControlGenerators;
+
+			//Parameters indexed by handle, as seen by the audio thread. A copy of Synth_::parameterList_ from when this graph was published.
+			std::vector<ControlParameter> parameters;
+		};
+
+		//Turns parallel arrays of handles and values into ParameterCommand_s while they are pushed, so a batch needs no temporary copy.
+		class ParameterCommandIterator_ {
+		private:
+			const ParameterHandle* handles_;
+			const float* values_;
+			bool normalized_;
+			unsigned int sampleOffset_;
+
+		public:
+			ParameterCommandIterator_(const ParameterHandle* handles, const float* values, bool normalized, unsigned int sampleOffset) :
+				handles_(handles), values_(values), normalized_(normalized), sampleOffset_(sampleOffset)
+			{
+			}
+
+			ParameterCommand_
+			operator*() const {
+				ParameterCommand_ command;
+
+				command.handle = *handles_;
+				command.value = *values_;
+				command.normalized = normalized_;
+				command.frame = sampleOffset_;
+
+				return(command);
+			}
+
+			ParameterCommandIterator_&
+			operator++() {
+				++handles_;
+				++values_;
+
+				return(*this);
+			}
+		};
+
 		class Synth_ : public BufferFiller_ {
 		protected:
-			Generator outputGen_;
+			SwapSlot<SynthGraph_> graph_;
 
 			Limiter limiter_;
 			bool limitOutput_;
 
+			//Flat execution order for the current graph. Only touched by the audio thread.
+			GraphSchedule_ schedule_;
+			bool compileGraph_;
+
 			std::map<std::string, ControlParameter>				parameters_;
 			std::vector<std::string>							orderedParameterNames_;
 			std::map<std::string, ControlChangeNotifier>		controlChangeNotifiers_;
 			std::vector<ControlChangeNotifier>					controlChangeNotifiersList_;
 
-			//ControlGenerators that may not be part of the synthesis graph, but should be ticked anyway.
-			std::vector<ControlGenerator> auxControlGenerators_;
+			//Parameters indexed by handle. Only grows, so handles stay valid. Control side only, the audio thread reads the copy published with the graph.
+			std::vector<ControlParameter>						parameterList_;
+			std::map<std::string, ParameterHandle>				parameterHandles_;
+
+			//Written by one control thread, drained by the audio thread in processCommands().
+			SPSCQueue<ParameterCommand_>						commandQueue_;
+
+			//Commands whose frame is past the current block. Only touched by the audio thread.
+			std::vector<ParameterCommand_>						deferredCommands_;
 
 			void
 			computeSynthesisBlock(const NAudio::NAudio_DSP::SynthesisContext_& context);
 
+			void
+			processCommands(const SynthesisContext_& context);
+
+			//Apply a command picked up for the block starting at blockStart, at its offset within that block.
+			void
+			applyCommand(const ParameterCommand_& command, unsigned long blockStart);
+
+			//Publish parameterList_ to the audio thread, with the rest of the graph.
+			void
+			publishParameters();
+
 		public:
 			Synth_();
 
-			//Set the output gen that produces audio for the Synth.
+			//Set the output gen that produces audio for the Synth. The new graph is used from the next block on.
 			void
-			setOutputGen(Generator gen) {
-				outputGen_ = gen;
-			}
+			setOutputGen(Generator gen);
 
 			const Generator
-			getOutputGen() {
-				return(outputGen_);
-			}
+			getOutputGen();
 
 			void
 			setLimitOutput(bool shouldLimit) {
 				limitOutput_ = shouldLimit;
 			}
 
+			void
+			setCompileGraph(bool compile) {
+				compileGraph_ = compile;
+			}
+
 			ControlParameter
 			addParameter(std::string name, float initialValue);
 
@@ -59,6 +147,15 @@ namespace NAudio {
 			void
 			setParameter(std::string name, float value, bool normalized = false);
 
+			ParameterHandle
+			getParameterHandle(std::string name);
+
+			bool
+			setParameter(ParameterHandle handle, float value, bool normalized, unsigned int sampleOffset);
+
+			bool
+			setParameters(const ParameterHandle* handles, const float* values, unsigned int count, bool normalized, unsigned int sampleOffset);
+
 			std::vector<ControlParameter>
 			getParameters();
 
@@ -66,13 +163,11 @@ namespace NAudio {
 			publishChanges(ControlGenerator input, std::string name);
 
 			void
-			addAuxControlGenerator(ControlGenerator generator) {
-				auxControlGenerators_.push_back(generator);
-			}
+			addAuxControlGenerator(ControlGenerator generator);
 
 			void
 			forceNewOutput() {
-				synthContext_.forceNewOutput = true;
+				requestNewOutput();
 			}
 
 			void
@@ -88,29 +183,75 @@ namespace NAudio {
 			removeControlChangeSubscriber(ControlChangeSubscriber* sub);
 		};
 
+		inline void
+		Synth_::applyCommand(const ParameterCommand_& command, unsigned long blockStart) {
+			ControlParameter& param = graph_.current().parameters[command.handle];
+			unsigned int offset = (command.frame > blockStart) ? (unsigned int)(command.frame - blockStart) : 0u;
+
+			if(command.normalized) {
+				param.setNormalizedValue(command.value, offset);
+			}
+			else {
+				param.value(command.value, offset);
+			}
+		}
+
 		inline void
 		Synth_::computeSynthesisBlock(const SynthesisContext_& context) {
-			outputGen_.tick(outputFrames_, context);
+			SynthGraph_& graph = graph_.current();
+
+			//With a compiled graph, every node is computed in schedule order first. run() only fills the nodes' caches: the root ticks below still copy out the output,
+			//but each node they reach already has its block, so they return it without recursing into the graph.
+			//Without a schedule yet, this block is run recursively and recorded.
+			SynthesisContext_ recordingContext;
+			const SynthesisContext_* graphContext = &context;
+			bool recording = false;
+
+			if(compileGraph_) {
+				if(schedule_.isValid()) {
+					//A forced block recomputes every node on each tick anyway, so running the schedule would only add work.
+					if(!context.forceNewOutput) {
+						schedule_.run(context);
+					}
+				}
+				else if(!schedule_.hasOverflowed()) {
+					recordingContext = context;
+					recordingContext.recorder = &schedule_;
+					graphContext = &recordingContext;
+
+					schedule_.beginRecording();
+					recording = true;
+				}
+			}
+
+			graph.outputGen.tick(outputFrames_, *graphContext);
+
+			for(std::vector<ControlGenerator>::iterator it = graph.auxControlGenerators.begin(); it != graph.auxControlGenerators.end(); ++it) {
+				it->tick(*graphContext);
+			}
 
-			for(std::vector<ControlGenerator>::iterator it = auxControlGenerators_.begin(); it != auxControlGenerators_.end(); ++it) {
-				it->tick(context);
+			if(recording) {
+				schedule_.endRecording();
 			}
 
+			bool silent = graph.outputGen.isSilent();
+
+			//The limiter is skipped too once its lookahead has run out on silent input.
 			if(limitOutput_) {
-				limiter_.tickThrough(outputFrames_, context);
+				silent = limiter_.tickThrough(outputFrames_, context, silent);
 			}
+
+			outputIsSilent_ = silent;
 		}
 	}
 
 	//Smart Pointer.
 	class Synth : public TemplatedBufferFiller<NAudio_DSP::Synth_> {
 	public:
-		//Set the output gen that produces audio for the Synth.
+		//Set the output gen that produces audio for the Synth. Does not block the audio thread, the new graph is swapped in at the next block.
 		void
 		setOutputGen(Generator generator) {
-			gen()->lockMutex();
 			gen()->setOutputGen(generator);
-			gen()->unlockMutex();
 		}
 
 		//Returns a reference to outputGen.
@@ -125,6 +266,13 @@ namespace NAudio {
 			gen()->setLimitOutput(shouldLimit);
 		}
 
+		//Run the graph from a flat, precompiled node order instead of recursive ticks. The order is recorded again whenever the graph is swapped. Defaults to false.
+		//Nodes that are only ticked conditionally by their parent are computed every block once compiled.
+		void
+		setCompileGraph(bool compile) {
+			gen()->setCompileGraph(compile);
+		}
+
 		//Add a ControlParameter with name "name".
 		ControlParameter
 		addParameter(std::string name, float initialValue = 0.0f) {
@@ -154,9 +302,7 @@ namespace NAudio {
 		//Add a ControlGenerator to a list of objects which will be ticked regardless of whether they're part of the synthesis graph or not.
 		void
 		addAuxControlGenerator(ControlGenerator generator) {
-			gen()->lockMutex();
 			gen()->addAuxControlGenerator(generator);
-			gen()->unlockMutex();
 		}
 
 		//Add an object which will be notified when a particular ControlChangeNotifier changes value or is triggered.
@@ -185,11 +331,32 @@ namespace NAudio {
 		}
 
 		//Set the value of a control parameter on this synth. If normalized is true, value will be mapped to defined range of parameter.
+		//The change is queued and applied by the audio thread at the start of the next block.
 		void
 		setParameter(std::string name, float value = 1.0f, bool normalized = false) {
 			gen()->setParameter(name, value, normalized);
 		}
 
+		//Return the handle of a parameter, or kInvalidParameterHandle if there is no parameter with that name. Look handles up once, not per change.
+		ParameterHandle
+		getParameterHandle(std::string name) {
+			return(gen()->getParameterHandle(name));
+		}
+
+		//Lock-free version of setParameter for control threads. The change is applied sampleOffset frames after the start of the next block.
+		//Generators that support sub-block events (ADSR, RampedValue, FixedValue) apply it at that exact frame, others at the start of the block it falls in.
+		//Only one thread may push changes to a synth at a time. Returns false if the queue is full and the change was dropped.
+		bool
+		setParameter(ParameterHandle handle, float value, bool normalized = false, unsigned int sampleOffset = 0) {
+			return(gen()->setParameter(handle, value, normalized, sampleOffset));
+		}
+
+		//Set several parameters at once. Either all changes are queued, and applied in the same block, or none are. Returns false if the queue is full.
+		bool
+		setParameters(const ParameterHandle* handles, const float* values, unsigned int count, bool normalized = false, unsigned int sampleOffset = 0) {
+			return(gen()->setParameters(handles, values, count, normalized, sampleOffset));
+		}
+
 		//Get all of the control parameters registered for this synth.
 		std::vector<ControlParameter>
 		getParameters() {
@@ -198,9 +365,7 @@ namespace NAudio {
 
 		void
 		forceNewOutput() {
-			gen()->lockMutex();
 			gen()->forceNewOutput();
-			gen()->unlockMutex();
 		}
 	};
 
@@ -1,4 +1,7 @@
 #include "TableLookupOsc.h"
+#include "FFT.h"
+
+#include <vector>
 
 namespace NAudio {
 	namespace NAudio_DSP {
@@ -7,8 +10,68 @@ namespace NAudio {
 			return(s_oscillatorTables);
 		}
 
+		unsigned int
+		mipmapLevelCount(unsigned int tableSize) {
+			unsigned int levels = 0;
+
+			while((tableSize >> (levels + 1)) > 0) {
+				++levels;
+			}
+
+			return(levels);
+		}
+
+		SampleTable
+		generateMipmappedTable(HarmonicAmplitudeFunc amplitude, unsigned int tableSize) {
+			int nearestPo2;
+
+			if(tableSize < 2 || !IsPowerOf2((int)tableSize, &nearestPo2)) {
+				LOG(NLOG_WARN, "Mipmapped table size must be a power of two, using %u.", kMipmapTableSize);
+				tableSize = kMipmapTableSize;
+			}
+
+			const unsigned int levels = mipmapLevelCount(tableSize);
+
+			SampleTable table = SampleTable(levels * (tableSize + 1), 1u);
+			float* data = table.dataPointer();
+
+			FFT fft(tableSize);
+
+			std::vector<float> re(tableSize / 2 + 1);
+			std::vector<float> im(tableSize / 2 + 1);
+
+			for(unsigned int level = 0; level < levels; ++level) {
+				const unsigned int nHarmonics = tableSize >> (level + 1);
+
+				std::fill(re.begin(), re.end(), 0.0f);
+				std::fill(im.begin(), im.end(), 0.0f);
+
+				//A sine of amplitude a is a bin of -a * tableSize / 2 on the imaginary axis.
+				for(unsigned int h = 1; h <= nHarmonics && h < tableSize / 2; ++h) {
+					im[h] = -0.5f * (float)tableSize * amplitude(h);
+				}
+
+				fft.inverseReal(&re[0], &im[0], data);
+
+				data[tableSize] = data[0];
+				data += tableSize + 1;
+			}
+
+			return(table);
+		}
+
+		SampleTable
+		mipmappedOscillatorTable(const std::string& name, HarmonicAmplitudeFunc amplitude) {
+			//Generated once and kept for the lifetime of the program, like the sine table.
+			if(!s_oscillatorTables()->ContainsObjectNamed(name)) {
+				s_oscillatorTables()->InsertObject(name, generateMipmappedTable(amplitude));
+			}
+
+			return(s_oscillatorTables()->ObjectNamed(name));
+		}
+
 		TableLookupOsc_::TableLookupOsc_() :
-			phase_(0.0)
+			mipmapLevels_(1), phase_(0.0)
 		{
 			modFrames_.Resize(kSynthesisBlockSize, 1u);
 			lookupTable_ = SampleTable(kSynthesisBlockSize, 1u);
@@ -37,6 +100,28 @@ namespace NAudio {
 			}
 
 			lookupTable_ = table;
+			mipmapLevels_ = 1;
+		}
+
+		void
+		TableLookupOsc_::setMipmappedTable(SampleTable table) {
+			if(table.channels() != 1u) {
+				LOG(NLOG_ERROR, "TableLookupOsc expects lookup table with 1 channel only.");
+				return;
+			}
+
+			//Find the level size the table was generated with.
+			for(unsigned int tableSize = 2; tableSize <= (unsigned int)table.frames(); tableSize <<= 1) {
+				const unsigned int levels = mipmapLevelCount(tableSize);
+
+				if(levels * (tableSize + 1) == table.frames()) {
+					lookupTable_ = table;
+					mipmapLevels_ = levels;
+					return;
+				}
+			}
+
+			LOG(NLOG_ERROR, "TableLookupOsc mipmapped tables must come from generateMipmappedTable.");
 		}
 	}
 
@@ -45,4 +130,10 @@ namespace NAudio {
 		gen()->setLookupTable(lookupTable);
 		return(*this);
 	}
+
+	TableLookupOsc&
+	TableLookupOsc::setMipmappedTable(SampleTable mipmappedTable) {
+		gen()->setMipmappedTable(mipmappedTable);
+		return(*this);
+	}
 }
\ No newline at end of file
@@ -4,16 +4,67 @@
 #include "SampleTable.h"
 
 namespace NAudio {
+	//Size of each level of a mipmapped oscillator table. Every level has the same size, so all levels share one phase.
+	static const unsigned int kMipmapTableSize = 2048;
+
+	//Sine-series amplitude of a waveform's harmonic (1 is the fundamental).
+	typedef float (*HarmonicAmplitudeFunc)(unsigned int harmonic);
+
 	namespace NAudio_DSP {
 		//Registry for all static oscillator lookup table data.
 		NDictionary<SampleTable>* s_oscillatorTables();
 
+		//Number of levels in a mipmapped table of tableSize samples per level. The last level is a pure sine.
+		unsigned int
+		mipmapLevelCount(unsigned int tableSize);
+
+		//Build a mipmapped table, one band-limited level per octave, from the amplitudes of a waveform's harmonics.
+		//Level k holds the harmonics up to tableSize / 2^(k+1), so it doesn't alias as long as the oscillator reads less than 2^k table samples per output sample.
+		//Levels are stored one after the other, each with tableSize + 1 samples (the last sample wraps around).
+		SampleTable
+		generateMipmappedTable(HarmonicAmplitudeFunc amplitude, unsigned int tableSize = kMipmapTableSize);
+
+		//Mipmapped table registered under name in s_oscillatorTables(), generated the first time it is asked for.
+		SampleTable
+		mipmappedOscillatorTable(const std::string& name, HarmonicAmplitudeFunc amplitude);
+
+		//Lower mipmap level to read at rate table samples per output sample, and how much of the level above to blend in.
+		//The blend runs linearly across the octave, so the level never switches abruptly while the frequency moves.
+		inline void
+		mipmapLevelForRate(float rate, unsigned int nLevels, unsigned int& lower, float& blend) {
+			//log2 of the rate from its float bits. The mantissa is linear within the octave, which is the blend we want.
+			union {
+				float f;
+				unsigned int i;
+			} bits;
+
+			bits.f = fabsf(rate);
+
+			int level = (int)((bits.i >> 23) & 0xFF) - 127 + 1;
+
+			if(level < 0) {
+				lower = 0;
+				blend = 0.0f;
+			}
+			else if(level >= (int)nLevels - 1) {
+				lower = nLevels - 1;
+				blend = 0.0f;
+			}
+			else {
+				lower = (unsigned int)level;
+				blend = (float)(bits.i & 0x7FFFFF) * (1.0f / 8388608.0f);
+			}
+		}
+
 		//Many of the original STK methods are not applicable in our use case (direct phase/freq manipulation) and have been removed for optimization.
 		//In the future, phase inputs may be added...
 		class TableLookupOsc_ : public Generator_ {
 		protected:
 			SampleTable lookupTable_;
 
+			//Number of levels in lookupTable_. 1 for a plain table.
+			unsigned int mipmapLevels_;
+
 			double phase_;
 
 			Generator frequencyGenerator_;
@@ -38,28 +89,27 @@ namespace NAudio {
 			//Set sample table for lookup. Note: must be power of 2 in length.
 			void
 			setLookupTable(SampleTable table);
+
+			//Set a table built by generateMipmappedTable. The level read is chosen from the frequency, so the output is band-limited at any pitch.
+			void
+			setMipmappedTable(SampleTable table);
 		};
 
 		inline void
 		TableLookupOsc_::computeSynthesisBlock(const SynthesisContext_& context) {
-			//Update the frequency data.
-			frequencyGenerator_.tick(modFrames_, context);
-
-			unsigned long tableSize = (unsigned long)(lookupTable_.size() - 1);
-			const float rateConstant = (float)tableSize / NAudio::SampleRate();
+			//Mipmapped tables hold mipmapLevels_ tables of the same size back to back.
+			unsigned long tableSize = (unsigned long)(lookupTable_.size() / mipmapLevels_ - 1);
+			const float rateConstant = (float)tableSize / context.sampleRate;
 
 			float* samples = &outputFrames_[0];
-			float* rateBuffer = &modFrames_[0];
 			float* tableData = lookupTable_.dataPointer();
 
 			FastPhasor sd;
 
-			//Pre-multiply rate constant for speed.
-			for(unsigned int i = 0; i < kSynthesisBlockSize; ++i) {
-				*rateBuffer++ *= rateConstant;
-			}
-
-			rateBuffer = &modFrames_[0];
+			//Pre-multiply rate constant for speed. A fixed frequency is a single rate read with a stride of 0.
+			float constantRate;
+			unsigned int rateStride;
+			const float* rateBuffer = frequencyGenerator_.tickScaledSamples(modFrames_, rateConstant, constantRate, context, rateStride);
 
 			sd.d = BIT32DECPT;
 
@@ -73,17 +123,58 @@ namespace NAudio {
 			float f1;
 			float f2;
 
-			for(unsigned int i = 0; i < kSynthesisBlockSize; ++i) {
-				sd.d = ps;
-				ps += *rateBuffer++;
-				offs = sd.i[1] & (tableSize - 1);
-				tAddr = tableData + offs;
-				sd.i[1] = msbi;
-				frac = sd.d - BIT32DECPT;
-				f1 = tAddr[0];
-				f2 = tAddr[1];
-
-				*samples++ = f1 + (float)frac * (f2 - f1);
+			if(mipmapLevels_ > 1) {
+				//Both levels are read at the same offset, only the level has to be picked per sample. A fixed frequency picks it once.
+				const unsigned long levelStride = tableSize + 1;
+
+				unsigned int level;
+				float blend;
+
+				mipmapLevelForRate(*rateBuffer, mipmapLevels_, level, blend);
+
+				float* lowerData = tableData + level * levelStride;
+				float* upperData = (level + 1 < mipmapLevels_) ? lowerData + levelStride : lowerData;
+
+				float* uAddr;
+				float lower;
+				float upper;
+
+				for(unsigned int i = 0; i < outputFrames_.Frames(); ++i) {
+					if(rateStride != 0) {
+						mipmapLevelForRate(*rateBuffer, mipmapLevels_, level, blend);
+						lowerData = tableData + level * levelStride;
+						upperData = (level + 1 < mipmapLevels_) ? lowerData + levelStride : lowerData;
+					}
+
+					sd.d = ps;
+					ps += *rateBuffer;
+					rateBuffer += rateStride;
+					offs = sd.i[1] & (tableSize - 1);
+					tAddr = lowerData + offs;
+					uAddr = upperData + offs;
+					sd.i[1] = msbi;
+					frac = sd.d - BIT32DECPT;
+
+					lower = tAddr[0] + (float)frac * (tAddr[1] - tAddr[0]);
+					upper = uAddr[0] + (float)frac * (uAddr[1] - uAddr[0]);
+
+					*samples++ = lower + blend * (upper - lower);
+				}
+			}
+			else {
+				for(unsigned int i = 0; i < outputFrames_.Frames(); ++i) {
+					sd.d = ps;
+					ps += *rateBuffer;
+					rateBuffer += rateStride;
+					offs = sd.i[1] & (tableSize - 1);
+					tAddr = tableData + offs;
+					sd.i[1] = msbi;
+					frac = sd.d - BIT32DECPT;
+					f1 = tAddr[0];
+					f2 = tAddr[1];
+
+					*samples++ = f1 + (float)frac * (f2 - f1);
+				}
 			}
 
 			sd.d = BIT32DECPT * tableSize;
@@ -99,6 +190,10 @@ namespace NAudio {
 		TableLookupOsc&
 		setLookupTable(SampleTable lookupTable);
 
+		//Set a table built by NAudio_DSP::generateMipmappedTable.
+		TableLookupOsc&
+		setMipmappedTable(SampleTable mipmappedTable);
+
 		NAUDIO_MAKE_GEN_SETTERS(TableLookupOsc, freq, setFrequency);
 	};
 }
\ No newline at end of file
@@ -0,0 +1,156 @@
+#include "WorkerPool.h"
+
+#if defined(__linux__)
+	#include <pthread.h>
+	#include <sched.h>
+#endif
+
+namespace NAudio {
+	namespace NAudio_DSP {
+		//Idle workers spin this many times before sleeping, so back-to-back blocks don't pay for a wake-up.
+		static const unsigned int kWorkerSpinCount = 20000;
+
+		//Bind a thread to one core. Not supported on every platform, in which case the thread is left unpinned.
+		static void
+		pinThreadToCore(std::thread& thread, unsigned int core) {
+#if defined(__linux__)
+			cpu_set_t set;
+			CPU_ZERO(&set);
+			CPU_SET(core, &set);
+
+			if(pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set_t), &set) != 0) {
+				LOG(NLOG_WARN, "Could not pin worker thread to core %u.", core);
+			}
+#elif defined(_WIN32)
+			if(SetThreadAffinityMask((HANDLE)thread.native_handle(), (DWORD_PTR)1 << core) == 0) {
+				LOG(NLOG_WARN, "Could not pin worker thread to core %u.", core);
+			}
+#endif
+		}
+
+		WorkerPool::WorkerPool(unsigned int numWorkers, bool pinThreads) :
+			task_(NULL), userData_(NULL), numTasks_(0), tasksDone_(0), generation_(0), open_(false), joined_(0), stop_(false)
+		{
+			if(numWorkers > kMaxWorkers) {
+				LOG(NLOG_WARN, "WorkerPool is limited to %u workers.", kMaxWorkers);
+				numWorkers = kMaxWorkers;
+			}
+
+			numParticipants_ = numWorkers + 1;
+
+			for(unsigned int p = 0; p < numParticipants_; ++p) {
+				ranges_[p].next.store(0);
+				ranges_[p].end = 0;
+			}
+
+			unsigned int numCores = Max(1u, std::thread::hardware_concurrency());
+
+			//Participant 0 is the thread calling run().
+			for(unsigned int w = 0; w < numWorkers; ++w) {
+				workers_.push_back(std::thread(&WorkerPool::workerLoop, this, w + 1));
+
+				if(pinThreads && numCores > 1) {
+					pinThreadToCore(workers_.back(), 1 + (w % (numCores - 1)));
+				}
+			}
+		}
+
+		WorkerPool::~WorkerPool() {
+			stop_.store(true);
+			generation_.fetch_add(1);
+
+			{
+				std::lock_guard<std::mutex> lock(sleepMutex_);
+				wakeCondition_.notify_all();
+			}
+
+			for(size_t w = 0; w < workers_.size(); ++w) {
+				workers_[w].join();
+			}
+		}
+
+		void
+		WorkerPool::run(size_t numTasks, Task task, void* userData) {
+			if(numTasks == 0) {
+				return;
+			}
+
+			task_ = task;
+			userData_ = userData;
+			numTasks_ = numTasks;
+			tasksDone_.store(0);
+
+			for(unsigned int p = 0; p < numParticipants_; ++p) {
+				ranges_[p].next.store(numTasks * p / numParticipants_, std::memory_order_relaxed);
+				ranges_[p].end = numTasks * (p + 1) / numParticipants_;
+			}
+
+			//Publish the block. The seq_cst store orders all the writes above before it.
+			open_.store(true);
+			generation_.fetch_add(1);
+
+			//notify without the lock, the audio thread must not block on it. A worker that misses it wakes up on its own timeout.
+			wakeCondition_.notify_all();
+
+			drain(0);
+
+			//Barrier. Wait for tasks stolen by workers, then close the block and wait for every worker to leave it.
+			while(tasksDone_.load() < numTasks) {
+				std::this_thread::yield();
+			}
+
+			open_.store(false);
+
+			while(joined_.load() != 0) {
+				std::this_thread::yield();
+			}
+		}
+
+		void
+		WorkerPool::drain(unsigned int participant) {
+			for(unsigned int i = 0; i < numParticipants_; ++i) {
+				Range_& range = ranges_[(participant + i) % numParticipants_];
+
+				for(size_t t = range.next.fetch_add(1); t < range.end; t = range.next.fetch_add(1)) {
+					task_(t, userData_);
+					tasksDone_.fetch_add(1);
+				}
+			}
+		}
+
+		void
+		WorkerPool::workerLoop(unsigned int participant) {
+			unsigned long seenGeneration = 0;
+
+			while(true) {
+				//Wait for a new block, spinning first and then sleeping.
+				unsigned int spins = 0;
+
+				while(generation_.load() == seenGeneration) {
+					if(++spins < kWorkerSpinCount) {
+						std::this_thread::yield();
+					}
+					else {
+						std::unique_lock<std::mutex> lock(sleepMutex_);
+						wakeCondition_.wait_for(lock, std::chrono::milliseconds(1));
+					}
+				}
+
+				seenGeneration = generation_.load();
+
+				if(stop_.load()) {
+					return;
+				}
+
+				//Only work if the block is still open, otherwise run() may already be setting up the next one.
+				joined_.fetch_add(1);
+
+				if(open_.load()) {
+					drain(participant);
+				}
+
+				joined_.fetch_sub(1);
+			}
+		}
+	}
+}
\ No newline at end of file
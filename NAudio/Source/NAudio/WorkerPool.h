@@ -0,0 +1,78 @@
+#pragma once
+
+#include "NAudioCore.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace NAudio {
+	namespace NAudio_DSP {
+		//Pool of worker threads for running the independent tasks of one audio block in parallel.
+		//Each call to run() is one block: the tasks are split evenly between the workers and the calling thread, idle participants steal tasks from the others,
+		//and run() returns once every task is done and every worker has left the block (a per-block barrier). The audio thread never locks or allocates in run().
+		//NOTE: ONLY ONE THREAD MAY CALL run() AT A TIME.
+		class WorkerPool {
+		public:
+			typedef void (*Task)(size_t index, void* userData);
+
+			//Upper bound on workers, so per-participant state can live in a fixed array.
+			static const unsigned int kMaxWorkers = 63;
+
+			//Pinned workers are bound to cores 1, 2, ... (wrapping around), leaving core 0 to the thread calling run().
+			WorkerPool(unsigned int numWorkers, bool pinThreads = true);
+			~WorkerPool();
+
+			unsigned int
+			numWorkers() {
+				return((unsigned int)workers_.size());
+			}
+
+			//Run task(i, userData) for every i in [0, numTasks). Blocks until all tasks are done.
+			void
+			run(size_t numTasks, Task task, void* userData);
+
+		private:
+			//Range of task indices owned by one participant. Padded to a cache line so participants don't share lines.
+			struct Range_ {
+				std::atomic<size_t> next;
+				size_t end;
+				char padding[64 - sizeof(std::atomic<size_t>) - sizeof(size_t)];
+			};
+
+			std::vector<std::thread> workers_;
+
+			Range_ ranges_[kMaxWorkers + 1];
+			unsigned int numParticipants_;
+
+			Task task_;
+			void* userData_;
+			size_t numTasks_;
+
+			std::atomic<size_t> tasksDone_;
+
+			//Bumped once per block. Workers wait for it to change.
+			std::atomic<unsigned long> generation_;
+
+			//True while workers may join the current block. Cleared before the barrier waits for joined_ to reach 0.
+			std::atomic<bool> open_;
+			std::atomic<unsigned int> joined_;
+
+			std::atomic<bool> stop_;
+
+			std::mutex sleepMutex_;
+			std::condition_variable wakeCondition_;
+
+			WorkerPool(const WorkerPool&);
+			WorkerPool& operator=(const WorkerPool&);
+
+			void
+			workerLoop(unsigned int participant);
+
+			//Run tasks from own range first, then steal from the others. Returns when every range is empty.
+			void
+			drain(unsigned int participant);
+		};
+	}
+}
\ No newline at end of file